@@ -1,5 +1,6 @@
 #include "drive/dongle.h"
 #include <sigc++/functors/mem_fun.h>
+#include "drive/robot.h"
 
 Drive::Dongle::~Dongle() = default;
 
@@ -13,6 +14,15 @@ Drive::Dongle::Dongle()
         sigc::mem_fun(this, &Dongle::handle_estop_state_changed));
 }
 
+void Drive::Dongle::send_prims(
+    const std::vector<std::pair<unsigned int, LLPrimitive>> &prims)
+{
+    for (const auto &i : prims)
+    {
+        robot(i.first).send_prim(LLPrimitive(i.second));
+    }
+}
+
 void Drive::Dongle::handle_estop_state_changed()
 {
     estop_broken_message.active(estop_state == EStopState::BROKEN);
@@ -1,6 +1,9 @@
 #ifndef DRIVE_DONGLE_H
 #define DRIVE_DONGLE_H
 
+#include <utility>
+#include <vector>
+#include "drive/primitive.h"
 #include "util/annunciator.h"
 #include "util/noncopyable.h"
 #include "util/property.h"
@@ -55,6 +58,22 @@ class Dongle : public NonCopyable
      */
     virtual Robot &robot(unsigned int i) = 0;
 
+    /**
+     * \brief Sends movement primitives to several robots as one transaction.
+     *
+     * Direct control must be inactive on every robot named in \p prims.
+     *
+     * The default implementation calls Robot::send_prim for each robot in
+     * turn. Subclasses override it to guarantee that the whole batch reaches
+     * the robots together.
+     *
+     * \param[in] prims the robot indices and the primitives to send to them;
+     * the vector is only read, so a caller can reuse it each tick without
+     * reallocating
+     */
+    virtual void send_prims(
+        const std::vector<std::pair<unsigned int, LLPrimitive>> &prims);
+
    protected:
     /**
      * \brief Constructs a new Dongle
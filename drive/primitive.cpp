@@ -1,19 +1,31 @@
 #include "drive/primitive.h"
+#include <algorithm>
 #include "util/dprint.h"
 
 Drive::LLPrimitive::LLPrimitive()
     : prim(static_cast<Drive::Primitive>(-1)),
-      params({-1, -1, -1, -1}),
+      params{{-1, -1, -1, -1}},
       extra(0)
 {
 }
 
 Drive::LLPrimitive::LLPrimitive(
-    Drive::Primitive prim, std::vector<double> p, uint8_t extra)
-    : prim(prim), params(p), extra(extra)
+    Drive::Primitive prim, std::initializer_list<double> p, uint8_t extra)
+    : prim(prim), extra(extra)
 {
     if (p.size() > PARAMS_MAX_SIZE)
-        LOG_WARN(u8"Params vector too large, extra values will be ignored.");
+    {
+        LOG_WARN(u8"Params list too large, extra values will be ignored.");
+    }
+    std::size_t count = std::min<std::size_t>(p.size(), PARAMS_MAX_SIZE);
+    std::copy(p.begin(), p.begin() + count, params.begin());
+    std::fill(params.begin() + count, params.end(), 0.0);
+}
+
+Drive::LLPrimitive::LLPrimitive(
+    Drive::Primitive prim, const Params &p, uint8_t extra)
+    : prim(prim), params(p), extra(extra)
+{
 }
 
 Point Drive::LLPrimitive::field_point() const
@@ -65,7 +77,6 @@ Drive::LLPrimitive Drive::move_dribble(
 
 Drive::LLPrimitive Drive::move_shoot(Point dest, double power, bool chip)
 {
-    printf("shooting ball now");
     return Drive::LLPrimitive(
         Drive::Primitive::SHOOT,
         {dest.x * 1000.0, dest.y * 1000.0, 0.0, power * 1000.0}, chip);
@@ -74,7 +85,6 @@ Drive::LLPrimitive Drive::move_shoot(Point dest, double power, bool chip)
 Drive::LLPrimitive Drive::move_shoot(
     Point dest, Angle orientation, double power, bool chip)
 {
-    printf("power %f", power);
     return Drive::LLPrimitive(
         Drive::Primitive::SHOOT,
         {dest.x * 1000.0, dest.y * 1000.0,
@@ -1,6 +1,7 @@
 #pragma once
 #include <array>
-#include <memory>
+#include <cstdint>
+#include <initializer_list>
 #include "geom/util.h"
 
 namespace Drive
@@ -93,20 +94,50 @@ enum class Primitive
 /**
  * \brief This class represents the movement primitive packet to be sent over
  * radio.
+ *
+ * The parameters are stored inline, so constructing, copying, or moving a
+ * primitive never allocates memory.
  */
 class LLPrimitive
 {
    public:
+    static constexpr uint8_t PARAMS_MAX_SIZE = 4;
+
+    /**
+     * \brief The type of the parameter storage.
+     */
+    typedef std::array<double, PARAMS_MAX_SIZE> Params;
+
     LLPrimitive();
-    LLPrimitive(Primitive prim, std::vector<double> p, uint8_t extra);
 
-    static constexpr uint8_t PARAMS_MAX_SIZE = 4;
+    /**
+     * \brief Constructs a primitive.
+     *
+     * \param[in] prim the primitive code
+     *
+     * \param[in] p the parameters; if fewer than \ref PARAMS_MAX_SIZE are
+     * given, the rest are zero, and if more are given, the extras are ignored
+     *
+     * \param[in] extra the extra field
+     */
+    LLPrimitive(Primitive prim, std::initializer_list<double> p, uint8_t extra);
+
+    /**
+     * \brief Constructs a primitive.
+     *
+     * \param[in] prim the primitive code
+     *
+     * \param[in] p the parameters
+     *
+     * \param[in] extra the extra field
+     */
+    LLPrimitive(Primitive prim, const Params &p, uint8_t extra);
 
     Point field_point() const;
     Angle field_angle() const;
 
     Primitive prim;
-    std::vector<double> params;
+    Params params;
     uint8_t extra;
 };
 /**
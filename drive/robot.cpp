@@ -46,6 +46,26 @@ Drive::Robot::Robot(
         sigc::mem_fun(this, &Robot::handle_battery_voltage_changed));
     board_temperature.signal_changed().connect(
         sigc::mem_fun(this, &Robot::handle_board_temperature_changed));
+
+    feedback.add(alive);
+    feedback.add(ball_in_beam);
+    feedback.add(capacitor_charged);
+    feedback.add(battery_voltage);
+    feedback.add(capacitor_voltage);
+    feedback.add(break_beam_reading);
+    feedback.add(dribbler_temperature);
+    feedback.add(dribbler_speed);
+    feedback.add(board_temperature);
+    for (const Property<double> &i : lps_values)
+    {
+        feedback.add(i);
+    }
+    feedback.add(link_quality);
+    feedback.add(received_signal_strength);
+    feedback.add(build_ids_valid);
+    feedback.add(fw_build_id);
+    feedback.add(fpga_build_id);
+    feedback.add(primitive);
 }
 
 void Drive::Robot::handle_alive_changed()
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <functional>
 #include "drive/primitive.h"
+#include "drive/telemetry.h"
 #include "geom/point.h"
 #include "util/annunciator.h"
 #include "util/noncopyable.h"
@@ -173,6 +174,20 @@ class Robot : public NonCopyable
      */
     Property<Primitive> primitive;
 
+    /**
+     * \brief Fires when any of the feedback properties above changes.
+     *
+     * Drivers update feedback within a PropertyTransaction, so this fires
+     * once per received packet rather than once per changed value.
+     */
+    PropertyGroup feedback;
+
+    /**
+     * \brief The recent history of the robot’s feedback, with one record per
+     * status report.
+     */
+    TelemetryHistory telemetry;
+
     /**
      * \brief Emitted when the autokick mechanism causes the robot to
      * kick.
@@ -227,10 +242,10 @@ class Robot : public NonCopyable
     /**
      * \brief Sends a low level primitive to the robot.
      *
-     * \param[p] LLPrimitive to be sent to robot. See drive/primitives.h for
+     * \param[in] p LLPrimitive to be sent to robot. See drive/primitive.h for
      * factory functions that return a LLPrimitive.
      */
-    virtual void send_prim(Drive::LLPrimitive p) = 0;
+    virtual void send_prim(Drive::LLPrimitive &&p) = 0;
 
     /**
      * \brief Sets whether the robot is limited to moving slowly.
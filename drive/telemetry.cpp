@@ -0,0 +1,117 @@
+#include "drive/telemetry.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+constexpr std::size_t Drive::TelemetryHistory::FIELD_COUNT;
+constexpr std::size_t Drive::TelemetryHistory::CAPACITY;
+
+const char *Drive::TelemetryHistory::field_name(Field field)
+{
+    switch (field)
+    {
+        case Field::BATTERY_VOLTAGE:
+            return u8"Battery voltage";
+        case Field::CAPACITOR_VOLTAGE:
+            return u8"Capacitor voltage";
+        case Field::BREAK_BEAM_READING:
+            return u8"Break beam reading";
+        case Field::BOARD_TEMPERATURE:
+            return u8"Board temperature";
+        case Field::DRIBBLER_TEMPERATURE:
+            return u8"Dribbler temperature";
+        case Field::DRIBBLER_SPEED:
+            return u8"Dribbler speed";
+        case Field::LINK_QUALITY:
+            return u8"Link quality";
+        case Field::RECEIVED_SIGNAL_STRENGTH:
+            return u8"Received signal strength";
+        case Field::LPS_0:
+            return u8"LPS 0";
+        case Field::LPS_1:
+            return u8"LPS 1";
+        case Field::LPS_2:
+            return u8"LPS 2";
+        case Field::LPS_3:
+            return u8"LPS 3";
+    }
+    assert(false);
+    return nullptr;
+}
+
+Drive::TelemetryHistory::Values Drive::TelemetryHistory::empty_values()
+{
+    Values v;
+    v.fill(std::numeric_limits<float>::quiet_NaN());
+    return v;
+}
+
+Drive::TelemetryHistory::TelemetryHistory() : head(0), size_(0)
+{
+}
+
+void Drive::TelemetryHistory::append(Clock::time_point stamp, const Values &v)
+{
+    stamps[head] = stamp;
+    for (std::size_t i = 0; i != FIELD_COUNT; ++i)
+    {
+        values[i][head] = v[i];
+    }
+    head = (head + 1) & (CAPACITY - 1);
+    if (size_ != CAPACITY)
+    {
+        ++size_;
+    }
+}
+
+void Drive::TelemetryHistory::clear()
+{
+    head  = 0;
+    size_ = 0;
+}
+
+Drive::TelemetryHistory::Aggregate Drive::TelemetryHistory::aggregate(
+    Field field, Clock::duration window, Clock::time_point now) const
+{
+    Aggregate agg;
+    agg.count = 0;
+    agg.min = agg.max = agg.mean = agg.last =
+        std::numeric_limits<double>::quiet_NaN();
+
+    // Walk backwards from the newest record; records are in time order, so
+    // the first one outside the window ends the scan.
+    const std::array<float, CAPACITY> &column =
+        values[static_cast<std::size_t>(field)];
+    Clock::time_point start = now - window;
+    double sum              = 0.0;
+    for (std::size_t i = size_; i--;)
+    {
+        std::size_t p = physical(i);
+        if (stamps[p] < start)
+        {
+            break;
+        }
+        double v = column[p];
+        if (std::isnan(v))
+        {
+            continue;
+        }
+        if (!agg.count)
+        {
+            agg.min = agg.max = agg.last = v;
+        }
+        else
+        {
+            agg.min = std::min(agg.min, v);
+            agg.max = std::max(agg.max, v);
+        }
+        sum += v;
+        ++agg.count;
+    }
+    if (agg.count)
+    {
+        agg.mean = sum / static_cast<double>(agg.count);
+    }
+    return agg;
+}
@@ -0,0 +1,199 @@
+#ifndef DRIVE_TELEMETRY_H
+#define DRIVE_TELEMETRY_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include "util/noncopyable.h"
+
+namespace Drive
+{
+/**
+ * \brief A fixed-size history of a robot’s recent feedback.
+ *
+ * Each received status report is stored as one record: a timestamp plus one
+ * value per field. Storage is a ring of parallel arrays, one per field, so
+ * appending is constant time, never allocates, and a query over one field
+ * only touches that field’s array. Once full, each new record overwrites the
+ * oldest one.
+ *
+ * Fields a report did not carry are stored as NaN and skipped by queries.
+ */
+class TelemetryHistory final : public NonCopyable
+{
+   public:
+    /**
+     * \brief The clock used to timestamp records.
+     */
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * \brief The recorded fields.
+     */
+    enum class Field
+    {
+        BATTERY_VOLTAGE,
+        CAPACITOR_VOLTAGE,
+        BREAK_BEAM_READING,
+        BOARD_TEMPERATURE,
+        DRIBBLER_TEMPERATURE,
+        DRIBBLER_SPEED,
+        LINK_QUALITY,
+        RECEIVED_SIGNAL_STRENGTH,
+        LPS_0,
+        LPS_1,
+        LPS_2,
+        LPS_3,
+    };
+
+    /**
+     * \brief The number of fields in a record.
+     */
+    static constexpr std::size_t FIELD_COUNT =
+        static_cast<std::size_t>(Field::LPS_3) + 1;
+
+    /**
+     * \brief The number of records kept.
+     */
+    static constexpr std::size_t CAPACITY = 1024;
+
+    /**
+     * \brief The values of one record, indexed by Field.
+     */
+    typedef std::array<float, FIELD_COUNT> Values;
+
+    /**
+     * \brief A summary of one field over a window of time.
+     */
+    struct Aggregate final
+    {
+        /**
+         * \brief The number of records in the window carrying the field.
+         */
+        std::size_t count;
+
+        /**
+         * \brief The smallest value, or NaN if \ref count is zero.
+         */
+        double min;
+
+        /**
+         * \brief The largest value, or NaN if \ref count is zero.
+         */
+        double max;
+
+        /**
+         * \brief The mean value, or NaN if \ref count is zero.
+         */
+        double mean;
+
+        /**
+         * \brief The most recent value, or NaN if \ref count is zero.
+         */
+        double last;
+    };
+
+    /**
+     * \brief Returns a human-readable name for a field.
+     *
+     * \param[in] field the field
+     *
+     * \return the name
+     */
+    static const char *field_name(Field field);
+
+    /**
+     * \brief Returns a record with every field absent.
+     *
+     * \return a record whose values are all NaN
+     */
+    static Values empty_values();
+
+    /**
+     * \brief Constructs an empty history.
+     */
+    explicit TelemetryHistory();
+
+    /**
+     * \brief Appends a record.
+     *
+     * \param[in] stamp the time at which the values were received, which
+     * should not be earlier than that of the previous record
+     *
+     * \param[in] values the values, with NaN for any that are absent
+     */
+    void append(Clock::time_point stamp, const Values &values);
+
+    /**
+     * \brief Discards all records.
+     */
+    void clear();
+
+    /**
+     * \brief Returns the number of records held.
+     *
+     * \return the record count, at most \ref CAPACITY
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * \brief Returns the timestamp of a record.
+     *
+     * \param[in] i the record index, with zero being the oldest record held
+     *
+     * \return the timestamp
+     */
+    Clock::time_point stamp(std::size_t i) const
+    {
+        return stamps[physical(i)];
+    }
+
+    /**
+     * \brief Returns one field of a record.
+     *
+     * \param[in] field the field
+     *
+     * \param[in] i the record index, with zero being the oldest record held
+     *
+     * \return the value, or NaN if the record did not carry the field
+     */
+    float value(Field field, std::size_t i) const
+    {
+        return values[static_cast<std::size_t>(field)][physical(i)];
+    }
+
+    /**
+     * \brief Summarizes one field over the most recent records.
+     *
+     * \param[in] field the field
+     *
+     * \param[in] window how far back from \p now to look
+     *
+     * \param[in] now the end of the window
+     *
+     * \return the summary of the records stamped no earlier than
+     * <var>now</var> − <var>window</var>
+     */
+    Aggregate aggregate(
+        Field field, Clock::duration window,
+        Clock::time_point now = Clock::now()) const;
+
+   private:
+    static_assert(
+        (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+    std::array<Clock::time_point, CAPACITY> stamps;
+    std::array<std::array<float, CAPACITY>, FIELD_COUNT> values;
+    std::size_t head, size_;
+
+    std::size_t physical(std::size_t i) const
+    {
+        return (head - size_ + i) & (CAPACITY - 1);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include "drive/telemetry_publisher.h"
+#include <glibmm/ustring.h>
+#include <sigc++/bind.h>
+#include <sigc++/functors/mem_fun.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "drive/dongle.h"
+#include "drive/robot.h"
+#include "util/codec.h"
+#include "util/dprint.h"
+#include "util/exception.h"
+#include "util/sockaddrs.h"
+
+constexpr uint8_t Drive::TelemetryPublisher::REQUEST_SUBSCRIBE;
+constexpr uint8_t Drive::TelemetryPublisher::REQUEST_UNSUBSCRIBE;
+constexpr uint8_t Drive::TelemetryPublisher::FRAME_ROBOT_STATUS;
+constexpr std::size_t Drive::TelemetryPublisher::FRAME_LENGTH;
+constexpr std::size_t Drive::TelemetryPublisher::MAX_SUBSCRIBERS;
+constexpr unsigned int Drive::TelemetryPublisher::MAX_CONSECUTIVE_DROPS;
+constexpr std::chrono::seconds Drive::TelemetryPublisher::SUBSCRIPTION_TIMEOUT;
+
+namespace
+{
+bool same_address(
+    const sockaddr_storage &a, socklen_t a_len, const sockaddr_storage &b,
+    socklen_t b_len)
+{
+    return a_len == b_len && !std::memcmp(&a, &b, a_len);
+}
+
+uint8_t estop_bits(Drive::Dongle::EStopState state)
+{
+    switch (state)
+    {
+        case Drive::Dongle::EStopState::BROKEN:
+            return 0;
+        case Drive::Dongle::EStopState::STOP:
+            return 1;
+        case Drive::Dongle::EStopState::RUN:
+            return 2;
+    }
+    return 0;
+}
+}
+
+Drive::TelemetryPublisher::TelemetryPublisher(
+    Dongle &dongle, unsigned int num_robots, const std::string &address)
+    : dongle(dongle),
+      num_robots(num_robots),
+      sock(create_local_datagram_socket(address, unlink_path)),
+      sequence(0),
+      frames_sent_(0),
+      frames_dropped_(0),
+      evictions_(0)
+{
+    io_connection = Glib::signal_io().connect(
+        sigc::mem_fun(this, &TelemetryPublisher::handle_request), sock.fd(),
+        Glib::IO_IN);
+    for (unsigned int i = 0; i != num_robots; ++i)
+    {
+        connections.push_back(dongle.robot(i).feedback.signal_changed().connect(
+            sigc::bind(
+                sigc::mem_fun(this, &TelemetryPublisher::publish_robot), i)));
+    }
+    connections.push_back(dongle.estop_state.signal_changed().connect(
+        sigc::mem_fun(this, &TelemetryPublisher::publish_all)));
+}
+
+Drive::TelemetryPublisher::~TelemetryPublisher()
+{
+    io_connection.disconnect();
+    for (sigc::connection &i : connections)
+    {
+        i.disconnect();
+    }
+    if (!unlink_path.empty())
+    {
+        unlink(unlink_path.c_str());
+    }
+}
+
+bool Drive::TelemetryPublisher::handle_request(Glib::IOCondition)
+{
+    for (;;)
+    {
+        uint8_t request[16];
+        sockaddr_storage from;
+        socklen_t from_len = sizeof(from);
+        ssize_t rc         = recvfrom(
+            sock.fd(), request, sizeof(request), 0,
+            reinterpret_cast<sockaddr *>(&from), &from_len);
+        if (rc < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            throw SystemError("recvfrom", errno);
+        }
+        if (!rc || from_len <= sizeof(sa_family_t))
+        {
+            // An unbound sender has no address to publish to.
+            continue;
+        }
+
+        auto existing = std::find_if(
+            subscribers.begin(), subscribers.end(),
+            [&from, from_len](const Subscriber &s) {
+                return same_address(
+                    s.address, s.address_length, from, from_len);
+            });
+        if (request[0] == REQUEST_SUBSCRIBE)
+        {
+            std::chrono::steady_clock::time_point expiry =
+                std::chrono::steady_clock::now() + SUBSCRIPTION_TIMEOUT;
+            if (existing != subscribers.end())
+            {
+                existing->expiry = expiry;
+            }
+            else if (subscribers.size() < MAX_SUBSCRIBERS)
+            {
+                Subscriber s;
+                s.address           = from;
+                s.address_length    = from_len;
+                s.expiry            = expiry;
+                s.consecutive_drops = 0;
+                subscribers.push_back(s);
+                LOG_INFO(Glib::ustring::compose(
+                    u8"Telemetry subscriber added (%1 total)",
+                    subscribers.size()));
+            }
+            else
+            {
+                LOG_WARN(u8"Telemetry subscriber rejected: too many");
+            }
+        }
+        else if (request[0] == REQUEST_UNSUBSCRIBE)
+        {
+            if (existing != subscribers.end())
+            {
+                subscribers.erase(existing);
+            }
+        }
+    }
+}
+
+void Drive::TelemetryPublisher::publish_robot(unsigned int index)
+{
+    if (subscribers.empty())
+    {
+        return;
+    }
+
+    uint8_t frame[FRAME_LENGTH];
+    encode(index, frame);
+
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    for (auto i = subscribers.begin(); i != subscribers.end();)
+    {
+        bool evict = false;
+        if (i->expiry < now)
+        {
+            evict = true;
+        }
+        else if (
+            sendto(
+                sock.fd(), frame, sizeof(frame), MSG_DONTWAIT | MSG_NOSIGNAL,
+                reinterpret_cast<const sockaddr *>(&i->address),
+                i->address_length) >= 0)
+        {
+            ++frames_sent_;
+            i->consecutive_drops = 0;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        {
+            // The subscriber is not keeping up; drop only its copy.
+            ++frames_dropped_;
+            evict = ++i->consecutive_drops >= MAX_CONSECUTIVE_DROPS;
+        }
+        else
+        {
+            // The subscriber’s socket has gone away.
+            evict = true;
+        }
+
+        if (evict)
+        {
+            ++evictions_;
+            i = subscribers.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void Drive::TelemetryPublisher::publish_all()
+{
+    for (unsigned int i = 0; i != num_robots; ++i)
+    {
+        publish_robot(i);
+    }
+}
+
+void Drive::TelemetryPublisher::encode(
+    unsigned int index, uint8_t (&frame)[FRAME_LENGTH])
+{
+    const Robot &bot = dongle.robot(index);
+    uint8_t flags    = 0;
+    if (bot.alive)
+    {
+        flags |= 0x01;
+    }
+    if (bot.ball_in_beam)
+    {
+        flags |= 0x02;
+    }
+    if (bot.capacitor_charged)
+    {
+        flags |= 0x04;
+    }
+    if (bot.build_ids_valid)
+    {
+        flags |= 0x08;
+    }
+    if (bot.direct_control)
+    {
+        flags |= 0x10;
+    }
+    flags = static_cast<uint8_t>(flags | estop_bits(dongle.estop_state) << 5);
+    std::chrono::microseconds stamp =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+
+    frame[0] = FRAME_ROBOT_STATUS;
+    frame[1] = static_cast<uint8_t>(index);
+    frame[2] = flags;
+    frame[3] = static_cast<uint8_t>(bot.primitive.get());
+    encode_u32_le(&frame[4], sequence++);
+    encode_u64_le(&frame[8], static_cast<uint64_t>(stamp.count()));
+    encode_float_le(&frame[16], static_cast<float>(bot.battery_voltage));
+    encode_float_le(&frame[20], static_cast<float>(bot.capacitor_voltage));
+    encode_float_le(&frame[24], static_cast<float>(bot.break_beam_reading));
+    encode_float_le(&frame[28], static_cast<float>(bot.board_temperature));
+    encode_float_le(&frame[32], static_cast<float>(bot.dribbler_temperature));
+    encode_float_le(&frame[36], static_cast<float>(bot.link_quality));
+    for (std::size_t i = 0; i != bot.lps_values.size(); ++i)
+    {
+        encode_float_le(
+            &frame[40 + i * 4], static_cast<float>(bot.lps_values[i]));
+    }
+    encode_u32_le(&frame[56], static_cast<uint32_t>(bot.dribbler_speed.get()));
+    encode_u32_le(
+        &frame[60], static_cast<uint32_t>(bot.received_signal_strength.get()));
+    encode_u32_le(&frame[64], bot.fw_build_id);
+    encode_u32_le(&frame[68], bot.fpga_build_id);
+}
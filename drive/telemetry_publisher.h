@@ -0,0 +1,190 @@
+#ifndef DRIVE_TELEMETRY_PUBLISHER_H
+#define DRIVE_TELEMETRY_PUBLISHER_H
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+#include <sigc++/trackable.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "util/fd.h"
+#include "util/noncopyable.h"
+
+namespace Drive
+{
+class Dongle;
+
+/**
+ * \brief Streams robot feedback to external processes over a local datagram
+ * socket.
+ *
+ * The publisher binds a datagram socket and waits for subscribers. A process
+ * subscribes by sending a datagram whose first byte is \ref
+ * REQUEST_SUBSCRIBE from a socket bound to an address of its own, and
+ * unsubscribes by sending \ref REQUEST_UNSUBSCRIBE. A subscription lapses if
+ * it is not renewed within \ref SUBSCRIPTION_TIMEOUT.
+ *
+ * Each time a robot’s feedback changes, one frame is sent to every
+ * subscriber. Frames are \ref FRAME_LENGTH bytes, little-endian:
+ *
+ * <table>
+ * <tr><th>Offset</th><th>Type</th><th>Content</th></tr>
+ * <tr><td>0</td><td>u8</td><td>\ref FRAME_ROBOT_STATUS</td></tr>
+ * <tr><td>1</td><td>u8</td><td>robot index</td></tr>
+ * <tr><td>2</td><td>u8</td><td>bit 0 alive, bit 1 ball in beam, bit 2
+ * capacitor charged, bit 3 build IDs valid, bit 4 direct control, bits 5–6
+ * emergency stop state (0 broken, 1 stop, 2 run)</td></tr>
+ * <tr><td>3</td><td>u8</td><td>current primitive</td></tr>
+ * <tr><td>4</td><td>u32</td><td>frame sequence number</td></tr>
+ * <tr><td>8</td><td>u64</td><td>monotonic timestamp, in
+ * microseconds</td></tr>
+ * <tr><td>16</td><td>f32</td><td>battery voltage, in volts</td></tr>
+ * <tr><td>20</td><td>f32</td><td>capacitor voltage, in volts</td></tr>
+ * <tr><td>24</td><td>f32</td><td>break beam reading</td></tr>
+ * <tr><td>28</td><td>f32</td><td>board temperature, in °C</td></tr>
+ * <tr><td>32</td><td>f32</td><td>dribbler temperature, in °C</td></tr>
+ * <tr><td>36</td><td>f32</td><td>link quality, 0 to 1</td></tr>
+ * <tr><td>40</td><td>4 × f32</td><td>LPS values</td></tr>
+ * <tr><td>56</td><td>i32</td><td>dribbler speed, in RPM</td></tr>
+ * <tr><td>60</td><td>i32</td><td>received signal strength, in dB</td></tr>
+ * <tr><td>64</td><td>u32</td><td>firmware build ID</td></tr>
+ * <tr><td>68</td><td>u32</td><td>FPGA build ID</td></tr>
+ * </table>
+ *
+ * Sends never block. If a subscriber’s socket buffer is full, the frame is
+ * dropped for that subscriber only; a subscriber that drops \ref
+ * MAX_CONSECUTIVE_DROPS frames in a row, or whose socket has gone away, is
+ * evicted. While there are no subscribers, feedback changes cost one branch
+ * and nothing is encoded.
+ */
+class TelemetryPublisher final : public NonCopyable, public sigc::trackable
+{
+   public:
+    /**
+     * \brief The request byte a subscriber sends to subscribe or renew.
+     */
+    static constexpr uint8_t REQUEST_SUBSCRIBE = 0x00;
+
+    /**
+     * \brief The request byte a subscriber sends to unsubscribe.
+     */
+    static constexpr uint8_t REQUEST_UNSUBSCRIBE = 0x01;
+
+    /**
+     * \brief The type byte of a robot status frame.
+     */
+    static constexpr uint8_t FRAME_ROBOT_STATUS = 0x01;
+
+    /**
+     * \brief The length of a robot status frame.
+     */
+    static constexpr std::size_t FRAME_LENGTH = 72;
+
+    /**
+     * \brief The most subscribers accepted at once.
+     */
+    static constexpr std::size_t MAX_SUBSCRIBERS = 16;
+
+    /**
+     * \brief The number of frames in a row a subscriber may miss before it is
+     * evicted.
+     */
+    static constexpr unsigned int MAX_CONSECUTIVE_DROPS = 256;
+
+    /**
+     * \brief How long a subscription lasts without being renewed.
+     */
+    static constexpr std::chrono::seconds SUBSCRIPTION_TIMEOUT{10};
+
+    /**
+     * \brief Starts publishing.
+     *
+     * \param[in] dongle the dongle whose robots should be published
+     *
+     * \param[in] num_robots the number of robots on the dongle
+     *
+     * \param[in] address where to listen for subscribers: a filesystem path
+     * for a Unix-domain socket, a name prefixed with “@” for an abstract
+     * Unix-domain socket, or a port number for a UDP socket on the loopback
+     * interface
+     */
+    explicit TelemetryPublisher(
+        Dongle &dongle, unsigned int num_robots, const std::string &address);
+
+    /**
+     * \brief Stops publishing and removes the socket file, if any.
+     */
+    ~TelemetryPublisher();
+
+    /**
+     * \brief Returns the number of current subscribers.
+     *
+     * \return the subscriber count
+     */
+    std::size_t subscriber_count() const
+    {
+        return subscribers.size();
+    }
+
+    /**
+     * \brief Returns the number of frames delivered to a subscriber’s socket.
+     *
+     * \return the number of frames sent
+     */
+    uint64_t frames_sent() const
+    {
+        return frames_sent_;
+    }
+
+    /**
+     * \brief Returns the number of frames dropped because a subscriber was
+     * not keeping up.
+     *
+     * \return the number of frames dropped
+     */
+    uint64_t frames_dropped() const
+    {
+        return frames_dropped_;
+    }
+
+    /**
+     * \brief Returns the number of subscribers evicted for falling behind or
+     * disappearing.
+     *
+     * \return the eviction count
+     */
+    uint64_t evictions() const
+    {
+        return evictions_;
+    }
+
+   private:
+    struct Subscriber final
+    {
+        sockaddr_storage address;
+        socklen_t address_length;
+        std::chrono::steady_clock::time_point expiry;
+        unsigned int consecutive_drops;
+    };
+
+    Dongle &dongle;
+    const unsigned int num_robots;
+    std::string unlink_path;
+    FileDescriptor sock;
+    std::vector<Subscriber> subscribers;
+    std::vector<sigc::connection> connections;
+    sigc::connection io_connection;
+    uint32_t sequence;
+    uint64_t frames_sent_, frames_dropped_, evictions_;
+
+    bool handle_request(Glib::IOCondition);
+    void publish_robot(unsigned int index);
+    void publish_all();
+    void encode(unsigned int index, uint8_t (&frame)[FRAME_LENGTH]);
+};
+}
+
+#endif
@@ -3,40 +3,50 @@
 
 #include <cmath>
 #include <ostream>
+#include "geom/fast_trig.h"
 
 /**
  * \brief A typesafe representation of an angle.
  *
  * This class helps prevent accidentally combining values in degrees and radians
  * without proper conversion.
+ *
+ * \tparam T the floating-point type holding the value; code that stores many
+ * angles can use \c float where the precision allows.
  */
-class Angle final
+template <typename T>
+class BasicAngle final
 {
    public:
+    /**
+     * \brief The type of the value.
+     */
+    typedef T Scalar;
+
     /**
      * \brief The zero angle.
      */
-    static constexpr Angle zero();
+    static constexpr BasicAngle zero();
 
     /**
      * \brief The quarter-turn angle (90°).
      */
-    static constexpr Angle quarter();
+    static constexpr BasicAngle quarter();
 
     /**
      * \brief The half-turn angle (180°).
      */
-    static constexpr Angle half();
+    static constexpr BasicAngle half();
 
     /**
      * \brief The three-quarter turn angle (270°).
      */
-    static constexpr Angle three_quarter();
+    static constexpr BasicAngle three_quarter();
 
     /**
      * \brief The full-turn angle (360°).
      */
-    static constexpr Angle full();
+    static constexpr BasicAngle full();
 
     /**
      * \brief Constructs an angle from a value in radians.
@@ -45,7 +55,7 @@ class Angle final
      *
      * \return the angle.
      */
-    static constexpr Angle of_radians(double t);
+    static constexpr BasicAngle of_radians(T t);
 
     /**
      * \brief Constructs an angle from a value in degrees.
@@ -54,7 +64,7 @@ class Angle final
      *
      * \return the angle.
      */
-    static constexpr Angle of_degrees(double t);
+    static constexpr BasicAngle of_degrees(T t);
 
     /**
      * \brief Computes the arc sine of a value.
@@ -63,7 +73,32 @@ class Angle final
      *
      * \return the angle.
      */
-    static Angle asin(double x);
+    static BasicAngle asin(T x);
+
+    /**
+     * \brief Computes the arc sine of a value with a polynomial approximation.
+     *
+     * This is faster than asin(T) and, for doubles, within 2e-8 radians of it.
+     *
+     * \param[in] x the value.
+     *
+     * \return the angle.
+     */
+    static BasicAngle fast_asin(T x);
+
+    /**
+     * \brief Computes the angle of a vector with a polynomial approximation.
+     *
+     * This is faster than <code>std::atan2</code> and, for doubles, within
+     * 3e-8 radians of it.
+     *
+     * \param[in] y the <var>y</var> component of the vector.
+     *
+     * \param[in] x the <var>x</var> component of the vector.
+     *
+     * \return the angle, in the range [-π, π].
+     */
+    static BasicAngle fast_atan2(T y, T x);
 
     /**
      * \brief Computes the arc cosine of a value.
@@ -72,7 +107,7 @@ class Angle final
      *
      * \return the angle.
      */
-    static Angle acos(double x);
+    static BasicAngle acos(T x);
 
     /**
      * \brief Computes the arc tangent of a value.
@@ -81,26 +116,34 @@ class Angle final
      *
      * \return the angle.
      */
-    static Angle atan(double x);
+    static BasicAngle atan(T x);
 
     /**
      * \brief Constructs the "zero" angle.
      */
-    explicit constexpr Angle();
+    explicit constexpr BasicAngle();
+
+    /**
+     * \brief Converts an angle from another precision.
+     *
+     * \param[in] other the angle to convert.
+     */
+    template <typename U>
+    explicit constexpr BasicAngle(BasicAngle<U> other);
 
     /**
      * \brief Converts this angle to a value in radians.
      *
      * \return the number of radians in this angle.
      */
-    constexpr double to_radians() const;
+    constexpr T to_radians() const;
 
     /**
      * \brief Converts this angle to a value in degrees.
      *
      * \return the number of degrees in this angle.
      */
-    constexpr double to_degrees() const;
+    constexpr T to_degrees() const;
 
     /**
      * \brief Computes the modulus of a division between this angle and another
@@ -110,7 +153,7 @@ class Angle final
      *
      * \return the modulus of \c *this ÷ \p divisor.
      */
-    constexpr Angle mod(Angle divisor) const;
+    constexpr BasicAngle mod(BasicAngle divisor) const;
 
     /**
      * \brief Computes the remainder of a division between this angle and
@@ -120,13 +163,13 @@ class Angle final
      *
      * \return the remainder of \c *this ÷ \p divisor.
      */
-    constexpr Angle remainder(Angle divisor) const;
+    constexpr BasicAngle remainder(BasicAngle divisor) const;
 
     /**
      *
      * \return the absolute value of this angle.
      */
-    constexpr Angle abs() const;
+    constexpr BasicAngle abs() const;
 
     /**
      * \brief Checks whether the angle is finite.
@@ -140,21 +183,42 @@ class Angle final
      *
      * \return the sine of this angle.
      */
-    double sin() const;
+    T sin() const;
 
     /**
      * \brief Computes the cosine of this angle.
      *
      * \return the cosine of this angle.
      */
-    double cos() const;
+    T cos() const;
+
+    /**
+     * \brief Computes the sine of this angle with a polynomial approximation.
+     *
+     * This is faster than sin() and, for doubles, within 2e-11 of it for
+     * angles up to ±10<sup>8</sup> radians.
+     *
+     * \return the sine of this angle.
+     */
+    T fast_sin() const;
+
+    /**
+     * \brief Computes the cosine of this angle with a polynomial
+     * approximation.
+     *
+     * This is faster than cos() and, for doubles, within 2e-11 of it for
+     * angles up to ±10<sup>8</sup> radians.
+     *
+     * \return the cosine of this angle.
+     */
+    T fast_cos() const;
 
     /**
      * \brief Computes the tangent of this angle.
      *
      * \return teh tangent of this angle.
      */
-    double tan() const;
+    T tan() const;
 
     /**
      * \brief Limits this angle to [−π, π].
@@ -164,7 +228,7 @@ class Angle final
      *
      * \return the clamped angle.
      */
-    constexpr Angle angle_mod() const;
+    constexpr BasicAngle angle_mod() const;
 
     /**
      * Returns the smallest possible rotational difference between this angle
@@ -174,14 +238,19 @@ class Angle final
      *
      * \return the angle between \c *this and \p other, in the range [0, π].
      */
-    constexpr Angle angle_diff(Angle other) const;
+    constexpr BasicAngle angle_diff(BasicAngle other) const;
 
    private:
-    double rads;
+    T rads;
 
-    explicit constexpr Angle(double rads);
+    explicit constexpr BasicAngle(T rads);
 };
 
+/**
+ * \brief The angle type used throughout, in double precision.
+ */
+typedef BasicAngle<double> Angle;
+
 /**
  * \brief Negates an angle.
  *
@@ -189,7 +258,8 @@ class Angle final
  *
  * \return −\p angle.
  */
-constexpr Angle operator-(Angle angle);
+template <typename T>
+constexpr BasicAngle<T> operator-(BasicAngle<T> angle);
 
 /**
  * \brief Adds two angles.
@@ -200,7 +270,8 @@ constexpr Angle operator-(Angle angle);
  *
  * \return the sum \p x + \p y.
  */
-constexpr Angle operator+(Angle x, Angle y);
+template <typename T>
+constexpr BasicAngle<T> operator+(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Subtracts two angles.
@@ -211,7 +282,8 @@ constexpr Angle operator+(Angle x, Angle y);
  *
  * \return the difference \p x − \p y.
  */
-constexpr Angle operator-(Angle x, Angle y);
+template <typename T>
+constexpr BasicAngle<T> operator-(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Multiplies an angle by a scalar factor.
@@ -222,7 +294,9 @@ constexpr Angle operator-(Angle x, Angle y);
  *
  * \return the product \p angle × \p scale.
  */
-constexpr Angle operator*(Angle angle, double scale);
+template <typename T>
+constexpr BasicAngle<T> operator*(
+    BasicAngle<T> angle, typename BasicAngle<T>::Scalar scale);
 
 /**
  * \brief Multiplies an angle by a scalar factor.
@@ -233,7 +307,9 @@ constexpr Angle operator*(Angle angle, double scale);
  *
  * \return the product \p scale × \p angle.
  */
-constexpr Angle operator*(double scale, Angle angle);
+template <typename T>
+constexpr BasicAngle<T> operator*(
+    typename BasicAngle<T>::Scalar scale, BasicAngle<T> angle);
 
 /**
  * \brief Divides an angle by a scalar divisor.
@@ -244,7 +320,9 @@ constexpr Angle operator*(double scale, Angle angle);
  *
  * \return the quotient \p angle ÷ \p divisor.
  */
-constexpr Angle operator/(Angle angle, double divisor);
+template <typename T>
+constexpr BasicAngle<T> operator/(
+    BasicAngle<T> angle, typename BasicAngle<T>::Scalar divisor);
 
 /**
  * \brief Divides two angles.
@@ -255,7 +333,8 @@ constexpr Angle operator/(Angle angle, double divisor);
  *
  * \return the quotient \p x ÷ \p y.
  */
-constexpr double operator/(Angle x, Angle y);
+template <typename T>
+constexpr T operator/(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Adds an angle to an angle.
@@ -266,7 +345,8 @@ constexpr double operator/(Angle x, Angle y);
  *
  * \return \p x.
  */
-Angle &operator+=(Angle &x, Angle y);
+template <typename T>
+BasicAngle<T> &operator+=(BasicAngle<T> &x, BasicAngle<T> y);
 
 /**
  * \brief Subtracts an angle from an angle.
@@ -277,7 +357,8 @@ Angle &operator+=(Angle &x, Angle y);
  *
  * \return \p x.
  */
-Angle &operator-=(Angle &x, Angle y);
+template <typename T>
+BasicAngle<T> &operator-=(BasicAngle<T> &x, BasicAngle<T> y);
 
 /**
  * \brief Scales an angle by a factor.
@@ -288,7 +369,9 @@ Angle &operator-=(Angle &x, Angle y);
  *
  * \return \p angle.
  */
-Angle &operator*=(Angle &angle, double scale);
+template <typename T>
+BasicAngle<T> &operator*=(
+    BasicAngle<T> &angle, typename BasicAngle<T>::Scalar scale);
 
 /**
  * \brief Divides an angle by a scalar divisor.
@@ -299,7 +382,9 @@ Angle &operator*=(Angle &angle, double scale);
  *
  * \return \p angle.
  */
-Angle &operator/=(Angle &angle, double divisor);
+template <typename T>
+BasicAngle<T> &operator/=(
+    BasicAngle<T> &angle, typename BasicAngle<T>::Scalar divisor);
 
 /**
  * \brief Compares two angles.
@@ -310,7 +395,8 @@ Angle &operator/=(Angle &angle, double divisor);
  *
  * \return \c true if \p x < \p y, or \c false if not.
  */
-constexpr bool operator<(Angle x, Angle y);
+template <typename T>
+constexpr bool operator<(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Compares two angles.
@@ -321,7 +407,8 @@ constexpr bool operator<(Angle x, Angle y);
  *
  * \return \c true if \p x > \p y, or \c false if not.
  */
-constexpr bool operator>(Angle x, Angle y);
+template <typename T>
+constexpr bool operator>(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Compares two angles.
@@ -332,7 +419,8 @@ constexpr bool operator>(Angle x, Angle y);
  *
  * \return \c true if \p x ≤ \p y, or \c false if not.
  */
-constexpr bool operator<=(Angle x, Angle y);
+template <typename T>
+constexpr bool operator<=(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Compares two angles.
@@ -343,7 +431,8 @@ constexpr bool operator<=(Angle x, Angle y);
  *
  * \return \c true if \p x ≥ \p y, or \c false if not.
  */
-constexpr bool operator>=(Angle x, Angle y);
+template <typename T>
+constexpr bool operator>=(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Compares two angles.
@@ -354,7 +443,8 @@ constexpr bool operator>=(Angle x, Angle y);
  *
  * \return \c true if \p x = \p y, or \c false if not.
  */
-constexpr bool operator==(Angle x, Angle y);
+template <typename T>
+constexpr bool operator==(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Compares two angles.
@@ -365,7 +455,8 @@ constexpr bool operator==(Angle x, Angle y);
  *
  * \return \c true if \p x ≠ \p y, or \c false if not.
  */
-constexpr bool operator!=(Angle x, Angle y);
+template <typename T>
+constexpr bool operator!=(BasicAngle<T> x, BasicAngle<T> y);
 
 /**
  * \brief Converts an angle to a string representation.
@@ -376,221 +467,301 @@ constexpr bool operator!=(Angle x, Angle y);
  *
  * \return \p s.
  */
-template <typename CharT, typename Traits>
+template <typename T, typename CharT, typename Traits>
 std::basic_ostream<CharT, Traits> &operator<<(
-    std::basic_ostream<CharT, Traits> &s, Angle a);
+    std::basic_ostream<CharT, Traits> &s, BasicAngle<T> a);
+
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::zero()
+{
+    return BasicAngle<T>();
+}
+
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::quarter()
+{
+    return BasicAngle<T>(static_cast<T>(M_PI / 2.0));
+}
+
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::half()
+{
+    return BasicAngle<T>(static_cast<T>(M_PI));
+}
 
-inline constexpr Angle Angle::zero()
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::three_quarter()
 {
-    return Angle();
+    return BasicAngle<T>(static_cast<T>(3.0 / 2.0 * M_PI));
 }
 
-inline constexpr Angle Angle::quarter()
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::full()
 {
-    return Angle(M_PI / 2.0);
+    return BasicAngle<T>(static_cast<T>(2.0 * M_PI));
 }
 
-inline constexpr Angle Angle::half()
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::of_radians(T t)
 {
-    return Angle(M_PI);
+    return BasicAngle<T>(t);
 }
 
-inline constexpr Angle Angle::three_quarter()
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::of_degrees(T t)
 {
-    return Angle(3.0 / 2.0 * M_PI);
+    return BasicAngle<T>(t / static_cast<T>(180.0) * static_cast<T>(M_PI));
 }
 
-inline constexpr Angle Angle::full()
+template <typename T>
+inline BasicAngle<T> BasicAngle<T>::asin(T x)
 {
-    return Angle(2.0 * M_PI);
+    return BasicAngle<T>::of_radians(std::asin(x));
 }
 
-inline constexpr Angle Angle::of_radians(double t)
+template <typename T>
+inline BasicAngle<T> BasicAngle<T>::fast_asin(T x)
 {
-    return Angle(t);
+    return BasicAngle<T>::of_radians(FastTrig::asin<FastTrig::ScalarOps<T>>(x));
 }
 
-inline constexpr Angle Angle::of_degrees(double t)
+template <typename T>
+inline BasicAngle<T> BasicAngle<T>::fast_atan2(T y, T x)
 {
-    return Angle(t / 180.0 * M_PI);
+    return BasicAngle<T>::of_radians(
+        FastTrig::atan2<FastTrig::ScalarOps<T>>(y, x));
 }
 
-inline Angle Angle::asin(double x)
+template <typename T>
+inline BasicAngle<T> BasicAngle<T>::acos(T x)
 {
-    return Angle::of_radians(std::asin(x));
+    return BasicAngle<T>::of_radians(std::acos(x));
 }
 
-inline Angle Angle::acos(double x)
+template <typename T>
+inline BasicAngle<T> BasicAngle<T>::atan(T x)
 {
-    return Angle::of_radians(std::acos(x));
+    return BasicAngle<T>::of_radians(std::atan(x));
 }
 
-inline Angle Angle::atan(double x)
+template <typename T>
+inline constexpr BasicAngle<T>::BasicAngle() : rads(0)
 {
-    return Angle::of_radians(std::atan(x));
 }
 
-inline constexpr Angle::Angle() : rads(0.0)
+template <typename T>
+template <typename U>
+inline constexpr BasicAngle<T>::BasicAngle(BasicAngle<U> other)
+    : rads(static_cast<T>(other.to_radians()))
 {
 }
 
-inline constexpr double Angle::to_radians() const
+template <typename T>
+inline constexpr T BasicAngle<T>::to_radians() const
 {
     return rads;
 }
 
-inline constexpr double Angle::to_degrees() const
+template <typename T>
+inline constexpr T BasicAngle<T>::to_degrees() const
 {
-    return rads / M_PI * 180.0;
+    return rads / static_cast<T>(M_PI) * static_cast<T>(180.0);
 }
 
-inline constexpr Angle Angle::mod(Angle divisor) const
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::mod(BasicAngle<T> divisor) const
 {
-    return Angle::of_radians(
+    return BasicAngle<T>::of_radians(
         to_radians() -
-        static_cast<double>(
+        static_cast<T>(
             static_cast<long>(to_radians() / divisor.to_radians())) *
             divisor.to_radians());
 }
 
-inline constexpr Angle Angle::remainder(Angle divisor) const
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::remainder(
+    BasicAngle<T> divisor) const
 {
-    return Angle::of_radians(
+    return BasicAngle<T>::of_radians(
         to_radians() -
-        static_cast<double>(static_cast<long>(
+        static_cast<T>(static_cast<long>(
             (to_radians() / divisor.to_radians()) >= 0
                 ? (to_radians() / divisor.to_radians() + 0.5)
                 : (to_radians() / divisor.to_radians() - 0.5))) *
             divisor.to_radians());
 }
 
-inline constexpr Angle Angle::abs() const
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::abs() const
 {
-    return Angle::of_radians(to_radians() < 0 ? -to_radians() : to_radians());
+    return BasicAngle<T>::of_radians(
+        to_radians() < 0 ? -to_radians() : to_radians());
 }
 
-inline bool Angle::isfinite() const
+template <typename T>
+inline bool BasicAngle<T>::isfinite() const
 {
     return std::isfinite(to_radians());
 }
 
-inline double Angle::sin() const
+template <typename T>
+inline T BasicAngle<T>::sin() const
 {
     return std::sin(to_radians());
 }
 
-inline double Angle::cos() const
+template <typename T>
+inline T BasicAngle<T>::cos() const
 {
     return std::cos(to_radians());
 }
 
-inline double Angle::tan() const
+template <typename T>
+inline T BasicAngle<T>::fast_sin() const
+{
+    return FastTrig::sin<FastTrig::ScalarOps<T>>(to_radians());
+}
+
+template <typename T>
+inline T BasicAngle<T>::fast_cos() const
+{
+    return FastTrig::cos<FastTrig::ScalarOps<T>>(to_radians());
+}
+
+template <typename T>
+inline T BasicAngle<T>::tan() const
 {
     return std::tan(to_radians());
 }
 
-inline constexpr Angle Angle::angle_mod() const
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::angle_mod() const
 {
-    return remainder(Angle::full());
+    return remainder(BasicAngle<T>::full());
 }
 
-inline constexpr Angle Angle::angle_diff(Angle other) const
+template <typename T>
+inline constexpr BasicAngle<T> BasicAngle<T>::angle_diff(
+    BasicAngle<T> other) const
 {
     return (*this - other).angle_mod().abs();
 }
 
-inline constexpr Angle::Angle(double rads) : rads(rads)
+template <typename T>
+inline constexpr BasicAngle<T>::BasicAngle(T rads) : rads(rads)
 {
 }
 
-inline constexpr Angle operator-(Angle angle)
+template <typename T>
+inline constexpr BasicAngle<T> operator-(BasicAngle<T> angle)
 {
-    return Angle::of_radians(-angle.to_radians());
+    return BasicAngle<T>::of_radians(-angle.to_radians());
 }
 
-inline constexpr Angle operator+(Angle x, Angle y)
+template <typename T>
+inline constexpr BasicAngle<T> operator+(BasicAngle<T> x, BasicAngle<T> y)
 {
-    return Angle::of_radians(x.to_radians() + y.to_radians());
+    return BasicAngle<T>::of_radians(x.to_radians() + y.to_radians());
 }
 
-inline constexpr Angle operator-(Angle x, Angle y)
+template <typename T>
+inline constexpr BasicAngle<T> operator-(BasicAngle<T> x, BasicAngle<T> y)
 {
-    return Angle::of_radians(x.to_radians() - y.to_radians());
+    return BasicAngle<T>::of_radians(x.to_radians() - y.to_radians());
 }
 
-inline constexpr Angle operator*(Angle angle, double scale)
+template <typename T>
+inline constexpr BasicAngle<T> operator*(
+    BasicAngle<T> angle, typename BasicAngle<T>::Scalar scale)
 {
-    return Angle::of_radians(angle.to_radians() * scale);
+    return BasicAngle<T>::of_radians(angle.to_radians() * scale);
 }
 
-inline constexpr Angle operator*(double scale, Angle angle)
+template <typename T>
+inline constexpr BasicAngle<T> operator*(
+    typename BasicAngle<T>::Scalar scale, BasicAngle<T> angle)
 {
-    return Angle::of_radians(scale * angle.to_radians());
+    return BasicAngle<T>::of_radians(scale * angle.to_radians());
 }
 
-inline constexpr Angle operator/(Angle angle, double divisor)
+template <typename T>
+inline constexpr BasicAngle<T> operator/(
+    BasicAngle<T> angle, typename BasicAngle<T>::Scalar divisor)
 {
-    return Angle::of_radians(angle.to_radians() / divisor);
+    return BasicAngle<T>::of_radians(angle.to_radians() / divisor);
 }
 
-inline constexpr double operator/(Angle x, Angle y)
+template <typename T>
+inline constexpr T operator/(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() / y.to_radians();
 }
 
-inline Angle &operator+=(Angle &x, Angle y)
+template <typename T>
+inline BasicAngle<T> &operator+=(BasicAngle<T> &x, BasicAngle<T> y)
 {
     return x = x + y;
 }
 
-inline Angle &operator-=(Angle &x, Angle y)
+template <typename T>
+inline BasicAngle<T> &operator-=(BasicAngle<T> &x, BasicAngle<T> y)
 {
     return x = x - y;
 }
 
-inline Angle &operator*=(Angle &angle, double scale)
+template <typename T>
+inline BasicAngle<T> &operator*=(
+    BasicAngle<T> &angle, typename BasicAngle<T>::Scalar scale)
 {
     return angle = angle * scale;
 }
 
-inline Angle &operator/=(Angle &angle, double divisor)
+template <typename T>
+inline BasicAngle<T> &operator/=(
+    BasicAngle<T> &angle, typename BasicAngle<T>::Scalar divisor)
 {
     return angle = angle / divisor;
 }
 
-inline constexpr bool operator<(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator<(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() < y.to_radians();
 }
 
-inline constexpr bool operator>(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator>(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() > y.to_radians();
 }
 
-inline constexpr bool operator<=(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator<=(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() <= y.to_radians();
 }
 
-inline constexpr bool operator>=(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator>=(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() >= y.to_radians();
 }
 
-inline constexpr bool operator==(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator==(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() == y.to_radians();
 }
 
-inline constexpr bool operator!=(Angle x, Angle y)
+template <typename T>
+inline constexpr bool operator!=(BasicAngle<T> x, BasicAngle<T> y)
 {
     return x.to_radians() != y.to_radians();
 }
 
-template <typename CharT, typename Traits>
+template <typename T, typename CharT, typename Traits>
 inline std::basic_ostream<CharT, Traits> &operator<<(
-    std::basic_ostream<CharT, Traits> &s, Angle a)
+    std::basic_ostream<CharT, Traits> &s, BasicAngle<T> a)
 {
     s << a.to_radians() << 'R';
     return s;
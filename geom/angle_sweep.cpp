@@ -0,0 +1,167 @@
+#include "geom/angle_sweep.h"
+#include <algorithm>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+bool starts_before(
+    const std::pair<Angle, Angle> &x, const std::pair<Angle, Angle> &y)
+{
+    return x.first < y.first;
+}
+
+/**
+ * \brief Calls a function with the bounds of each gap between sorted blocked
+ * intervals, in order, over the range from zero to \p extent.
+ */
+template <typename F>
+void for_each_gap(
+    const std::vector<std::pair<Angle, Angle>> &blocked, Angle extent, F f)
+{
+    Angle cursor = Angle::zero();
+    for (const std::pair<Angle, Angle> &i : blocked)
+    {
+        if (cursor < i.first)
+        {
+            f(cursor, i.first);
+        }
+        cursor = std::max(cursor, i.second);
+    }
+    if (cursor < extent)
+    {
+        f(cursor, extent);
+    }
+}
+}
+
+AngleSweep::AngleSweep() : inside(false)
+{
+}
+
+void AngleSweep::set_source(
+    const Point &src, const std::vector<Point> &obstacles, double radius)
+{
+    this->src = src;
+    inside    = false;
+    this->obstacles.clear();
+    this->obstacles.reserve(obstacles.size());
+    for (const Point &i : obstacles)
+    {
+        const Point diff = i - src;
+        const double len = diff.len();
+        if (len < radius)
+        {
+            inside = true;
+            return;
+        }
+        Obstacle o;
+        o.bearing = diff.orientation();
+        o.span    = Angle::asin(radius / len);
+        this->obstacles.push_back(o);
+    }
+}
+
+AngleSweep::Window AngleSweep::best(const Seg &target)
+{
+    Window ret;
+    ret.target = (target.start + target.end) * 0.5;
+    ret.width  = Angle::zero();
+    Angle offset, extent;
+    if (!clip(target, offset, extent))
+    {
+        return ret;
+    }
+    Angle from = Angle::zero(), to = Angle::zero();
+    for_each_gap(blocked, extent, [&](Angle f, Angle t) {
+        if (ret.width < t - f)
+        {
+            ret.width = t - f;
+            from      = f;
+            to        = t;
+        }
+    });
+    if (ret.width > Angle::zero())
+    {
+        ret = make_window(target, offset, from, to);
+    }
+    return ret;
+}
+
+void AngleSweep::best(const std::vector<Seg> &targets, std::vector<Window> &out)
+{
+    out.clear();
+    out.reserve(targets.size());
+    for (const Seg &i : targets)
+    {
+        out.push_back(best(i));
+    }
+}
+
+const std::vector<AngleSweep::Window> &AngleSweep::windows(const Seg &target)
+{
+    windows_.clear();
+    Angle offset, extent;
+    if (clip(target, offset, extent))
+    {
+        for_each_gap(blocked, extent, [&](Angle f, Angle t) {
+            windows_.push_back(make_window(target, offset, f, t));
+        });
+    }
+    return windows_;
+}
+
+double AngleSweep::coverage(const Seg &target)
+{
+    Angle offset, extent;
+    if (!clip(target, offset, extent))
+    {
+        return 1.0;
+    }
+    Angle open = Angle::zero();
+    for_each_gap(blocked, extent, [&](Angle f, Angle t) { open += t - f; });
+    return 1.0 - open / extent;
+}
+
+bool AngleSweep::clip(const Seg &target, Angle &offset, Angle &extent)
+{
+    blocked.clear();
+    if (inside || collinear(src, target.start, target.end))
+    {
+        return false;
+    }
+    offset = (target.start - src).orientation();
+    extent = ((target.end - src).orientation() - offset).angle_mod();
+    if (extent <= Angle::zero())
+    {
+        return false;
+    }
+    for (const Obstacle &i : obstacles)
+    {
+        const Angle cent = (i.bearing - offset).angle_mod();
+        const Angle lo   = cent - i.span, hi = cent + i.span;
+        // An obstacle straddling the direction directly away from the target
+        // cannot block it.
+        if (lo < -Angle::half() || hi > Angle::half() ||
+            hi <= Angle::zero() || lo >= extent)
+        {
+            continue;
+        }
+        blocked.push_back(std::make_pair(
+            std::max(lo, Angle::zero()), std::min(hi, extent)));
+    }
+    std::sort(blocked.begin(), blocked.end(), &starts_before);
+    return true;
+}
+
+AngleSweep::Window AngleSweep::make_window(
+    const Seg &target, Angle offset, Angle from, Angle to) const
+{
+    const Angle mid = from + (to - from) / 2 + offset;
+    const Point ray = Point::of_angle(mid) * 10.0;
+    Window ret;
+    ret.target = line_intersect(src, src + ray, target.start, target.end);
+    ret.width  = to - from;
+    return ret;
+}
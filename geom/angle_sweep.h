@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "geom/angle.h"
+#include "geom/point.h"
+#include "geom/shapes.h"
+
+namespace Geom
+{
+/**
+ * \brief Finds the directions from a source point towards target segments that
+ * are not blocked by circular obstacles.
+ *
+ * The obstacles are set once per source with \ref set_source, which finds the
+ * bearing and angular half-width of each obstacle. Each target query then
+ * only clips those intervals to the target, sorts the few that overlap it and
+ * walks them for gaps, so several targets (both goals, a handful of pass
+ * receivers) can be evaluated from the same source cheaply. Scratch buffers
+ * are kept between calls, so a long-lived instance does not allocate once
+ * they have grown.
+ *
+ * A target is a segment whose \c start is its right-hand edge and whose \c end
+ * is its left-hand edge as seen from the source; that is, \c end lies
+ * counterclockwise of \c start. The angle the target subtends must not exceed
+ * 180 degrees and the source must not lie on the target's line.
+ */
+class AngleSweep final
+{
+   public:
+    /**
+     * \brief An unobstructed range of directions.
+     */
+    struct Window final
+    {
+        /**
+         * \brief Where the ray through the middle of the window meets the
+         * target's line.
+         */
+        Point target;
+
+        /**
+         * \brief The angular width of the window.
+         */
+        Angle width;
+    };
+
+    /**
+     * \brief Constructs an engine with no source and no obstacles.
+     */
+    explicit AngleSweep();
+
+    /**
+     * \brief Sets the source and obstacles for subsequent queries.
+     *
+     * \param[in] src the location from which to look
+     *
+     * \param[in] obstacles the centres of the obstacles
+     *
+     * \param[in] radius the radius of every obstacle
+     */
+    void set_source(
+        const Point &src, const std::vector<Point> &obstacles, double radius);
+
+    /**
+     * \brief Finds the widest unobstructed window onto a target.
+     *
+     * \param[in] target the target
+     *
+     * \return the widest window, with the earliest in counterclockwise order
+     * winning ties, or the middle of the target with zero width if every
+     * direction is blocked, the source is inside an obstacle or the source is
+     * on the target's line
+     */
+    Window best(const Seg &target);
+
+    /**
+     * \brief Finds the widest unobstructed window onto each of several
+     * targets.
+     *
+     * \param[in] targets the targets
+     *
+     * \param[out] out the best window for each target, as from \ref best
+     */
+    void best(const std::vector<Seg> &targets, std::vector<Window> &out);
+
+    /**
+     * \brief Finds every unobstructed window onto a target.
+     *
+     * \param[in] target the target
+     *
+     * \return the windows of nonzero width in counterclockwise order, which
+     * remain valid until the next query
+     */
+    const std::vector<Window> &windows(const Seg &target);
+
+    /**
+     * \brief Finds how much of a target is hidden by obstacles.
+     *
+     * \param[in] target the target
+     *
+     * \return the blocked fraction of the angle the target subtends, from 0
+     * (fully visible) to 1 (fully blocked, or a degenerate query)
+     */
+    double coverage(const Seg &target);
+
+   private:
+    struct Obstacle final
+    {
+        Angle bearing, span;
+    };
+
+    Point src;
+    bool inside;
+    std::vector<Obstacle> obstacles;
+    std::vector<std::pair<Angle, Angle>> blocked;
+    std::vector<Window> windows_;
+
+    bool clip(const Seg &target, Angle &offset, Angle &extent);
+    Window make_window(
+        const Seg &target, Angle offset, Angle from, Angle to) const;
+};
+}
@@ -0,0 +1,509 @@
+#include "geom/batch.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "geom/fast_trig.h"
+#include "geom/util.h"
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace Geom;
+
+namespace
+{
+/**
+ * \brief The quantities of a segment that every point query needs.
+ *
+ * A degenerate segment gets a zero reciprocal length, which clamps every
+ * projection to the start point, so the kernels need no branch for it.
+ */
+struct SegTerms final
+{
+    double sx, sy, ex, ey, dx, dy, inv_lensq;
+
+    explicit SegTerms(const Seg &seg)
+        : sx(seg.start.x),
+          sy(seg.start.y),
+          ex(seg.end.x),
+          ey(seg.end.y),
+          dx(seg.end.x - seg.start.x),
+          dy(seg.end.y - seg.start.y),
+          inv_lensq(is_degenerate(seg) ? 0.0 : 1.0 / lensq(seg))
+    {
+    }
+};
+
+/**
+ * \brief Computes the squared distance from one point to a segment.
+ *
+ * This is the same arithmetic as the vector kernels, used for the elements
+ * left over after the last full vector.
+ */
+double seg_distsq(const SegTerms &s, double x, double y)
+{
+    double px = x - s.sx, py = y - s.sy;
+    double t  = (px * s.dx + py * s.dy) * s.inv_lensq;
+    t         = std::min(std::max(t, 0.0), 1.0);
+    double qx = px - t * s.dx, qy = py - t * s.dy;
+    return qx * qx + qy * qy;
+}
+
+#if defined(__AVX__)
+/**
+ * \brief Four-lane double-precision operations.
+ */
+struct Lanes final
+{
+    typedef __m256d V;
+    typedef double Scalar;
+    static constexpr std::size_t N = 4;
+
+    static V set1(double d)
+    {
+        return _mm256_set1_pd(d);
+    }
+    static V load(const double *p)
+    {
+        return _mm256_loadu_pd(p);
+    }
+    static void store(double *p, V v)
+    {
+        _mm256_storeu_pd(p, v);
+    }
+    static V add(V a, V b)
+    {
+        return _mm256_add_pd(a, b);
+    }
+    static V sub(V a, V b)
+    {
+        return _mm256_sub_pd(a, b);
+    }
+    static V mul(V a, V b)
+    {
+        return _mm256_mul_pd(a, b);
+    }
+    static V div(V a, V b)
+    {
+        return _mm256_div_pd(a, b);
+    }
+    static V min(V a, V b)
+    {
+        return _mm256_min_pd(a, b);
+    }
+    static V max(V a, V b)
+    {
+        return _mm256_max_pd(a, b);
+    }
+    static V sqrt(V a)
+    {
+        return _mm256_sqrt_pd(a);
+    }
+    static V lt(V a, V b)
+    {
+        return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+    }
+    static V le(V a, V b)
+    {
+        return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+    }
+    static V both(V a, V b)
+    {
+        return _mm256_and_pd(a, b);
+    }
+    static V select(V m, V a, V b)
+    {
+        return _mm256_blendv_pd(b, a, m);
+    }
+    static unsigned int mask(V a)
+    {
+        return static_cast<unsigned int>(_mm256_movemask_pd(a));
+    }
+};
+#elif defined(__SSE2__)
+/**
+ * \brief Two-lane double-precision operations.
+ */
+struct Lanes final
+{
+    typedef __m128d V;
+    typedef double Scalar;
+    static constexpr std::size_t N = 2;
+
+    static V set1(double d)
+    {
+        return _mm_set1_pd(d);
+    }
+    static V load(const double *p)
+    {
+        return _mm_loadu_pd(p);
+    }
+    static void store(double *p, V v)
+    {
+        _mm_storeu_pd(p, v);
+    }
+    static V add(V a, V b)
+    {
+        return _mm_add_pd(a, b);
+    }
+    static V sub(V a, V b)
+    {
+        return _mm_sub_pd(a, b);
+    }
+    static V mul(V a, V b)
+    {
+        return _mm_mul_pd(a, b);
+    }
+    static V div(V a, V b)
+    {
+        return _mm_div_pd(a, b);
+    }
+    static V min(V a, V b)
+    {
+        return _mm_min_pd(a, b);
+    }
+    static V max(V a, V b)
+    {
+        return _mm_max_pd(a, b);
+    }
+    static V sqrt(V a)
+    {
+        return _mm_sqrt_pd(a);
+    }
+    static V lt(V a, V b)
+    {
+        return _mm_cmplt_pd(a, b);
+    }
+    static V le(V a, V b)
+    {
+        return _mm_cmple_pd(a, b);
+    }
+    static V both(V a, V b)
+    {
+        return _mm_and_pd(a, b);
+    }
+    static V select(V m, V a, V b)
+    {
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+    static unsigned int mask(V a)
+    {
+        return static_cast<unsigned int>(_mm_movemask_pd(a));
+    }
+};
+#else
+/**
+ * \brief One-lane operations, for targets without SSE2.
+ */
+struct Lanes final
+{
+    typedef double V;
+    typedef double Scalar;
+    static constexpr std::size_t N = 1;
+
+    static V set1(double d)
+    {
+        return d;
+    }
+    static V load(const double *p)
+    {
+        return *p;
+    }
+    static void store(double *p, V v)
+    {
+        *p = v;
+    }
+    static V add(V a, V b)
+    {
+        return a + b;
+    }
+    static V sub(V a, V b)
+    {
+        return a - b;
+    }
+    static V mul(V a, V b)
+    {
+        return a * b;
+    }
+    static V div(V a, V b)
+    {
+        return a / b;
+    }
+    static V min(V a, V b)
+    {
+        return b < a ? b : a;
+    }
+    static V max(V a, V b)
+    {
+        return a < b ? b : a;
+    }
+    static V sqrt(V a)
+    {
+        return std::sqrt(a);
+    }
+    static V lt(V a, V b)
+    {
+        return a < b ? 1.0 : 0.0;
+    }
+    static V le(V a, V b)
+    {
+        return a <= b ? 1.0 : 0.0;
+    }
+    static V both(V a, V b)
+    {
+        return a * b;
+    }
+    static V select(V m, V a, V b)
+    {
+        return m != 0.0 ? a : b;
+    }
+    static unsigned int mask(V a)
+    {
+        return a != 0.0 ? 1U : 0U;
+    }
+};
+#endif
+
+constexpr std::size_t Lanes::N;
+
+/**
+ * \brief Broadcasts the segment terms into vectors.
+ */
+struct SegLanes final
+{
+    Lanes::V sx, sy, dx, dy, inv_lensq;
+
+    explicit SegLanes(const SegTerms &s)
+        : sx(Lanes::set1(s.sx)),
+          sy(Lanes::set1(s.sy)),
+          dx(Lanes::set1(s.dx)),
+          dy(Lanes::set1(s.dy)),
+          inv_lensq(Lanes::set1(s.inv_lensq))
+    {
+    }
+};
+
+Lanes::V seg_distsq(const SegLanes &s, Lanes::V x, Lanes::V y)
+{
+    const Lanes::V zero = Lanes::set1(0.0), one = Lanes::set1(1.0);
+    Lanes::V px = Lanes::sub(x, s.sx), py = Lanes::sub(y, s.sy);
+    Lanes::V t  = Lanes::mul(
+        Lanes::add(Lanes::mul(px, s.dx), Lanes::mul(py, s.dy)), s.inv_lensq);
+    t           = Lanes::min(Lanes::max(t, zero), one);
+    Lanes::V qx = Lanes::sub(px, Lanes::mul(t, s.dx));
+    Lanes::V qy = Lanes::sub(py, Lanes::mul(t, s.dy));
+    return Lanes::add(Lanes::mul(qx, qx), Lanes::mul(qy, qy));
+}
+
+Lanes::V pt_distsq(Lanes::V ax, Lanes::V ay, Lanes::V bx, Lanes::V by)
+{
+    Lanes::V dx = Lanes::sub(ax, bx), dy = Lanes::sub(ay, by);
+    return Lanes::add(Lanes::mul(dx, dx), Lanes::mul(dy, dy));
+}
+
+/**
+ * \brief Writes the lanes of a comparison result as booleans.
+ *
+ * \return the number of lanes set
+ */
+std::size_t store_mask(bool *out, Lanes::V v)
+{
+    unsigned int m    = Lanes::mask(v);
+    std::size_t count = 0;
+    for (std::size_t k = 0; k != Lanes::N; ++k)
+    {
+        out[k] = (m >> k) & 1U;
+        count += out[k];
+    }
+    return count;
+}
+
+void distsq_impl(
+    const Seg &seg, const double *x, const double *y, std::size_t n,
+    double *out, bool root)
+{
+    SegTerms s(seg);
+    SegLanes sl(s);
+    std::size_t i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N)
+    {
+        Lanes::V d = seg_distsq(sl, Lanes::load(x + i), Lanes::load(y + i));
+        Lanes::store(out + i, root ? Lanes::sqrt(d) : d);
+    }
+    for (; i != n; ++i)
+    {
+        double d = seg_distsq(s, x[i], y[i]);
+        out[i]   = root ? std::sqrt(d) : d;
+    }
+}
+
+/*
+ * Wrappers that name the FastTrig kernels as types, so that one loop can run
+ * each of them over vectors and then over the remaining scalars.
+ */
+struct Sin final
+{
+    template <typename Ops>
+    static typename Ops::V apply(typename Ops::V x)
+    {
+        return FastTrig::sin<Ops>(x);
+    }
+};
+
+struct Cos final
+{
+    template <typename Ops>
+    static typename Ops::V apply(typename Ops::V x)
+    {
+        return FastTrig::cos<Ops>(x);
+    }
+};
+
+struct Asin final
+{
+    template <typename Ops>
+    static typename Ops::V apply(typename Ops::V x)
+    {
+        return FastTrig::asin<Ops>(x);
+    }
+};
+
+template <typename Kernel>
+void trig_impl(const double *in, std::size_t n, double *out)
+{
+    std::size_t i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N)
+    {
+        Lanes::store(
+            out + i, Kernel::template apply<Lanes>(Lanes::load(in + i)));
+    }
+    for (; i != n; ++i)
+    {
+        out[i] = Kernel::template apply<FastTrig::ScalarOps<double>>(in[i]);
+    }
+}
+}
+
+void Geom::distsq(
+    const Seg &seg, const double *x, const double *y, std::size_t n,
+    double *out)
+{
+    distsq_impl(seg, x, y, n, out, false);
+}
+
+void Geom::distsq(const Seg &seg, const PointSet &points, double *out)
+{
+    distsq(seg, points.x.data(), points.y.data(), points.size(), out);
+}
+
+void Geom::dist(
+    const Seg &seg, const double *x, const double *y, std::size_t n,
+    double *out)
+{
+    distsq_impl(seg, x, y, n, out, true);
+}
+
+void Geom::dist(const Seg &seg, const PointSet &points, double *out)
+{
+    dist(seg, points.x.data(), points.y.data(), points.size(), out);
+}
+
+std::size_t Geom::intersects(
+    const Seg &seg, const CircleSet &circles, bool *out)
+{
+    // The segment must pass within the radius of the origin, and one of its
+    // ends must lie outside the circle.
+    SegTerms s(seg);
+    SegLanes sl(s);
+    const Lanes::V ex = Lanes::set1(s.ex), ey = Lanes::set1(s.ey);
+    const double *x = circles.x.data(), *y = circles.y.data(),
+                 *r = circles.radius.data();
+    std::size_t n = circles.size(), count = 0, i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N)
+    {
+        Lanes::V ox   = Lanes::load(x + i);
+        Lanes::V oy   = Lanes::load(y + i);
+        Lanes::V r2   = Lanes::mul(Lanes::load(r + i), Lanes::load(r + i));
+        Lanes::V near = Lanes::lt(seg_distsq(sl, ox, oy), r2);
+        Lanes::V far  = Lanes::max(
+            pt_distsq(sl.sx, sl.sy, ox, oy), pt_distsq(ex, ey, ox, oy));
+        count += store_mask(out + i, Lanes::both(near, Lanes::lt(r2, far)));
+    }
+    for (; i != n; ++i)
+    {
+        double r2  = r[i] * r[i];
+        double far = std::max(
+            (x[i] - s.sx) * (x[i] - s.sx) + (y[i] - s.sy) * (y[i] - s.sy),
+            (x[i] - s.ex) * (x[i] - s.ex) + (y[i] - s.ey) * (y[i] - s.ey));
+        out[i] = seg_distsq(s, x[i], y[i]) < r2 && r2 < far;
+        count += out[i];
+    }
+    return count;
+}
+
+std::size_t Geom::contains(
+    const Rect &rect, const double *x, const double *y, std::size_t n,
+    bool *out)
+{
+    const Point lo = rect.sw_corner(), hi = rect.ne_corner();
+    const Lanes::V lox = Lanes::set1(lo.x), loy = Lanes::set1(lo.y),
+                   hix = Lanes::set1(hi.x), hiy = Lanes::set1(hi.y);
+    std::size_t count = 0, i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N)
+    {
+        Lanes::V px = Lanes::load(x + i), py = Lanes::load(y + i);
+        count += store_mask(
+            out + i,
+            Lanes::both(
+                Lanes::both(Lanes::le(lox, px), Lanes::le(px, hix)),
+                Lanes::both(Lanes::le(loy, py), Lanes::le(py, hiy))));
+    }
+    for (; i != n; ++i)
+    {
+        out[i] = x[i] >= lo.x && y[i] >= lo.y && x[i] <= hi.x && y[i] <= hi.y;
+        count += out[i];
+    }
+    return count;
+}
+
+std::size_t Geom::contains(
+    const Rect &rect, const PointSet &points, bool *out)
+{
+    return contains(rect, points.x.data(), points.y.data(), points.size(), out);
+}
+
+void Geom::fast_sin(const double *angles, std::size_t n, double *out)
+{
+    trig_impl<Sin>(angles, n, out);
+}
+
+void Geom::fast_cos(const double *angles, std::size_t n, double *out)
+{
+    trig_impl<Cos>(angles, n, out);
+}
+
+void Geom::fast_asin(const double *x, std::size_t n, double *out)
+{
+    trig_impl<Asin>(x, n, out);
+}
+
+void Geom::fast_atan2(
+    const double *y, const double *x, std::size_t n, double *out)
+{
+    std::size_t i = 0;
+    for (; i + Lanes::N <= n; i += Lanes::N)
+    {
+        Lanes::store(
+            out + i,
+            FastTrig::atan2<Lanes>(Lanes::load(y + i), Lanes::load(x + i)));
+    }
+    for (; i != n; ++i)
+    {
+        out[i] = FastTrig::atan2<FastTrig::ScalarOps<double>>(y[i], x[i]);
+    }
+}
+
+void Geom::fast_orientation(const PointSet &points, double *out)
+{
+    fast_atan2(points.y.data(), points.x.data(), points.size(), out);
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "geom/point.h"
+#include "geom/rect.h"
+#include "geom/shapes.h"
+
+namespace Geom
+{
+/**
+ * \brief A set of points stored as separate coordinate arrays.
+ *
+ * Keeping the <var>x</var> and <var>y</var> values apart lets the batch
+ * functions below load several points per instruction.
+ */
+class PointSet final
+{
+   public:
+    /**
+     * \brief The <var>x</var> coordinates of the points.
+     */
+    std::vector<double> x;
+
+    /**
+     * \brief The <var>y</var> coordinates of the points.
+     */
+    std::vector<double> y;
+
+    /**
+     * \brief Returns the number of points.
+     *
+     * \return the number of points
+     */
+    std::size_t size() const
+    {
+        return x.size();
+    }
+
+    /**
+     * \brief Returns one of the points.
+     *
+     * \param[in] i the index of the point
+     *
+     * \return the point
+     */
+    Vector2 operator[](std::size_t i) const
+    {
+        return Vector2(x[i], y[i]);
+    }
+
+    /**
+     * \brief Removes all the points.
+     */
+    void clear()
+    {
+        x.clear();
+        y.clear();
+    }
+
+    /**
+     * \brief Reserves space for points.
+     *
+     * \param[in] n the number of points to make room for
+     */
+    void reserve(std::size_t n)
+    {
+        x.reserve(n);
+        y.reserve(n);
+    }
+
+    /**
+     * \brief Adds a point.
+     *
+     * \param[in] p the point to add
+     */
+    void push_back(const Vector2 &p)
+    {
+        x.push_back(p.x);
+        y.push_back(p.y);
+    }
+};
+
+/**
+ * \brief A set of circles stored as separate coordinate and radius arrays.
+ */
+class CircleSet final
+{
+   public:
+    /**
+     * \brief The <var>x</var> coordinates of the origins.
+     */
+    std::vector<double> x;
+
+    /**
+     * \brief The <var>y</var> coordinates of the origins.
+     */
+    std::vector<double> y;
+
+    /**
+     * \brief The radii, which must not be negative.
+     */
+    std::vector<double> radius;
+
+    /**
+     * \brief Returns the number of circles.
+     *
+     * \return the number of circles
+     */
+    std::size_t size() const
+    {
+        return x.size();
+    }
+
+    /**
+     * \brief Returns one of the circles.
+     *
+     * \param[in] i the index of the circle
+     *
+     * \return the circle
+     */
+    Circle operator[](std::size_t i) const
+    {
+        return Circle(Vector2(x[i], y[i]), radius[i]);
+    }
+
+    /**
+     * \brief Removes all the circles.
+     */
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        radius.clear();
+    }
+
+    /**
+     * \brief Reserves space for circles.
+     *
+     * \param[in] n the number of circles to make room for
+     */
+    void reserve(std::size_t n)
+    {
+        x.reserve(n);
+        y.reserve(n);
+        radius.reserve(n);
+    }
+
+    /**
+     * \brief Adds a circle.
+     *
+     * \param[in] c the circle to add
+     */
+    void push_back(const Circle &c)
+    {
+        x.push_back(c.origin.x);
+        y.push_back(c.origin.y);
+        radius.push_back(c.radius);
+    }
+};
+
+/*
+ * The batch functions evaluate one shape against every element of a set, with
+ * AVX or SSE2 when the compiler targets them, and write one result per element
+ * to `out`, which must have room for that many results. They agree with the
+ * scalar functions of the same names in geom/util.h to within rounding.
+ */
+
+/**
+ * \brief Computes the squared distances from points to a segment.
+ *
+ * \param[in] seg the segment
+ *
+ * \param[in] x the <var>x</var> coordinates of the points
+ *
+ * \param[in] y the <var>y</var> coordinates of the points
+ *
+ * \param[in] n the number of points
+ *
+ * \param[out] out the squared distances
+ */
+void distsq(
+    const Seg &seg, const double *x, const double *y, std::size_t n,
+    double *out);
+void distsq(const Seg &seg, const PointSet &points, double *out);
+
+/**
+ * \brief Computes the distances from points to a segment.
+ *
+ * \param[in] seg the segment
+ *
+ * \param[in] x the <var>x</var> coordinates of the points
+ *
+ * \param[in] y the <var>y</var> coordinates of the points
+ *
+ * \param[in] n the number of points
+ *
+ * \param[out] out the distances
+ */
+void dist(
+    const Seg &seg, const double *x, const double *y, std::size_t n,
+    double *out);
+void dist(const Seg &seg, const PointSet &points, double *out);
+
+/**
+ * \brief Checks which circles a segment crosses the boundary of, as
+ * <code>intersects(const Seg &, const Circle &)</code> does.
+ *
+ * \param[in] seg the segment
+ *
+ * \param[in] circles the circles
+ *
+ * \param[out] out whether each circle is intersected
+ *
+ * \return the number of circles intersected
+ */
+std::size_t intersects(const Seg &seg, const CircleSet &circles, bool *out);
+
+/**
+ * \brief Checks which points lie in a rectangle, edges included.
+ *
+ * \param[in] rect the rectangle
+ *
+ * \param[in] x the <var>x</var> coordinates of the points
+ *
+ * \param[in] y the <var>y</var> coordinates of the points
+ *
+ * \param[in] n the number of points
+ *
+ * \param[out] out whether each point is contained
+ *
+ * \return the number of points contained
+ */
+std::size_t contains(
+    const Rect &rect, const double *x, const double *y, std::size_t n,
+    bool *out);
+std::size_t contains(const Rect &rect, const PointSet &points, bool *out);
+
+/*
+ * The fast trigonometric functions evaluate the polynomials of
+ * geom/fast_trig.h over arrays, with the same lane widths as the functions
+ * above. Their results match BasicAngle::fast_sin and friends for doubles.
+ */
+
+/**
+ * \brief Computes the sines of angles given in radians.
+ *
+ * \param[in] angles the angles
+ *
+ * \param[in] n the number of angles
+ *
+ * \param[out] out the sines
+ */
+void fast_sin(const double *angles, std::size_t n, double *out);
+
+/**
+ * \brief Computes the cosines of angles given in radians.
+ *
+ * \param[in] angles the angles
+ *
+ * \param[in] n the number of angles
+ *
+ * \param[out] out the cosines
+ */
+void fast_cos(const double *angles, std::size_t n, double *out);
+
+/**
+ * \brief Computes arc sines, in radians.
+ *
+ * \param[in] x the values, in [-1, 1]
+ *
+ * \param[in] n the number of values
+ *
+ * \param[out] out the angles
+ */
+void fast_asin(const double *x, std::size_t n, double *out);
+
+/**
+ * \brief Computes the directions of vectors, in radians in the range [-π, π].
+ *
+ * \param[in] y the <var>y</var> components of the vectors
+ *
+ * \param[in] x the <var>x</var> components of the vectors
+ *
+ * \param[in] n the number of vectors
+ *
+ * \param[out] out the angles
+ */
+void fast_atan2(const double *y, const double *x, std::size_t n, double *out);
+
+/**
+ * \brief Computes the directions of points as vectors from the origin, as
+ * <code>Point::fast_orientation</code> does.
+ *
+ * \param[in] points the points
+ *
+ * \param[out] out the angles, in radians
+ */
+void fast_orientation(const PointSet &points, double *out);
+}
@@ -0,0 +1,248 @@
+#ifndef GEOM_FAST_TRIG_H
+#define GEOM_FAST_TRIG_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+/**
+ * \brief Polynomial approximations of the trigonometric functions.
+ *
+ * Each kernel is written once against a set of operations, so the same
+ * arithmetic runs on scalars (through ScalarOps) and on SIMD vectors (through
+ * the lane types in geom/batch.cpp). The kernels have no branches; where
+ * libm would branch they compute both sides and select.
+ *
+ * Evaluated in double precision, the maximum absolute errors against libm
+ * are:
+ * <ul>
+ * <li>sin and cos: 2e-11, for arguments up to ±10<sup>8</sup> radians</li>
+ * <li>atan2: 3e-8 radians</li>
+ * <li>asin: 2e-8 radians</li>
+ * </ul>
+ * In single precision, rounding in the arithmetic dominates and all four are
+ * within 3e-7 for arguments up to ±10<sup>4</sup> radians.
+ */
+namespace FastTrig
+{
+/**
+ * \brief Scalar operations for the kernels.
+ *
+ * \tparam T the floating-point type to compute in.
+ */
+template <typename T>
+struct ScalarOps final
+{
+    typedef T V;
+    typedef T Scalar;
+
+    static V set1(double d)
+    {
+        return static_cast<T>(d);
+    }
+    static V add(V a, V b)
+    {
+        return a + b;
+    }
+    static V sub(V a, V b)
+    {
+        return a - b;
+    }
+    static V mul(V a, V b)
+    {
+        return a * b;
+    }
+    static V div(V a, V b)
+    {
+        return a / b;
+    }
+    static V min(V a, V b)
+    {
+        return b < a ? b : a;
+    }
+    static V max(V a, V b)
+    {
+        return a < b ? b : a;
+    }
+    static V sqrt(V a)
+    {
+        return std::sqrt(a);
+    }
+    static bool lt(V a, V b)
+    {
+        return a < b;
+    }
+    static V select(bool m, V a, V b)
+    {
+        return m ? a : b;
+    }
+};
+
+/**
+ * \brief Rounds to the nearest integer by adding and removing a constant
+ * large enough that no fraction bits remain.
+ */
+template <typename Ops>
+typename Ops::V round(typename Ops::V v)
+{
+    const typename Ops::V magic = Ops::set1(
+        1.5 / std::numeric_limits<typename Ops::Scalar>::epsilon());
+    return Ops::sub(Ops::add(v, magic), magic);
+}
+
+template <typename Ops>
+typename Ops::V abs(typename Ops::V v)
+{
+    return Ops::max(v, Ops::sub(Ops::set1(0.0), v));
+}
+
+/**
+ * \brief Evaluates a polynomial by Horner's rule.
+ *
+ * \param[in] x the variable.
+ *
+ * \param[in] c the coefficients, constant term first.
+ */
+template <typename Ops, std::size_t N>
+typename Ops::V poly(typename Ops::V x, const double (&c)[N])
+{
+    typename Ops::V p = Ops::set1(c[N - 1]);
+    for (std::size_t i = N - 1; i-- != 0;)
+    {
+        p = Ops::add(Ops::mul(p, x), Ops::set1(c[i]));
+    }
+    return p;
+}
+
+/**
+ * \brief Computes the sine of an angle advanced by a number of quarter turns.
+ *
+ * \param[in] x the angle in radians.
+ *
+ * \param[in] quarters the number of quarter turns to add, 0 for sine and 1
+ * for cosine.
+ */
+template <typename Ops>
+typename Ops::V sin_quarters(typename Ops::V x, double quarters)
+{
+    typedef typename Ops::V V;
+    static const double SIN[] = {-0.16666666663854807, 0.008333331874668191,
+        -0.0001984008672422771, 2.724992488724764e-06};
+    static const double COS[] = {0.041666666664430134, -0.0013888887682296175,
+        2.4800603189178997e-05, -2.7301193398540844e-07};
+    const V zero = Ops::set1(0.0), one = Ops::set1(1.0);
+
+    // Reduce to r in [−π/4, π/4], where x = r + kπ/2. The three parts of π/2
+    // have few enough bits that their products with k are exact.
+    static const double PIO2[] = {
+        1.5703125, 4.837512969970703125e-4, 7.54978995489188217e-8};
+    const V k = round<Ops>(Ops::mul(x, Ops::set1(2.0 / M_PI)));
+    V r       = x;
+    for (double part : PIO2)
+    {
+        r = Ops::sub(r, Ops::mul(k, Ops::set1(part)));
+    }
+
+    // The quadrant, from 0 to 3, picks the polynomial and the sign.
+    V q = Ops::add(k, Ops::set1(quarters));
+    q   = Ops::sub(
+        q, Ops::mul(
+               Ops::set1(4.0),
+               round<Ops>(Ops::mul(
+                   Ops::sub(q, Ops::set1(1.5)), Ops::set1(0.25)))));
+
+    const V s     = Ops::mul(r, r);
+    const V sin_r = Ops::add(r, Ops::mul(Ops::mul(r, s), poly<Ops>(s, SIN)));
+    const V cos_r = Ops::add(
+        Ops::sub(one, Ops::mul(Ops::set1(0.5), s)),
+        Ops::mul(Ops::mul(s, s), poly<Ops>(s, COS)));
+
+    const V v = Ops::select(
+        Ops::lt(
+            abs<Ops>(Ops::sub(abs<Ops>(Ops::sub(q, Ops::set1(2.0))), one)),
+            Ops::set1(0.5)),
+        cos_r, sin_r);
+    return Ops::select(Ops::lt(Ops::set1(1.5), q), Ops::sub(zero, v), v);
+}
+
+/**
+ * \brief Computes the sine of an angle in radians.
+ */
+template <typename Ops>
+typename Ops::V sin(typename Ops::V x)
+{
+    return sin_quarters<Ops>(x, 0.0);
+}
+
+/**
+ * \brief Computes the cosine of an angle in radians.
+ */
+template <typename Ops>
+typename Ops::V cos(typename Ops::V x)
+{
+    return sin_quarters<Ops>(x, 1.0);
+}
+
+/**
+ * \brief Computes the angle of a vector in radians, in the range [−π, π].
+ *
+ * Unlike libm, a <var>y</var> of −0 with negative <var>x</var> gives +π.
+ */
+template <typename Ops>
+typename Ops::V atan2(typename Ops::V y, typename Ops::V x)
+{
+    typedef typename Ops::V V;
+    static const double ATAN[] = {-0.3333328656394352, 0.19991237743060947,
+        -0.140241428421824, 0.08520492036856935};
+    const V zero = Ops::set1(0.0), one = Ops::set1(1.0);
+
+    // Reduce to the arctangent of a in [0, 1], then of a value no larger than
+    // tan(π/8) by the identity atan(a) = π/4 + atan((a − 1) / (a + 1)).
+    const V ax = abs<Ops>(x), ay = abs<Ops>(y);
+    V a        = Ops::div(
+        Ops::min(ax, ay),
+        Ops::max(
+            Ops::max(ax, ay),
+            Ops::set1(std::numeric_limits<typename Ops::Scalar>::min())));
+    const auto past_eighth = Ops::lt(Ops::set1(0.41421356237309503), a);
+    a = Ops::select(
+        past_eighth, Ops::div(Ops::sub(a, one), Ops::add(a, one)), a);
+
+    const V s = Ops::mul(a, a);
+    V r       = Ops::add(a, Ops::mul(Ops::mul(a, s), poly<Ops>(s, ATAN)));
+    r         = Ops::add(
+        r, Ops::select(past_eighth, Ops::set1(M_PI / 4.0), zero));
+
+    r = Ops::select(Ops::lt(ax, ay), Ops::sub(Ops::set1(M_PI / 2.0), r), r);
+    r = Ops::select(Ops::lt(x, zero), Ops::sub(Ops::set1(M_PI), r), r);
+    return Ops::select(Ops::lt(y, zero), Ops::sub(zero, r), r);
+}
+
+/**
+ * \brief Computes the arc sine of a value, in radians.
+ *
+ * Values outside [−1, 1] give NaN.
+ */
+template <typename Ops>
+typename Ops::V asin(typename Ops::V x)
+{
+    typedef typename Ops::V V;
+    static const double ASIN[] = {0.1666667241479382, 0.07498855072654163,
+        0.04500138006381668, 0.026554542233847178, 0.03808502351748623};
+    const V zero = Ops::set1(0.0), half = Ops::set1(0.5);
+
+    // Beyond ½, use asin(x) = π/2 − 2 asin(√((1 − x) / 2)).
+    const V ax      = abs<Ops>(x);
+    const auto high = Ops::lt(half, ax);
+    const V z       = Ops::select(
+        high, Ops::mul(Ops::sub(Ops::set1(1.0), ax), half), Ops::mul(ax, ax));
+    const V w = Ops::select(high, Ops::sqrt(z), ax);
+
+    V r = Ops::add(w, Ops::mul(Ops::mul(w, z), poly<Ops>(z, ASIN)));
+    r   = Ops::select(
+        high, Ops::sub(Ops::set1(M_PI / 2.0), Ops::add(r, r)), r);
+    return Ops::select(Ops::lt(x, zero), Ops::sub(zero, r), r);
+}
+}
+
+#endif
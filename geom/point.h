@@ -7,20 +7,28 @@
 
 /**
  * \brief A point or vector in 2D space
+ *
+ * \tparam T the floating-point type of the coordinates; large point clouds
+ * can use \c float to halve their footprint where the precision allows
  */
-
-class Point final
+template <typename T>
+class BasicPoint final
 {
    public:
+    /**
+     * \brief The type of the coordinates.
+     */
+    typedef T Scalar;
+
     /**
      * \brief The X coordinate of the Point
      */
-    double x;
+    T x;
 
     /**
      * \brief The Y coordinate of the Point
      */
-    double y;
+    T y;
 
     /**
      * \brief Creates a unit-magnitude Point for an angle
@@ -29,12 +37,12 @@ class Point final
      *
      * \return the Point
      */
-    static Point of_angle(Angle angle);
+    static BasicPoint of_angle(BasicAngle<T> angle);
 
     /**
      * \brief Creates the origin at (0,0)
      */
-    explicit constexpr Point();
+    explicit constexpr BasicPoint();
 
     /**
      * \brief Creates a Point at arbitrary coordinates.
@@ -48,28 +56,36 @@ class Point final
      *
      * \param[in] y the <var>y</var> value of the Point
      */
-    constexpr Point(double x, double y);
+    constexpr BasicPoint(T x, T y);
 
     /**
      * \brief Creates a copy of a Point
      *
      * \param[in] p the Point to duplicate
      */
-    constexpr Point(const Point &p);
+    constexpr BasicPoint(const BasicPoint &p);
+
+    /**
+     * \brief Converts a Point from another precision.
+     *
+     * \param[in] p the Point to convert
+     */
+    template <typename U>
+    explicit constexpr BasicPoint(const BasicPoint<U> &p);
 
     /**
      * \brief Returns the square of the length of the Point
      *
      * \return the square of the length of the Point
      */
-    constexpr double lensq() const __attribute__((warn_unused_result));
+    constexpr T lensq() const __attribute__((warn_unused_result));
 
     /**
      * \brief Returns the length of the Point
      *
      * \return the length of the Point
      */
-    double len() const __attribute__((warn_unused_result));
+    T len() const __attribute__((warn_unused_result));
 
     /**
      * \brief Returns the unit vector in the same direction as this Point
@@ -77,7 +93,7 @@ class Point final
      * \return a unit vector in the same direction as this Point, or a
      * zero-length Point if this Point is zero
      */
-    Point norm() const __attribute__((warn_unused_result));
+    BasicPoint norm() const __attribute__((warn_unused_result));
 
     /**
      * \brief Returns a scaled normalized vector in the same direction as this
@@ -88,14 +104,14 @@ class Point final
      * \return a vector in the same direction as this Point and with length \p
      * l, or a zero-length Point if this Point is zero
      */
-    Point norm(double l) const __attribute__((warn_unused_result));
+    BasicPoint norm(T l) const __attribute__((warn_unused_result));
 
     /**
      * \brief Returns the vector perpendicular to this Point
      *
      * \return a vector perpendicular to this Point
      */
-    constexpr Point perp() const __attribute__((warn_unused_result));
+    constexpr BasicPoint perp() const __attribute__((warn_unused_result));
 
     /**
      * \brief Rotates this Point counterclockwise by an angle
@@ -104,7 +120,8 @@ class Point final
      *
      * \return the Point rotated by rot
      */
-    Point rotate(Angle rot) const __attribute__((warn_unused_result));
+    BasicPoint rotate(BasicAngle<T> rot) const
+        __attribute__((warn_unused_result));
 
     /**
      * \brief Projects this vector onto another vector
@@ -113,7 +130,7 @@ class Point final
      *
      * \return the component of \p this that is in the same direction as \p n
      */
-    constexpr Point project(const Point &n) const
+    constexpr BasicPoint project(const BasicPoint &n) const
         __attribute__((warn_unused_result));
 
     /**
@@ -123,7 +140,7 @@ class Point final
      *
      * \return the dot product of the points
      */
-    constexpr double dot(const Point &other) const
+    constexpr T dot(const BasicPoint &other) const
         __attribute__((warn_unused_result));
 
     /**
@@ -134,12 +151,13 @@ class Point final
      * \return the <var>z</var> component of the 3-dimensional cross product \p
      * *this × \p other
      */
-    constexpr double cross(const Point &other) const
+    constexpr T cross(const BasicPoint &other) const
         __attribute__((warn_unused_result));
 
     /**
      */
-    Angle anglediff(const Point &other) const __attribute__((warn_unused_result));
+    BasicAngle<T> anglediff(const BasicPoint &other) const
+        __attribute__((warn_unused_result));
     /**
      * \brief Assigns one vector to another
      *
@@ -147,7 +165,7 @@ class Point final
      *
      * \return this vector
      */
-    Point &operator=(const Point &q);
+    BasicPoint &operator=(const BasicPoint &q);
 
     /**
      * \brief Returns the direction of this vector
@@ -156,7 +174,16 @@ class Point final
      * the positive <var>x</var> direction, π/2 being up, etc.
      * (in actuality, this is <code>std::atan2(y, x)</code>)
      */
-    Angle orientation() const __attribute__((warn_unused_result));
+    BasicAngle<T> orientation() const __attribute__((warn_unused_result));
+
+    /**
+     * \brief Returns the direction of this vector, approximately
+     *
+     * \return the direction of this vector as from orientation(), but
+     * computed by BasicAngle::fast_atan2
+     */
+    BasicAngle<T> fast_orientation() const
+        __attribute__((warn_unused_result));
 
     /**
      * \brief Checks whether this Point contains NaN in either coordinate
@@ -171,7 +198,7 @@ class Point final
      *
      * \param[in] other the other point to check against
      */
-    constexpr bool close(const Point &other) const;
+    constexpr bool close(const BasicPoint &other) const;
 
     /**
      * \brief Checks whether this Point is close to another Point
@@ -180,9 +207,14 @@ class Point final
      *
      * \param[in] dist the distance to check against
      */
-    constexpr bool close(const Point &other, double dist) const;
+    constexpr bool close(const BasicPoint &other, T dist) const;
 };
 
+/**
+ * \brief The point type used throughout, in double precision
+ */
+typedef BasicPoint<double> Point;
+
 namespace Geom
 {
 typedef Point Vector2;
@@ -197,7 +229,9 @@ typedef Point Vector2;
  *
  * \return the vector-sum of the two points
  */
-constexpr Point operator+(const Point &p, const Point &q)
+template <typename T>
+constexpr BasicPoint<T> operator+(
+    const BasicPoint<T> &p, const BasicPoint<T> &q)
     __attribute__((warn_unused_result));
 
 /**
@@ -209,7 +243,8 @@ constexpr Point operator+(const Point &p, const Point &q)
  *
  * \return \p p
  */
-Point &operator+=(Point &p, const Point &q);
+template <typename T>
+BasicPoint<T> &operator+=(BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Negates a Point
@@ -218,7 +253,9 @@ Point &operator+=(Point &p, const Point &q);
  *
  * \return \c −p
  */
-constexpr Point operator-(const Point &p) __attribute__((warn_unused_result));
+template <typename T>
+constexpr BasicPoint<T> operator-(const BasicPoint<T> &p)
+    __attribute__((warn_unused_result));
 
 /**
  * \brief Subtracts two points
@@ -229,7 +266,9 @@ constexpr Point operator-(const Point &p) __attribute__((warn_unused_result));
  *
  * \return the vector-difference of the two points
  */
-constexpr Point operator-(const Point &p, const Point &q)
+template <typename T>
+constexpr BasicPoint<T> operator-(
+    const BasicPoint<T> &p, const BasicPoint<T> &q)
     __attribute__((warn_unused_result));
 
 /**
@@ -241,7 +280,8 @@ constexpr Point operator-(const Point &p, const Point &q)
  *
  * \return p
  */
-Point &operator-=(Point &p, const Point &q);
+template <typename T>
+BasicPoint<T> &operator-=(BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Multiplies a vector by a scalar
@@ -252,7 +292,9 @@ Point &operator-=(Point &p, const Point &q);
  *
  * \return the scaled vector
  */
-constexpr Point operator*(double s, const Point &p)
+template <typename T>
+constexpr BasicPoint<T> operator*(
+    typename BasicPoint<T>::Scalar s, const BasicPoint<T> &p)
     __attribute__((warn_unused_result));
 
 /**
@@ -264,7 +306,9 @@ constexpr Point operator*(double s, const Point &p)
  *
  * \return the scaled vector
  */
-constexpr Point operator*(const Point &p, double s)
+template <typename T>
+constexpr BasicPoint<T> operator*(
+    const BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
     __attribute__((warn_unused_result));
 
 /**
@@ -276,7 +320,8 @@ constexpr Point operator*(const Point &p, double s)
  *
  * \return \p p
  */
-Point &operator*=(Point &p, double s);
+template <typename T>
+BasicPoint<T> &operator*=(BasicPoint<T> &p, typename BasicPoint<T>::Scalar s);
 
 /**
  * \brief Divides a vector by a scalar
@@ -287,7 +332,9 @@ Point &operator*=(Point &p, double s);
  *
  * \return the scaled vector
  */
-constexpr Point operator/(const Point &p, double s)
+template <typename T>
+constexpr BasicPoint<T> operator/(
+    const BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
     __attribute__((warn_unused_result));
 
 /**
@@ -299,7 +346,8 @@ constexpr Point operator/(const Point &p, double s)
  *
  * \return \p p
  */
-Point &operator/=(Point &p, double s);
+template <typename T>
+BasicPoint<T> &operator/=(BasicPoint<T> &p, typename BasicPoint<T>::Scalar s);
 
 /**
  * \brief Prints a vector to a stream
@@ -310,9 +358,9 @@ Point &operator/=(Point &p, double s);
  *
  * \return \p os
  */
-template <typename CharT, typename Traits>
+template <typename T, typename CharT, typename Traits>
 std::basic_ostream<CharT, Traits> &operator<<(
-    std::basic_ostream<CharT, Traits> &s, Point p);
+    std::basic_ostream<CharT, Traits> &s, BasicPoint<T> p);
 
 /**
  * \brief Compares two vectors for equality
@@ -324,7 +372,8 @@ std::basic_ostream<CharT, Traits> &operator<<(
  * \return \c true if \p p and \p q represent the same point, or \c false
  * otherwise
  */
-constexpr bool operator==(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator==(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Compares two vectors for inequality
@@ -336,7 +385,8 @@ constexpr bool operator==(const Point &p, const Point &q);
  * \return \c true if \p p and \p q represent different points, or \c false
  * otherwise
  */
-constexpr bool operator!=(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator!=(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Orders two vectors suitably for sorting
@@ -350,7 +400,8 @@ constexpr bool operator!=(const Point &p, const Point &q);
  *
  * \return \c true if \p p < \p q, or \c false otherwise
  */
-constexpr bool operator<(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator<(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Orders two vectors suitably for sorting
@@ -364,7 +415,8 @@ constexpr bool operator<(const Point &p, const Point &q);
  *
  * \return \c true if \p p > \p q, or \c false otherwise
  */
-constexpr bool operator>(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator>(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Orders two vectors suitably for sorting
@@ -378,7 +430,8 @@ constexpr bool operator>(const Point &p, const Point &q);
  *
  * \return \c true if \p p ≤ \p q, or \c false otherwise
  */
-constexpr bool operator<=(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator<=(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
 /**
  * \brief Orders two vectors suitably for sorting
@@ -392,204 +445,267 @@ constexpr bool operator<=(const Point &p, const Point &q);
  *
  * \return \c true if \p p ≥ \p q, or \c false otherwise
  */
-constexpr bool operator>=(const Point &p, const Point &q);
+template <typename T>
+constexpr bool operator>=(const BasicPoint<T> &p, const BasicPoint<T> &q);
 
-inline Point Point::of_angle(Angle angle)
+template <typename T>
+inline BasicPoint<T> BasicPoint<T>::of_angle(BasicAngle<T> angle)
 {
-    return Point(angle.cos(), angle.sin());
+    return BasicPoint<T>(angle.cos(), angle.sin());
 }
 
-inline constexpr Point::Point() : x(0.0), y(0.0)
+template <typename T>
+inline constexpr BasicPoint<T>::BasicPoint() : x(0), y(0)
 {
 }
 
-inline constexpr Point::Point(double x, double y) : x(x), y(y)
+template <typename T>
+inline constexpr BasicPoint<T>::BasicPoint(T x, T y) : x(x), y(y)
 {
 }
 
-inline constexpr Point::Point(const Point &p) : x(p.x), y(p.y)
+template <typename T>
+inline constexpr BasicPoint<T>::BasicPoint(const BasicPoint<T> &p)
+    : x(p.x), y(p.y)
 {
 }
 
-inline constexpr double Point::lensq() const
+template <typename T>
+template <typename U>
+inline constexpr BasicPoint<T>::BasicPoint(const BasicPoint<U> &p)
+    : x(static_cast<T>(p.x)), y(static_cast<T>(p.y))
+{
+}
+
+template <typename T>
+inline constexpr T BasicPoint<T>::lensq() const
 {
     return x * x + y * y;
 }
 
-inline double Point::len() const
+template <typename T>
+inline T BasicPoint<T>::len() const
 {
     return std::hypot(x, y);
 }
 
-inline Point Point::norm() const
+template <typename T>
+inline BasicPoint<T> BasicPoint<T>::norm() const
 {
-    return len() < 1.0e-9 ? Point() : Point(x / len(), y / len());
+    return len() < 1.0e-9 ? BasicPoint<T>()
+                          : BasicPoint<T>(x / len(), y / len());
 }
 
-inline Point Point::norm(double l) const
+template <typename T>
+inline BasicPoint<T> BasicPoint<T>::norm(T l) const
 {
-    return len() < 1.0e-9 ? Point() : Point(x * l / len(), y * l / len());
+    return len() < 1.0e-9 ? BasicPoint<T>()
+                          : BasicPoint<T>(x * l / len(), y * l / len());
 }
 
-inline constexpr Point Point::perp() const
+template <typename T>
+inline constexpr BasicPoint<T> BasicPoint<T>::perp() const
 {
-    return Point(-y, x);
+    return BasicPoint<T>(-y, x);
 }
 
-inline Point Point::rotate(Angle rot) const
+template <typename T>
+inline BasicPoint<T> BasicPoint<T>::rotate(BasicAngle<T> rot) const
 {
-    return Point(x * rot.cos() - y * rot.sin(), x * rot.sin() + y * rot.cos());
+    return BasicPoint<T>(
+        x * rot.cos() - y * rot.sin(), x * rot.sin() + y * rot.cos());
 }
 
-inline constexpr Point Point::project(const Point &n) const
+template <typename T>
+inline constexpr BasicPoint<T> BasicPoint<T>::project(
+    const BasicPoint<T> &n) const
 {
     return dot(n) / n.lensq() * n;
 }
 
-inline constexpr double Point::dot(const Point &other) const
+template <typename T>
+inline constexpr T BasicPoint<T>::dot(const BasicPoint<T> &other) const
 {
     return x * other.x + y * other.y;
 }
 
-inline constexpr double Point::cross(const Point &other) const
+template <typename T>
+inline constexpr T BasicPoint<T>::cross(const BasicPoint<T> &other) const
 {
     return x * other.y - y * other.x;
 }
 
-inline Point &Point::operator=(const Point &q)
+template <typename T>
+inline BasicPoint<T> &BasicPoint<T>::operator=(const BasicPoint<T> &q)
 {
     x = q.x;
     y = q.y;
     return *this;
 }
-inline Angle Point::anglediff(const Point &other) const {
+template <typename T>
+inline BasicAngle<T> BasicPoint<T>::anglediff(
+    const BasicPoint<T> &other) const {
 	return (*this).orientation().angle_diff(other.orientation());
 }
 
-inline Angle Point::orientation() const
+template <typename T>
+inline BasicAngle<T> BasicPoint<T>::orientation() const
+{
+    return BasicAngle<T>::of_radians(std::atan2(y, x));
+}
+
+template <typename T>
+inline BasicAngle<T> BasicPoint<T>::fast_orientation() const
 {
-    return Angle::of_radians(std::atan2(y, x));
+    return BasicAngle<T>::fast_atan2(y, x);
 }
 
-inline constexpr bool Point::isnan() const
+template <typename T>
+inline constexpr bool BasicPoint<T>::isnan() const
 {
     return x != x || y != y;
 }
 
-inline constexpr bool Point::close(const Point &other) const
+template <typename T>
+inline constexpr bool BasicPoint<T>::close(const BasicPoint<T> &other) const
 {
-    return Point(x - other.x, y - other.y).lensq() < 1e-18;
+    return BasicPoint<T>(x - other.x, y - other.y).lensq() < 1e-18;
 }
 
-inline constexpr bool Point::close(const Point &other, double dist) const
+template <typename T>
+inline constexpr bool BasicPoint<T>::close(
+    const BasicPoint<T> &other, T dist) const
 {
-    return Point(x - other.x, y - other.y).lensq() < dist * dist;
+    return BasicPoint<T>(x - other.x, y - other.y).lensq() < dist * dist;
 }
 
-inline constexpr Point operator+(const Point &p, const Point &q)
+template <typename T>
+inline constexpr BasicPoint<T> operator+(
+    const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
-    return Point(p.x + q.x, p.y + q.y);
+    return BasicPoint<T>(p.x + q.x, p.y + q.y);
 }
 
-inline Point &operator+=(Point &p, const Point &q)
+template <typename T>
+inline BasicPoint<T> &operator+=(BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     p.x += q.x;
     p.y += q.y;
     return p;
 }
 
-inline constexpr Point operator-(const Point &p)
+template <typename T>
+inline constexpr BasicPoint<T> operator-(const BasicPoint<T> &p)
 {
-    return Point(-p.x, -p.y);
+    return BasicPoint<T>(-p.x, -p.y);
 }
 
-inline constexpr Point operator-(const Point &p, const Point &q)
+template <typename T>
+inline constexpr BasicPoint<T> operator-(
+    const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
-    return Point(p.x - q.x, p.y - q.y);
+    return BasicPoint<T>(p.x - q.x, p.y - q.y);
 }
 
-inline Point &operator-=(Point &p, const Point &q)
+template <typename T>
+inline BasicPoint<T> &operator-=(BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     p.x -= q.x;
     p.y -= q.y;
     return p;
 }
 
-inline constexpr Point operator*(double s, const Point &p)
+template <typename T>
+inline constexpr BasicPoint<T> operator*(
+    typename BasicPoint<T>::Scalar s, const BasicPoint<T> &p)
 {
-    return Point(p.x * s, p.y * s);
+    return BasicPoint<T>(p.x * s, p.y * s);
 }
 
-inline constexpr Point operator*(const Point &p, double s)
+template <typename T>
+inline constexpr BasicPoint<T> operator*(
+    const BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
 {
-    return Point(p.x * s, p.y * s);
+    return BasicPoint<T>(p.x * s, p.y * s);
 }
 
-inline Point &operator*=(Point &p, double s)
+template <typename T>
+inline BasicPoint<T> &operator*=(
+    BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
 {
     p.x *= s;
     p.y *= s;
     return p;
 }
 
-inline constexpr Point operator/(const Point &p, double s)
+template <typename T>
+inline constexpr BasicPoint<T> operator/(
+    const BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
 {
-    return Point(p.x / s, p.y / s);
+    return BasicPoint<T>(p.x / s, p.y / s);
 }
 
-inline Point &operator/=(Point &p, double s)
+template <typename T>
+inline BasicPoint<T> &operator/=(
+    BasicPoint<T> &p, typename BasicPoint<T>::Scalar s)
 {
     p.x /= s;
     p.y /= s;
     return p;
 }
 
-template <typename CharT, typename Traits>
+template <typename T, typename CharT, typename Traits>
 inline std::basic_ostream<CharT, Traits> &operator<<(
-    std::basic_ostream<CharT, Traits> &s, Point p)
+    std::basic_ostream<CharT, Traits> &s, BasicPoint<T> p)
 {
     s << '(' << p.x << ',' << p.y << ')';
     return s;
 }
 
-inline constexpr bool operator==(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator==(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return p.x == q.x && p.y == q.y;
 }
 
-inline constexpr bool operator!=(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator!=(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return !(p == q);
 }
 
-inline constexpr bool operator<(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator<(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return p.x != q.x ? p.x < q.x : p.y < q.y;
 }
 
-inline constexpr bool operator>(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator>(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return !(p < q || p == q);
 }
 
-inline constexpr bool operator<=(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator<=(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return p < q || p == q;
 }
 
-inline constexpr bool operator>=(const Point &p, const Point &q)
+template <typename T>
+inline constexpr bool operator>=(const BasicPoint<T> &p, const BasicPoint<T> &q)
 {
     return !(p < q);
 }
 
 namespace std
 {
-template <>
-struct hash<Point> final
+template <typename T>
+struct hash<BasicPoint<T>> final
 {
-    std::size_t operator()(const Point &p) const
+    std::size_t operator()(const BasicPoint<T> &p) const
     {
-        std::hash<double> h;
+        std::hash<T> h;
         return h(p.x) * 17 + h(p.y);
     }
 };
@@ -0,0 +1,249 @@
+#include "geom/spatial_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+int clamp_cell(double c, int count)
+{
+    if (!(c > 0.0))
+    {
+        return 0;
+    }
+    if (c > count - 1)
+    {
+        return count - 1;
+    }
+    return static_cast<int>(c);
+}
+}
+
+SpatialIndex::SpatialIndex(const Rect &area, double cell_size)
+    : origin(area.sw_corner()),
+      cell_size(cell_size),
+      inv_cell_size(1.0 / cell_size),
+      cols(std::max(1, static_cast<int>(std::ceil(area.width() / cell_size)))),
+      rows(std::max(1, static_cast<int>(std::ceil(area.height() / cell_size)))),
+      cell_start(static_cast<std::size_t>(cols * rows + 1), 0)
+{
+    assert(cell_size > 0.0);
+}
+
+int SpatialIndex::col_of(double px) const
+{
+    return clamp_cell(std::floor((px - origin.x) * inv_cell_size), cols);
+}
+
+int SpatialIndex::row_of(double py) const
+{
+    return clamp_cell(std::floor((py - origin.y) * inv_cell_size), rows);
+}
+
+template <typename F>
+void SpatialIndex::for_each_in_row(int row, int col_lo, int col_hi, F f) const
+{
+    // Adjacent cells in a row are stored one after another.
+    const std::size_t first = static_cast<std::size_t>(row * cols);
+    for (std::size_t k = cell_start[first + static_cast<std::size_t>(col_lo)],
+                     end = cell_start[first +
+                                      static_cast<std::size_t>(col_hi) + 1];
+         k != end; ++k)
+    {
+        f(k);
+    }
+}
+
+void SpatialIndex::build(const std::vector<Point> &points)
+{
+    const std::size_t n = points.size();
+    point_cell.resize(n);
+    x.resize(n);
+    y.resize(n);
+    index.resize(n);
+    std::fill(cell_start.begin(), cell_start.end(), 0);
+
+    // Count the points in each cell, one slot along, and turn the counts into
+    // start offsets.
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        point_cell[i] = row_of(points[i].y) * cols + col_of(points[i].x);
+        ++cell_start[static_cast<std::size_t>(point_cell[i]) + 1];
+    }
+    for (std::size_t c = 1; c != cell_start.size(); ++c)
+    {
+        cell_start[c] += cell_start[c - 1];
+    }
+
+    // Place each point at its cell's cursor, which leaves every cursor at the
+    // start of the next cell, then shift the offsets back.
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        std::size_t pos = cell_start[static_cast<std::size_t>(point_cell[i])]++;
+        x[pos]          = points[i].x;
+        y[pos]          = points[i].y;
+        index[pos]      = i;
+    }
+    for (std::size_t c = cell_start.size() - 1; c != 0; --c)
+    {
+        cell_start[c] = cell_start[c - 1];
+    }
+    cell_start[0] = 0;
+}
+
+void SpatialIndex::within(
+    const Point &centre, double radius, std::vector<std::size_t> &out) const
+{
+    out.clear();
+    if (radius < 0.0)
+    {
+        return;
+    }
+    const double radius_sq = radius * radius;
+    const int col_lo = col_of(centre.x - radius),
+              col_hi = col_of(centre.x + radius);
+    const int row_hi = row_of(centre.y + radius);
+    for (int row = row_of(centre.y - radius); row <= row_hi; ++row)
+    {
+        for_each_in_row(row, col_lo, col_hi, [&](std::size_t k) {
+            if (distsq(Point(x[k], y[k]), centre) <= radius_sq)
+            {
+                out.push_back(index[k]);
+            }
+        });
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void SpatialIndex::within(
+    const Seg &path, double radius, std::vector<std::size_t> &out) const
+{
+    out.clear();
+    if (radius < 0.0)
+    {
+        return;
+    }
+    const double radius_sq = radius * radius;
+    const double inf       = std::numeric_limits<double>::infinity();
+
+    const double dx = path.end.x - path.start.x, dy = path.end.y - path.start.y;
+    const int row_lo = row_of(std::min(path.start.y, path.end.y) - radius),
+              row_hi = row_of(std::max(path.start.y, path.end.y) + radius);
+    for (int row = row_lo; row <= row_hi; ++row)
+    {
+        // A point in this row within the radius of the path is within the
+        // radius, in x, of the part of the path that passes within the radius,
+        // in y, of the row. Edge rows also hold the points beyond them.
+        const double band_lo =
+            row == 0 ? -inf : origin.y + row * cell_size - radius;
+        const double band_hi =
+            row == rows - 1 ? inf : origin.y + (row + 1) * cell_size + radius;
+        double t_lo = 0.0, t_hi = 1.0;
+        if (dy != 0.0)
+        {
+            double t1 = (band_lo - path.start.y) / dy,
+                   t2 = (band_hi - path.start.y) / dy;
+            t_lo = std::max(t_lo, std::min(t1, t2));
+            t_hi = std::min(t_hi, std::max(t1, t2));
+        }
+        else if (path.start.y < band_lo || path.start.y > band_hi)
+        {
+            continue;
+        }
+        if (t_lo > t_hi)
+        {
+            continue;
+        }
+        const double x1 = path.start.x + t_lo * dx,
+                     x2 = path.start.x + t_hi * dx;
+        for_each_in_row(
+            row, col_of(std::min(x1, x2) - radius),
+            col_of(std::max(x1, x2) + radius), [&](std::size_t k) {
+                if (distsq(Point(x[k], y[k]), path) <= radius_sq)
+                {
+                    out.push_back(index[k]);
+                }
+            });
+    }
+    std::sort(out.begin(), out.end());
+}
+
+std::size_t SpatialIndex::nearest(const Point &p) const
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    std::size_t best = size();
+    double best_sq   = inf;
+
+    auto consider = [&](std::size_t k) {
+        double d = distsq(Point(x[k], y[k]), p);
+        if (d < best_sq || (d == best_sq && index[k] < best))
+        {
+            best    = index[k];
+            best_sq = d;
+        }
+    };
+
+    // Search rings of cells outward from the one holding p, until the ring
+    // is wholly off the grid or everything outside the rings searched so far
+    // is farther than the best point found.
+    const int cx = col_of(p.x), cy = row_of(p.y);
+    const int last_ring =
+        std::max(std::max(cx, cols - 1 - cx), std::max(cy, rows - 1 - cy));
+    for (int ring = 0; ring <= last_ring; ++ring)
+    {
+        const int col_lo = std::max(cx - ring, 0),
+                  col_hi = std::min(cx + ring, cols - 1);
+        for (int row = std::max(cy - ring, 0),
+                 row_hi = std::min(cy + ring, rows - 1);
+             row <= row_hi; ++row)
+        {
+            if (row == cy - ring || row == cy + ring)
+            {
+                for_each_in_row(row, col_lo, col_hi, consider);
+            }
+            else
+            {
+                if (cx - ring >= 0)
+                {
+                    for_each_in_row(row, cx - ring, cx - ring, consider);
+                }
+                if (cx + ring < cols)
+                {
+                    for_each_in_row(row, cx + ring, cx + ring, consider);
+                }
+            }
+        }
+
+        // Points in later rings lie outside the searched block of cells, and
+        // cells past the edge of the grid do not exist.
+        double bound = inf;
+        if (cx - ring > 0)
+        {
+            bound = std::min(bound, p.x - (origin.x + (cx - ring) * cell_size));
+        }
+        if (cx + ring < cols - 1)
+        {
+            bound = std::min(
+                bound, origin.x + (cx + ring + 1) * cell_size - p.x);
+        }
+        if (cy - ring > 0)
+        {
+            bound = std::min(bound, p.y - (origin.y + (cy - ring) * cell_size));
+        }
+        if (cy + ring < rows - 1)
+        {
+            bound = std::min(
+                bound, origin.y + (cy + ring + 1) * cell_size - p.y);
+        }
+        bound = std::max(bound, 0.0);
+        if (bound * bound > best_sq)
+        {
+            break;
+        }
+    }
+    return best;
+}
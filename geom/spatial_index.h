@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "geom/point.h"
+#include "geom/rect.h"
+#include "geom/shapes.h"
+
+namespace Geom
+{
+/**
+ * \brief A uniform grid over an area of the field that finds points near a
+ * location or a path without scanning them all.
+ *
+ * The grid's dimensions are fixed at construction. \ref build files the
+ * points into cells with a counting sort, keeping each cell's points next to
+ * each other and cells in row order, so rebuilding every vision frame is
+ * cheap and, once the buffers have grown to the largest point count seen,
+ * does not allocate. Points outside the area are filed in the nearest edge
+ * cell and are still found by every query.
+ *
+ * Queries identify points by their index in the vector last given to \ref
+ * build, and give the same answers as scanning that vector with the
+ * functions in geom/util.h.
+ */
+class SpatialIndex final
+{
+   public:
+    /**
+     * \brief Constructs an empty index.
+     *
+     * \param[in] area the area the grid covers, normally the field plus its
+     * boundary
+     *
+     * \param[in] cell_size the side length of each cell, which must be
+     * positive; something near the typical query radius works well
+     */
+    explicit SpatialIndex(const Rect &area, double cell_size);
+
+    /**
+     * \brief Replaces the indexed points.
+     *
+     * \param[in] points the points to index
+     */
+    void build(const std::vector<Point> &points);
+
+    /**
+     * \brief Returns the number of indexed points.
+     *
+     * \return the number of points
+     */
+    std::size_t size() const
+    {
+        return x.size();
+    }
+
+    /**
+     * \brief Finds the points within a distance of a location.
+     *
+     * \param[in] centre the location
+     *
+     * \param[in] radius the distance
+     *
+     * \param[out] out the indices of the points no farther than \p radius
+     * from \p centre, in ascending order
+     */
+    void within(
+        const Point &centre, double radius,
+        std::vector<std::size_t> &out) const;
+
+    /**
+     * \brief Finds the points within a distance of a segment, such as the
+     * points that would block a ball or robot travelling along it.
+     *
+     * \param[in] path the segment
+     *
+     * \param[in] radius the half-width of the corridor around \p path
+     *
+     * \param[out] out the indices of the points no farther than \p radius
+     * from \p path, in ascending order
+     */
+    void within(
+        const Seg &path, double radius, std::vector<std::size_t> &out) const;
+
+    /**
+     * \brief Finds the point nearest a location.
+     *
+     * \param[in] p the location
+     *
+     * \return the index of the nearest point, the lowest such index if
+     * several are equally near, or \ref size if the index is empty
+     */
+    std::size_t nearest(const Point &p) const;
+
+   private:
+    Point origin;
+    double cell_size, inv_cell_size;
+    int cols, rows;
+
+    /**
+     * \brief The first entry of each cell in the arrays below, in row order,
+     * with one more element holding the number of entries.
+     */
+    std::vector<std::size_t> cell_start;
+
+    /**
+     * \brief The coordinates and original index of each point, ordered by
+     * cell.
+     */
+    std::vector<double> x, y;
+    std::vector<std::size_t> index;
+
+    std::vector<int> point_cell;
+
+    int col_of(double px) const;
+    int row_of(double py) const;
+    template <typename F>
+    void for_each_in_row(int row, int col_lo, int col_hi, F f) const;
+};
+}
@@ -1,12 +1,12 @@
 #include "geom/util.h"
 #include <algorithm>
-#include <cassert>
 #include <cmath>
 #include <iostream>
 #include <limits>
 #include "geom/angle.h"
+#include "geom/angle_sweep.h"
+#include "util/assignment.h"
 #include "util/dprint.h"
-#include "util/hungarian.h"
 
 namespace Geom
 {
@@ -15,12 +15,14 @@ double proj_len(const Seg &first, const Vector2 &second)
     return proj_len(first.to_vector2(), second - first.start);
 }
 
-double proj_len(const Vector2 &first, const Vector2 &second)
+template <typename T>
+T proj_len(const BasicPoint<T> &first, const BasicPoint<T> &second)
 {
     return first.dot(second) / first.len();
 }
 
-double dist(const Vector2 &first, const Vector2 &second)
+template <typename T>
+T dist(const BasicPoint<T> &first, const BasicPoint<T> &second)
 {
     return (first - second).len();
 }
@@ -91,7 +93,8 @@ double distsq(const Seg &first, const Vector2 &second)
     return distsq(second, first);
 }
 
-double distsq(const Vector2 &first, const Vector2 &second)
+template <typename T>
+T distsq(const BasicPoint<T> &first, const BasicPoint<T> &second)
 {
     return (first - second).lensq();
 }
@@ -291,119 +294,30 @@ std::vector<std::size_t> dist_matching(
     if (v1.size() != v2.size())
         LOG_ERROR(u8"vector sizes not equal");
 
-    if (v1.size() > 1)
-    {
-        // use hungarian O(n^3)
-        Hungarian hung(v1.size());
-        for (std::size_t i = 0; i < v1.size(); i++)
-            for (std::size_t o = 0; o < v1.size(); o++)
-                hung.weight(i, o) =
-                    0 - (v2[i] - v1[o]).len();  // this is negative because
-                                                // hungarian tries to maximize
-                                                // the total weight
-        // use lensq instead to put more weight on outliers?
-
-        hung.execute();
-        std::vector<std::size_t> order(v1.size());
-
-        for (std::size_t i = 0; i < v1.size(); i++)
-            order[i]       = hung.matchX(i);
-
-        return order;
-    }
-    else
-    {
-        // use permutative O(n!)
-        std::vector<std::size_t> order(v2.size());
-        for (std::size_t i = 0; i < v2.size(); ++i)
-        {
-            order[i] = i;
-        }
-        std::vector<std::size_t> best = order;
-        double bestscore              = 1e99;
-        const std::size_t N           = std::min(v1.size(), v2.size());
-        do
-        {
-            double score = 0;
-            for (std::size_t i = 0; i < N; ++i)
-            {
-                score += (v1[i] - v2[order[i]]).len();
-            }
-            if (score < bestscore)
-            {
-                bestscore = score;
-                best      = order;
-            }
-        } while (std::next_permutation(order.begin(), order.end()));
-        return best;
-    }
+    Assignment assignment;
+    assignment.resize(v1.size(), v2.size());
+    for (std::size_t i = 0; i < v1.size(); i++)
+        for (std::size_t o = 0; o < v2.size(); o++)
+            assignment.cost(i, o) = (v1[i] - v2[o]).len();
+    // use lensq instead to put more weight on outliers?
+
+    assignment.solve();
+    std::vector<std::size_t> order(v1.size());
+    for (std::size_t i = 0; i < v1.size(); i++)
+        order[i] = assignment.row_match(i);
+    return order;
 }
 
 std::vector<std::pair<Vector2, Angle>> angle_sweep_circles_all(
     const Vector2 &src, const Vector2 &p1, const Vector2 &p2,
     const std::vector<Vector2> &obstacles, const double &radius)
 {
+    AngleSweep sweep;
+    sweep.set_source(src, obstacles, radius);
     std::vector<std::pair<Vector2, Angle>> ret;
-
-    const Angle offangle = (p1 - src).orientation();
-    if (collinear(src, p1, p2))
+    for (const AngleSweep::Window &i : sweep.windows(Seg(p1, p2)))
     {
-        // std::cerr << "geom: collinear " << src << " " << p1 << " " << p2 <<
-        // std::endl;
-        // std::cerr << (p1 - src) << " " << (p2 - src) << std::endl;
-        // std::cerr << (p1 - src).cross(p2 - src) << std::endl;
-        return ret;
-    }
-
-    std::vector<std::pair<Angle, int>> events;
-    events.reserve(2 * obstacles.size() + 2);
-    events.push_back(std::make_pair(Angle::zero(), 1));  // p1 becomes angle 0
-    events.push_back(
-        std::make_pair(((p2 - src).orientation() - offangle).angle_mod(), -1));
-    for (Vector2 i : obstacles)
-    {
-        Vector2 diff = i - src;
-        if (diff.len() < radius)
-        {
-            return ret;
-        }
-
-        const Angle cent   = (diff.orientation() - offangle).angle_mod();
-        const Angle span   = Angle::asin(radius / diff.len());
-        const Angle range1 = cent - span;
-        const Angle range2 = cent + span;
-
-        if (range1 < -Angle::half() || range2 > Angle::half())
-        {
-            continue;
-        }
-        events.push_back(std::make_pair(range1, -1));
-        events.push_back(std::make_pair(range2, 1));
-    }
-    // do angle sweep for largest angle
-    std::sort(events.begin(), events.end());
-    Angle sum   = Angle::zero();
-    Angle start = events[0].first;
-    int cnt     = 0;
-    for (std::size_t i = 0; i + 1 < events.size(); ++i)
-    {
-        cnt += events[i].second;
-        assert(cnt <= 1);
-        if (cnt > 0)
-        {
-            sum += events[i + 1].first - events[i].first;
-        }
-        else
-        {
-            const Angle mid     = start + sum / 2 + offangle;
-            const Vector2 ray   = Vector2::of_angle(mid) * 10.0;
-            const Vector2 inter = line_intersect(src, src + ray, p1, p2);
-
-            ret.push_back(std::make_pair(inter, sum));
-
-            sum   = Angle::zero();
-            start = events[i + 1].first;
-        }
+        ret.push_back(std::make_pair(i.target, i.width));
     }
     return ret;
 }
@@ -412,93 +326,10 @@ std::pair<Vector2, Angle> angle_sweep_circles(
     const Vector2 &src, const Vector2 &p1, const Vector2 &p2,
     const std::vector<Vector2> &obstacles, const double &radius)
 {
-    // default value to return if nothing is valid
-    Vector2 bestshot     = (p1 + p2) * 0.5;
-    const Angle offangle = (p1 - src).orientation();
-    if (collinear(src, p1, p2))
-    {
-        // std::cerr << "geom: collinear " << src << " " << p1 << " " << p2 <<
-        // std::endl;
-        // std::cerr << (p1 - src) << " " << (p2 - src) << std::endl;
-        // std::cerr << (p1 - src).cross(p2 - src) << std::endl;
-        return std::make_pair(bestshot, Angle::zero());
-    }
-    std::vector<std::pair<Angle, int>> events;
-    events.reserve(2 * obstacles.size() + 2);
-    events.push_back(std::make_pair(Angle::zero(), 1));  // p1 becomes angle 0
-    events.push_back(
-        std::make_pair(((p2 - src).orientation() - offangle).angle_mod(), -1));
-    for (Vector2 i : obstacles)
-    {
-        Vector2 diff = i - src;
-        if (diff.len() < radius)
-        {
-            return std::make_pair(bestshot, Angle::zero());
-        }
-        const Angle cent   = (diff.orientation() - offangle).angle_mod();
-        const Angle span   = Angle::asin(radius / diff.len());
-        const Angle range1 = cent - span;
-        const Angle range2 = cent + span;
-
-        /*
-           if (range1 < -M_PI) {
-           // [-PI, range2]
-           events.push_back(std::make_pair(-M_PI, -1));
-           events.push_back(std::make_pair(range2, 1));
-           // [range1, PI]
-           events.push_back(std::make_pair(range1 + 2 * M_PI, -1));
-           events.push_back(std::make_pair(M_PI, 1));
-           } else if (range2 > M_PI) {
-           // [range1, PI]
-           events.push_back(std::make_pair(range1, -1));
-           events.push_back(std::make_pair(M_PI, 1));
-           // [-PI, range2]
-           events.push_back(std::make_pair(-M_PI, -1));
-           events.push_back(std::make_pair(range2 - 2 * M_PI, 1));
-           } else {
-           events.push_back(std::make_pair(range1, -1));
-           events.push_back(std::make_pair(range2, 1));
-           }
-         */
-
-        if (range1 < -Angle::half() || range2 > Angle::half())
-        {
-            continue;
-        }
-        events.push_back(std::make_pair(range1, -1));
-        events.push_back(std::make_pair(range2, 1));
-    }
-    // do angle sweep for largest angle
-    std::sort(events.begin(), events.end());
-    Angle best  = Angle::zero();
-    Angle sum   = Angle::zero();
-    Angle start = events[0].first;
-    int cnt     = 0;
-    for (std::size_t i = 0; i + 1 < events.size(); ++i)
-    {
-        cnt += events[i].second;
-        assert(cnt <= 1);
-        if (cnt > 0)
-        {
-            sum += events[i + 1].first - events[i].first;
-            if (best < sum)
-            {
-                best = sum;
-                // shoot ray from point p
-                // intersect with line p1-p2
-                const Angle mid     = start + sum / 2 + offangle;
-                const Vector2 ray   = Vector2::of_angle(mid) * 10.0;
-                const Vector2 inter = line_intersect(src, src + ray, p1, p2);
-                bestshot            = inter;
-            }
-        }
-        else
-        {
-            sum   = Angle::zero();
-            start = events[i + 1].first;
-        }
-    }
-    return std::make_pair(bestshot, best);
+    AngleSweep sweep;
+    sweep.set_source(src, obstacles, radius);
+    const AngleSweep::Window best = sweep.best(Seg(p1, p2));
+    return std::make_pair(best.target, best.width);
 }
 
 std::vector<Vector2> seg_buffer_boundaries(
@@ -600,7 +431,9 @@ std::vector<Vector2> circle_boundaries(
     return ans;
 }
 
-bool collinear(const Vector2 &a, const Vector2 &b, const Vector2 &c)
+template <typename T>
+bool collinear(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c)
 {
     if ((a - b).lensq() < EPS2 || (b - c).lensq() < EPS2 ||
         (a - c).lensq() < EPS2)
@@ -610,14 +443,16 @@ bool collinear(const Vector2 &a, const Vector2 &b, const Vector2 &c)
     return std::fabs((b - a).cross(c - a)) < EPS;
 }
 
-Vector2 clip_point(
-    const Vector2 &p, const Vector2 &bound1, const Vector2 &bound2)
+template <typename T>
+BasicPoint<T> clip_point(
+    const BasicPoint<T> &p, const BasicPoint<T> &bound1,
+    const BasicPoint<T> &bound2)
 {
-    const double minx = std::min(bound1.x, bound2.x);
-    const double miny = std::min(bound1.y, bound2.y);
-    const double maxx = std::max(bound1.x, bound2.x);
-    const double maxy = std::max(bound1.y, bound2.y);
-    Vector2 ret       = p;
+    const T minx      = std::min(bound1.x, bound2.x);
+    const T miny      = std::min(bound1.y, bound2.y);
+    const T maxx      = std::max(bound1.x, bound2.x);
+    const T maxy      = std::max(bound1.y, bound2.y);
+    BasicPoint<T> ret = p;
     if (p.x < minx)
     {
         ret.x = minx;
@@ -748,8 +583,10 @@ Vector2 vector_rect_intersect(
         1.0 / 0.0, 1.0 / 0.0);  // no solution found, propagate infinity
 }
 
-Vector2 closest_lineseg_point(
-    const Vector2 &centre, const Vector2 &segA, const Vector2 &segB)
+template <typename T>
+BasicPoint<T> closest_lineseg_point(
+    const BasicPoint<T> &centre, const BasicPoint<T> &segA,
+    const BasicPoint<T> &segB)
 {
     // if one of the end-points is extremely close to the centre point
     // then return 0.0
@@ -771,13 +608,13 @@ Vector2 closest_lineseg_point(
 
     // find point C
     // which is the projection onto the line
-    double lenseg = (segB - segA).dot(centre - segA) / (segB - segA).len();
-    Vector2 C     = segA + lenseg * (segB - segA).norm();
+    T lenseg        = (segB - segA).dot(centre - segA) / (segB - segA).len();
+    BasicPoint<T> C = segA + lenseg * (segB - segA).norm();
 
     // check if C is in the line seg range
-    double AC     = (segA - C).lensq();
-    double BC     = (segB - C).lensq();
-    double AB     = (segA - segB).lensq();
+    T AC          = (segA - C).lensq();
+    T BC          = (segB - C).lensq();
+    T AB          = (segA - segB).lensq();
     bool in_range = AC <= AB && BC <= AB;
 
     // if so return C
@@ -785,8 +622,8 @@ Vector2 closest_lineseg_point(
     {
         return C;
     }
-    double lenA = (centre - segA).len();
-    double lenB = (centre - segB).len();
+    T lenA = (centre - segA).len();
+    T lenB = (centre - segB).len();
 
     // otherwise return closest end of line-seg
     if (lenA < lenB)
@@ -822,8 +659,10 @@ std::vector<Vector2> lineseg_circle_intersect(
 }
 }
 
+template <typename T>
 bool unique_line_intersect(
-    const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d)
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c,
+    const BasicPoint<T> &d)
 {
     return std::abs((d - c).cross(b - a)) > EPS;
 }
@@ -843,8 +682,10 @@ std::vector<Point> line_intersect(const Geom::Seg &a, const Geom::Seg &b)
 }
 
 // ported code
-Vector2 line_intersect(
-    const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d)
+template <typename T>
+BasicPoint<T> line_intersect(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c,
+    const BasicPoint<T> &d)
 {
     // TODO figure out why this is asserting
     // assert(std::abs((d - c).cross(b - a)) > EPS);
@@ -886,22 +727,25 @@ Vector2 line_intersect(
 
 #warning a line intersect that takes segments would be nice
 
-Vector2 reflect(const Vector2 &v, const Vector2 &n)
+template <typename T>
+BasicPoint<T> reflect(const BasicPoint<T> &v, const BasicPoint<T> &n)
 {
     if (n.len() < EPS)
     {
         LOG_ERROR(u8"zero length");
         return v;
     }
-    Vector2 normal = n.norm();
+    BasicPoint<T> normal = n.norm();
     return v - 2 * v.dot(normal) * normal;
 }
 
-Vector2 reflect(const Vector2 &a, const Vector2 &b, const Vector2 &p)
+template <typename T>
+BasicPoint<T> reflect(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &p)
 {
     // Make a as origin.
     // Rotate by 90 degrees, does not matter which direction?
-    Vector2 n = (b - a).rotate(Angle::quarter());
+    BasicPoint<T> n = (b - a).rotate(BasicAngle<T>::quarter());
     return a + reflect(p - a, n);
 }
 
@@ -963,9 +807,10 @@ Vector2 calc_block_cone_defender(
 
 // ported cm code below
 
-double offset_to_line(Vector2 x0, Vector2 x1, Vector2 p)
+template <typename T>
+T offset_to_line(BasicPoint<T> x0, BasicPoint<T> x1, BasicPoint<T> p)
 {
-    Vector2 n;
+    BasicPoint<T> n;
 
     // get normal to line
     n = (x1 - x0).perp().norm();
@@ -973,9 +818,10 @@ double offset_to_line(Vector2 x0, Vector2 x1, Vector2 p)
     return n.dot(p - x0);
 }
 
-double offset_along_line(Vector2 x0, Vector2 x1, Vector2 p)
+template <typename T>
+T offset_along_line(BasicPoint<T> x0, BasicPoint<T> x1, BasicPoint<T> p)
 {
-    Vector2 n, v;
+    BasicPoint<T> n, v;
 
     // get normal to line
     n = x1 - x0;
@@ -986,10 +832,12 @@ double offset_along_line(Vector2 x0, Vector2 x1, Vector2 p)
     return n.dot(v);
 }
 
-Vector2 segment_near_line(Vector2 a0, Vector2 a1, Vector2 b0, Vector2 b1)
+template <typename T>
+BasicPoint<T> segment_near_line(
+    BasicPoint<T> a0, BasicPoint<T> a1, BasicPoint<T> b0, BasicPoint<T> b1)
 {
-    Vector2 v, n, p;
-    double dn, t;
+    BasicPoint<T> v, n, p;
+    T dn, t;
 
     v = a1 - a0;
     n = (b1 - b0).norm();
@@ -1016,28 +864,34 @@ Vector2 segment_near_line(Vector2 a0, Vector2 a1, Vector2 b0, Vector2 b1)
     return p;
 }
 
-Vector2 intersection(Vector2 a1, Vector2 a2, Vector2 b1, Vector2 b2)
+template <typename T>
+BasicPoint<T> intersection(
+    BasicPoint<T> a1, BasicPoint<T> a2, BasicPoint<T> b1, BasicPoint<T> b2)
 {
-    Vector2 a = a2 - a1;
+    BasicPoint<T> a = a2 - a1;
 
-    Vector2 b1r = (b1 - a1).rotate(-a.orientation());
-    Vector2 b2r = (b2 - a1).rotate(-a.orientation());
-    Vector2 br  = (b1r - b2r);
+    BasicPoint<T> b1r = (b1 - a1).rotate(-a.orientation());
+    BasicPoint<T> b2r = (b2 - a1).rotate(-a.orientation());
+    BasicPoint<T> br  = (b1r - b2r);
 
-    return Vector2(b2r.x - b2r.y * (br.x / br.y), 0.0).rotate(a.orientation()) +
+    return BasicPoint<T>(b2r.x - b2r.y * (br.x / br.y), 0)
+               .rotate(a.orientation()) +
            a1;
 }
 
-Angle vertex_angle(Vector2 a, Vector2 b, Vector2 c)
+template <typename T>
+BasicAngle<T> vertex_angle(BasicPoint<T> a, BasicPoint<T> b, BasicPoint<T> c)
 {
     return ((a - b).orientation() - (c - b).orientation()).angle_mod();
 }
 
-double closest_point_time(Vector2 x1, Vector2 v1, Vector2 x2, Vector2 v2)
+template <typename T>
+T closest_point_time(
+    BasicPoint<T> x1, BasicPoint<T> v1, BasicPoint<T> x2, BasicPoint<T> v2)
 {
-    Vector2 v = v1 - v2;
-    double sl = v.lensq();
-    double t;
+    BasicPoint<T> v = v1 - v2;
+    T sl            = v.lensq();
+    T t;
 
     if (sl < EPS)
     {
@@ -1052,16 +906,19 @@ double closest_point_time(Vector2 x1, Vector2 v1, Vector2 x2, Vector2 v2)
     return t;
 }
 
-bool point_in_front_vector(Vector2 offset, Vector2 dir, Vector2 p)
+template <typename T>
+bool point_in_front_vector(
+    BasicPoint<T> offset, BasicPoint<T> dir, BasicPoint<T> p)
 {
     // compare angle different
-    Angle a1   = dir.orientation();
-    Angle a2   = (p - offset).orientation();
-    Angle diff = (a1 - a2).angle_mod();
-    return diff < Angle::quarter() && diff > -Angle::quarter();
+    BasicAngle<T> a1   = dir.orientation();
+    BasicAngle<T> a2   = (p - offset).orientation();
+    BasicAngle<T> diff = (a1 - a2).angle_mod();
+    return diff < BasicAngle<T>::quarter() && diff > -BasicAngle<T>::quarter();
 }
 
-bool is_clockwise(Vector2 v1, Vector2 v2)
+template <typename T>
+bool is_clockwise(BasicPoint<T> v1, BasicPoint<T> v2)
 {
     if (v1.y * v2.x > v1.x * v2.y)
     {
@@ -1133,3 +990,28 @@ double getPointsVariance(const std::vector<Point> &points)
     sum /= static_cast<double>(points.size());
     return sqrt(sum);
 }
+
+#define INSTANTIATE(T, P)                                                      \
+    template T Geom::proj_len(const P &, const P &);                           \
+    template T Geom::dist(const P &, const P &);                               \
+    template T Geom::distsq(const P &, const P &);                             \
+    template bool collinear(const P &, const P &, const P &);                  \
+    template P clip_point(const P &, const P &, const P &);                    \
+    template P closest_lineseg_point(const P &, const P &, const P &);         \
+    template bool unique_line_intersect(                                       \
+        const P &, const P &, const P &, const P &);                           \
+    template P line_intersect(const P &, const P &, const P &, const P &);     \
+    template P reflect(const P &, const P &);                                  \
+    template P reflect(const P &, const P &, const P &);                       \
+    template T offset_to_line(P, P, P);                                        \
+    template T offset_along_line(P, P, P);                                     \
+    template P segment_near_line(P, P, P, P);                                  \
+    template P intersection(P, P, P, P);                                       \
+    template BasicAngle<T> vertex_angle(P, P, P);                              \
+    template T closest_point_time(P, P, P, P);                                 \
+    template bool point_in_front_vector(P, P, P);                              \
+    template bool is_clockwise(P, P);
+
+INSTANTIATE(float, BasicPoint<float>)
+INSTANTIATE(double, BasicPoint<double>)
+#undef INSTANTIATE
@@ -30,10 +30,17 @@ inline Quad quad(const Point &a, const Point &b, const Point &c, const Point &d)
     return {a, b, c, d};
 }
 
+/*
+ * Functions that take only points are templates over the coordinate type so
+ * that bulk evaluation can run in float. They are instantiated for float and
+ * double in util.cpp.
+ */
+
 /**
  * Signed magnitude of the projection of `second` on `first`
  */
-double proj_len(const Vector2 &first, const Vector2 &second);
+template <typename T>
+T proj_len(const BasicPoint<T> &first, const BasicPoint<T> &second);
 
 /**
  * Signed magnitude of the projection of `first.start -> second` on `first`
@@ -71,7 +78,9 @@ bool intersects(const Seg &first, const Ray &second);
  * The family of `dist` functions calculates the unsigned distance
  * between one object and another.
  */
-double dist(const Vector2 &first, const Vector2 &second);
+template <typename T>
+T dist(const BasicPoint<T> &first, const BasicPoint<T> &second);
+
 double dist(const Seg &first, const Seg &second);
 
 double dist(const Vector2 &first, const Seg &second);
@@ -82,7 +91,9 @@ double dist(const Vector2 &first, const Line &second);
 
 double distsq(const Vector2 &first, const Seg &second);
 double distsq(const Seg &first, const Vector2 &second);
-double distsq(const Vector2 &first, const Vector2 &second);
+
+template <typename T>
+T distsq(const BasicPoint<T> &first, const BasicPoint<T> &second);
 
 bool is_degenerate(const Seg &seg);
 bool is_degenerate(const Ray &seg);
@@ -115,7 +126,10 @@ Seg get_side(const Poly<N> &poly, unsigned int i);
  * \param[in] v2 the second set of points.
  *
  * \return the order of the matching, such that element <var>i</var> of input \p
- * v1 is matched with element \c order[<var>i</var>] of \p v2.
+ * v1 is matched with element \c order[<var>i</var>] of \p v2. If \p v1 is
+ * the larger set, its unmatched elements get \ref Assignment::UNASSIGNED.
+ *
+ * \see Assignment for matching repeatedly as the points move.
  */
 std::vector<std::size_t> dist_matching(
     const std::vector<Point> &v1, const std::vector<Point> &v2);
@@ -136,7 +150,9 @@ std::vector<std::size_t> dist_matching(
  * \returns true if the cross product of the two lines formed by the three
  * points are smaller than EPS
  */
-bool collinear(const Point &a, const Point &b, const Point &c);
+template <typename T>
+bool collinear(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c);
 
 /**
  * Performs an angle sweep.
@@ -188,7 +204,10 @@ std::pair<Point, Angle> angle_sweep_circles(
  * \param[in] radius the radii of the obstacles.
  *
  * \returns a vector of all possible pairs of directions and angles to a target
- * area. An empty vector is returned if the preconditions aren't satisfied.
+ * area, in counterclockwise order and each of nonzero width. An empty vector is
+ * returned if the preconditions aren't satisfied.
+ *
+ * \see AngleSweep for evaluating several targets from the same source.
  */
 std::vector<std::pair<Point, Angle>> angle_sweep_circles_all(
     const Point &src, const Point &p1, const Point &p2,
@@ -218,8 +237,10 @@ std::vector<Point> circle_boundaries(
  *
  * \return the Point on line segment closest to centre point.
  */
-Point closest_lineseg_point(
-    const Point &p, const Point &segA, const Point &segB);
+template <typename T>
+BasicPoint<T> closest_lineseg_point(
+    const BasicPoint<T> &p, const BasicPoint<T> &segA,
+    const BasicPoint<T> &segB);
 
 /**
  * Finds the points of intersection between a circle and a line.
@@ -279,7 +300,10 @@ Point vector_rect_intersect(
  *
  * \return the closest point to \p p that lies within the rectangle.
  */
-Point clip_point(const Point &p, const Point &bound1, const Point &bound2);
+template <typename T>
+BasicPoint<T> clip_point(
+    const BasicPoint<T> &p, const BasicPoint<T> &bound1,
+    const BasicPoint<T> &bound2);
 
 /**
  * Clips a point to a rectangle boundary.
@@ -305,8 +329,10 @@ Point clip_point(const Point &p, const Rect &r);
  *
  * \return whether there is one and only one answer
  */
+template <typename T>
 bool unique_line_intersect(
-    const Point &a, const Point &b, const Point &c, const Point &d);
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c,
+    const BasicPoint<T> &d);
 
 /**
  * Computes the intersection of two lines.
@@ -323,8 +349,10 @@ bool unique_line_intersect(
  *
  * \return the point of intersection.
  */
-Point line_intersect(
-    const Point &a, const Point &b, const Point &c, const Point &d);
+template <typename T>
+BasicPoint<T> line_intersect(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &c,
+    const BasicPoint<T> &d);
 
 std::vector<Point> line_intersect(const Geom::Seg &a, const Geom::Seg &b);
 
@@ -339,7 +367,8 @@ std::vector<Point> line_intersect(const Geom::Seg &a, const Geom::Seg &b);
  *
  * \return the reflected ray.
  */
-Point reflect(const Point &v, const Point &n);
+template <typename T>
+BasicPoint<T> reflect(const BasicPoint<T> &v, const BasicPoint<T> &n);
 
 /**
  * Reflects a point across a line.
@@ -352,7 +381,9 @@ Point reflect(const Point &v, const Point &n);
  *
  * \return the reflection of \p p across the line.
  */
-Point reflect(const Point &a, const Point &b, const Point &p);
+template <typename T>
+BasicPoint<T> reflect(
+    const BasicPoint<T> &a, const BasicPoint<T> &b, const BasicPoint<T> &p);
 
 /**
  * Given a cone shooting from the origin, determines the furthest location from
@@ -445,33 +476,42 @@ Point calc_block_cone_defender(
 /**
  * returns perpendicular offset from line x0-x1 to point p
  */
-double offset_to_line(Point x0, Point x1, Point p);
+template <typename T>
+T offset_to_line(BasicPoint<T> x0, BasicPoint<T> x1, BasicPoint<T> p);
 
 /**
  * returns perpendicular offset from line x0-x1 to point p
  */
-double offset_along_line(Point x0, Point x1, Point p);
+template <typename T>
+T offset_along_line(BasicPoint<T> x0, BasicPoint<T> x1, BasicPoint<T> p);
 
 /**
  * returns nearest point on segment a0-a1 to line b0-b1
  */
-Point segment_near_line(Point a0, Point a1, Point b0, Point b1);
+template <typename T>
+BasicPoint<T> segment_near_line(
+    BasicPoint<T> a0, BasicPoint<T> a1, BasicPoint<T> b0, BasicPoint<T> b1);
 
 /**
  * intersection of two segments?
  */
-Point intersection(Point a1, Point a2, Point b1, Point b2);
+template <typename T>
+BasicPoint<T> intersection(
+    BasicPoint<T> a1, BasicPoint<T> a2, BasicPoint<T> b1, BasicPoint<T> b2);
 
 /**
  * gives counterclockwise angle from <a-b> to <c-b>
  */
-Angle vertex_angle(Point a, Point b, Point c);
+template <typename T>
+BasicAngle<T> vertex_angle(BasicPoint<T> a, BasicPoint<T> b, BasicPoint<T> c);
 
 /**
  * returns time of closest point of approach of two points
  * moving along constant velocity vectors.
  */
-double closest_point_time(Point x1, Point v1, Point x2, Point v2);
+template <typename T>
+T closest_point_time(
+    BasicPoint<T> x1, BasicPoint<T> v1, BasicPoint<T> x2, BasicPoint<T> v2);
 
 /**
  * found out if a point is in the vector's direction or against it
@@ -483,13 +523,16 @@ double closest_point_time(Point x1, Point v1, Point x2, Point v2);
  *
  * param[in] p is the point is question
  */
-bool point_in_front_vector(Point offset, Point dir, Point p);
+template <typename T>
+bool point_in_front_vector(
+    BasicPoint<T> offset, BasicPoint<T> dir, BasicPoint<T> p);
 
 /**
  * Returns true if v2 is clockwise relative to v1
  */
 #warning this should work but hasn't been properly tested
-bool is_clockwise(Point v1, Point v2);
+template <typename T>
+bool is_clockwise(BasicPoint<T> v1, BasicPoint<T> v2);
 
 /**
  * Returns the circle's tangent points.
@@ -0,0 +1,158 @@
+#include "mrf/airtime_scheduler.h"
+#include <algorithm>
+#include <cassert>
+
+constexpr std::size_t MRFAirtimeScheduler::CLASS_COUNT;
+constexpr unsigned int MRFAirtimeScheduler::MAX_MESSAGES_IN_FLIGHT;
+constexpr std::size_t MRFAirtimeScheduler::FRAME_OVERHEAD;
+constexpr MRFAirtimeScheduler::Clock::duration
+    MRFAirtimeScheduler::MIN_BACKOFF;
+constexpr MRFAirtimeScheduler::Clock::duration
+    MRFAirtimeScheduler::MAX_BACKOFF;
+
+MRFAirtimeScheduler::MRFAirtimeScheduler(
+    unsigned int bit_rate, double share, Clock::duration burst)
+    : share(share),
+      burst(burst),
+      tokens(burst),
+      refilled(Clock::now()),
+      transmit_queue_full(false),
+      queue_ever_cleared(false),
+      backoff(MIN_BACKOFF),
+      backoffs_(0)
+{
+    assert(share > 0.0);
+    set_bit_rate(bit_rate);
+    for (ClassState &i : classes)
+    {
+        i.queued      = 0;
+        i.peak_queued = 0;
+        i.in_flight   = 0;
+        i.airtime     = Clock::duration::zero();
+    }
+}
+
+void MRFAirtimeScheduler::set_bit_rate(unsigned int bit_rate)
+{
+    assert(bit_rate);
+    byte_time = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::nanoseconds(8000000 / bit_rate));
+}
+
+MRFAirtimeScheduler::Clock::duration MRFAirtimeScheduler::airtime(
+    std::size_t length) const
+{
+    return byte_time * static_cast<Clock::rep>(length + FRAME_OVERHEAD);
+}
+
+bool MRFAirtimeScheduler::admit_message(
+    std::size_t length, Clock::time_point now)
+{
+    refill(now);
+    return !backing_off(now) &&
+           in_flight(Class::MESSAGE) < MAX_MESSAGES_IN_FLIGHT &&
+           tokens >= airtime(length);
+}
+
+MRFAirtimeScheduler::Clock::duration MRFAirtimeScheduler::message_delay(
+    std::size_t length, Clock::time_point now)
+{
+    refill(now);
+    if (transmit_queue_full ||
+        in_flight(Class::MESSAGE) >= MAX_MESSAGES_IN_FLIGHT)
+    {
+        return Clock::duration::max();
+    }
+    Clock::duration delay = Clock::duration::zero();
+    if (now < backoff_until)
+    {
+        delay = backoff_until - now;
+    }
+    Clock::duration deficit = airtime(length) - tokens;
+    if (deficit > Clock::duration::zero())
+    {
+        delay = std::max(
+            delay, std::chrono::duration_cast<Clock::duration>(
+                       std::chrono::duration<double, Clock::period>(
+                           static_cast<double>(deficit.count()) / share)));
+    }
+    return delay;
+}
+
+void MRFAirtimeScheduler::submitted(
+    Class cls, std::size_t length, Clock::time_point now)
+{
+    refill(now);
+    ClassState &state = classes[static_cast<std::size_t>(cls)];
+    Clock::duration t = airtime(length);
+    ++state.in_flight;
+    state.airtime += t;
+
+    // Drive and camera packets may run the bucket into debt, but only by one
+    // burst, so messages are delayed rather than starved outright.
+    tokens = std::max(tokens - t, -burst);
+}
+
+void MRFAirtimeScheduler::completed(Class cls)
+{
+    ClassState &state = classes[static_cast<std::size_t>(cls)];
+    assert(state.in_flight);
+    --state.in_flight;
+}
+
+void MRFAirtimeScheduler::set_queued(Class cls, std::size_t count)
+{
+    ClassState &state = classes[static_cast<std::size_t>(cls)];
+    state.queued      = count;
+    state.peak_queued = std::max(state.peak_queued, count);
+}
+
+void MRFAirtimeScheduler::set_transmit_queue_full(
+    bool full, Clock::time_point now)
+{
+    if (full == transmit_queue_full)
+    {
+        return;
+    }
+    transmit_queue_full = full;
+    if (full)
+    {
+        // Filling again soon after the last backoff means it was too short.
+        ++backoffs_;
+        if (queue_ever_cleared && now - queue_cleared < MAX_BACKOFF)
+        {
+            backoff = std::min(backoff * 2, MAX_BACKOFF);
+        }
+        else
+        {
+            backoff = MIN_BACKOFF;
+        }
+    }
+    else
+    {
+        queue_ever_cleared = true;
+        queue_cleared      = now;
+        backoff_until      = now + backoff;
+    }
+}
+
+void MRFAirtimeScheduler::reset_statistics()
+{
+    for (ClassState &i : classes)
+    {
+        i.peak_queued = i.queued;
+        i.airtime     = Clock::duration::zero();
+    }
+    backoffs_ = 0;
+}
+
+void MRFAirtimeScheduler::refill(Clock::time_point now)
+{
+    if (now > refilled)
+    {
+        tokens = std::min(
+            burst, tokens + std::chrono::duration_cast<Clock::duration>(
+                                (now - refilled) * share));
+        refilled = now;
+    }
+}
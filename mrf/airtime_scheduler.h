@@ -0,0 +1,279 @@
+#ifndef MRF_AIRTIME_SCHEDULER_H
+#define MRF_AIRTIME_SCHEDULER_H
+
+/**
+ * \file
+ *
+ * \brief Provides a budget for the radio airtime used by the host.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "util/noncopyable.h"
+
+/**
+ * \brief Decides when the host may hand message frames to the dongle, so that
+ * messages do not crowd out drive and camera packets.
+ *
+ * Airtime is accounted with a token bucket that refills at a fixed share of
+ * wall-clock time. Drive and camera packets are latency-critical and never
+ * wait: they are charged when submitted, even if that puts the bucket into
+ * debt. Messages are only admitted while the bucket holds enough airtime for
+ * them, fewer than \ref MAX_MESSAGES_IN_FLIGHT are outstanding, and the dongle
+ * is not reporting a full transmit queue.
+ *
+ * When the dongle reports its transmit queue full, messages are held until it
+ * clears and then for a backoff interval, which doubles each time the queue
+ * fills again soon after clearing.
+ *
+ * This class does no locking.
+ */
+class MRFAirtimeScheduler final : public NonCopyable
+{
+   public:
+    /**
+     * \brief The clock used for pacing.
+     */
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * \brief The kinds of traffic the host sends.
+     */
+    enum class Class
+    {
+        /**
+         * \brief Drive packets, on endpoint 1.
+         */
+        DRIVE,
+
+        /**
+         * \brief Camera packets, on endpoint 2.
+         */
+        CAMERA,
+
+        /**
+         * \brief Reliable and unreliable messages, on endpoint 3.
+         */
+        MESSAGE,
+    };
+
+    /**
+     * \brief The number of traffic classes.
+     */
+    static constexpr std::size_t CLASS_COUNT = 3;
+
+    /**
+     * \brief The most message transfers that may be outstanding at once.
+     */
+    static constexpr unsigned int MAX_MESSAGES_IN_FLIGHT = 4;
+
+    /**
+     * \brief The number of bytes each frame carries on air beyond its
+     * payload: preamble, start delimiter, length, MAC header and FCS.
+     */
+    static constexpr std::size_t FRAME_OVERHEAD = 17;
+
+    /**
+     * \brief The backoff after the first transmit-queue-full report.
+     */
+    static constexpr Clock::duration MIN_BACKOFF =
+        std::chrono::milliseconds(8);
+
+    /**
+     * \brief The longest backoff.
+     */
+    static constexpr Clock::duration MAX_BACKOFF =
+        std::chrono::milliseconds(256);
+
+    /**
+     * \brief Constructs a scheduler with a full bucket.
+     *
+     * \param[in] bit_rate the radio bit rate, in kilobits per second
+     *
+     * \param[in] share the fraction of wall-clock time the host may spend
+     * transmitting
+     *
+     * \param[in] burst the most airtime the bucket holds
+     */
+    explicit MRFAirtimeScheduler(
+        unsigned int bit_rate = 250, double share = 0.6,
+        Clock::duration burst = std::chrono::milliseconds(20));
+
+    /**
+     * \brief Changes the radio bit rate.
+     *
+     * \param[in] bit_rate the bit rate, in kilobits per second
+     */
+    void set_bit_rate(unsigned int bit_rate);
+
+    /**
+     * \brief Returns how long a frame occupies the air.
+     *
+     * \param[in] length the length of the USB payload, in bytes
+     *
+     * \return the airtime
+     */
+    Clock::duration airtime(std::size_t length) const;
+
+    /**
+     * \brief Checks whether a message may be submitted now.
+     *
+     * \param[in] length the length of the message transfer, in bytes
+     *
+     * \param[in] now the current time
+     *
+     * \return \c true if the message may be submitted
+     */
+    bool admit_message(std::size_t length, Clock::time_point now);
+
+    /**
+     * \brief Returns how long until a message could be admitted, assuming
+     * nothing else is submitted and no message completes.
+     *
+     * \param[in] length the length of the message transfer, in bytes
+     *
+     * \param[in] now the current time
+     *
+     * \return the delay, or \c Clock::duration::max() if admission depends on
+     * a message completing or the transmit queue clearing
+     */
+    Clock::duration message_delay(std::size_t length, Clock::time_point now);
+
+    /**
+     * \brief Records that a transfer was submitted.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \param[in] length the length of the transfer, in bytes
+     *
+     * \param[in] now the current time
+     */
+    void submitted(Class cls, std::size_t length, Clock::time_point now);
+
+    /**
+     * \brief Records that a transfer finished.
+     *
+     * \param[in] cls the traffic class
+     */
+    void completed(Class cls);
+
+    /**
+     * \brief Records how many transfers are waiting on the host.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \param[in] count the number waiting
+     */
+    void set_queued(Class cls, std::size_t count);
+
+    /**
+     * \brief Records the transmit-queue-full bit from a dongle status report.
+     *
+     * \param[in] full whether the dongle’s transmit queue is full
+     *
+     * \param[in] now the current time
+     */
+    void set_transmit_queue_full(bool full, Clock::time_point now);
+
+    /**
+     * \brief Returns the number of transfers waiting on the host.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \return the count
+     */
+    std::size_t queued(Class cls) const
+    {
+        return classes[static_cast<std::size_t>(cls)].queued;
+    }
+
+    /**
+     * \brief Returns the number of transfers submitted and not yet finished.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \return the count
+     */
+    unsigned int in_flight(Class cls) const
+    {
+        return classes[static_cast<std::size_t>(cls)].in_flight;
+    }
+
+    /**
+     * \brief Returns the peak number of transfers waiting on the host.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \return the count
+     */
+    std::size_t peak_queued(Class cls) const
+    {
+        return classes[static_cast<std::size_t>(cls)].peak_queued;
+    }
+
+    /**
+     * \brief Returns the total airtime charged.
+     *
+     * \param[in] cls the traffic class
+     *
+     * \return the airtime
+     */
+    Clock::duration airtime_used(Class cls) const
+    {
+        return classes[static_cast<std::size_t>(cls)].airtime;
+    }
+
+    /**
+     * \brief Returns the number of times the dongle reported its transmit
+     * queue full.
+     *
+     * \return the count
+     */
+    uint64_t backoffs() const
+    {
+        return backoffs_;
+    }
+
+    /**
+     * \brief Returns whether messages are being held because of a full
+     * transmit queue.
+     *
+     * \param[in] now the current time
+     *
+     * \return \c true if backing off
+     */
+    bool backing_off(Clock::time_point now) const
+    {
+        return transmit_queue_full || now < backoff_until;
+    }
+
+    /**
+     * \brief Zeroes the peak and cumulative statistics.
+     */
+    void reset_statistics();
+
+   private:
+    struct ClassState final
+    {
+        std::size_t queued, peak_queued;
+        unsigned int in_flight;
+        Clock::duration airtime;
+    };
+
+    Clock::duration byte_time;
+    const double share;
+    const Clock::duration burst;
+    Clock::duration tokens;
+    Clock::time_point refilled;
+    std::array<ClassState, CLASS_COUNT> classes;
+    bool transmit_queue_full, queue_ever_cleared;
+    Clock::duration backoff;
+    Clock::time_point backoff_until, queue_cleared;
+    uint64_t backoffs_;
+
+    void refill(Clock::time_point now);
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "mrf/console.h"
+#include <sigc++/functors/mem_fun.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "drive/primitive.h"
+#include "mrf/dongle.h"
+#include "mrf/robot.h"
+#include "util/exception.h"
+#include "util/main_loop.h"
+
+namespace
+{
+/**
+ * \brief The number of robots a dongle drives.
+ */
+const unsigned int NUM_ROBOTS = 8;
+
+unsigned int parse_unsigned(const std::string &word, unsigned int limit)
+{
+    char *end;
+    errno               = 0;
+    unsigned long value = std::strtoul(word.c_str(), &end, 10);
+    if (word.empty() || *end || errno || value >= limit)
+    {
+        throw std::invalid_argument("bad number " + word);
+    }
+    return static_cast<unsigned int>(value);
+}
+
+double parse_double(const std::string &word)
+{
+    char *end;
+    errno        = 0;
+    double value = std::strtod(word.c_str(), &end);
+    if (word.empty() || *end || errno)
+    {
+        throw std::invalid_argument("bad number " + word);
+    }
+    return value;
+}
+
+const char *estop_name(Drive::Dongle::EStopState state)
+{
+    switch (state)
+    {
+        case Drive::Dongle::EStopState::BROKEN:
+            return "broken";
+        case Drive::Dongle::EStopState::STOP:
+            return "stop";
+        case Drive::Dongle::EStopState::RUN:
+            return "run";
+    }
+    return "unknown";
+}
+}
+
+MRFConsole::MRFConsole(MRFDongle &dongle, int fd, std::ostream &out)
+    : dongle(dongle), fd(fd), out(out)
+{
+    io_connection = Glib::signal_io().connect(
+        sigc::mem_fun(this, &MRFConsole::handle_readable), fd,
+        Glib::IO_IN | Glib::IO_HUP);
+}
+
+MRFConsole::~MRFConsole()
+{
+    io_connection.disconnect();
+}
+
+bool MRFConsole::handle_readable(Glib::IOCondition)
+{
+    char buffer[4096];
+    ssize_t rc = read(fd, buffer, sizeof(buffer));
+    if (rc < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+            return true;
+        }
+        throw SystemError("read", errno);
+    }
+    if (!rc)
+    {
+        if (!pending.empty())
+        {
+            handle_line(pending);
+            pending.clear();
+        }
+        return false;
+    }
+
+    pending.append(buffer, static_cast<std::size_t>(rc));
+    std::string::size_type start = 0, newline;
+    while ((newline = pending.find('\n', start)) != std::string::npos)
+    {
+        handle_line(pending.substr(start, newline - start));
+        start = newline + 1;
+    }
+    pending.erase(0, start);
+    return true;
+}
+
+void MRFConsole::handle_line(const std::string &line)
+{
+    std::istringstream iss(line);
+    std::vector<std::string> words;
+    std::string word;
+    while (iss >> word)
+    {
+        words.push_back(std::move(word));
+    }
+    if (words.empty() || words[0][0] == '#')
+    {
+        return;
+    }
+
+    try
+    {
+        handle_command(words);
+    }
+    catch (const std::invalid_argument &exp)
+    {
+        out << "error " << exp.what() << '\n';
+    }
+    out << std::flush;
+}
+
+void MRFConsole::handle_command(const std::vector<std::string> &words)
+{
+    const std::string &command = words[0];
+    if (command == "status" && words.size() == 1)
+    {
+        out << "ok estop " << estop_name(dongle.estop_state) << '\n';
+        for (unsigned int i = 0; i != NUM_ROBOTS; ++i)
+        {
+            const MRFRobot &bot = dongle.robot(i);
+            if (bot.alive)
+            {
+                out << "robot " << i << " battery " << bot.battery_voltage
+                    << " capacitor " << bot.capacitor_voltage << " link "
+                    << bot.link_quality << " ball "
+                    << (bot.ball_in_beam ? 1 : 0) << " trips "
+                    << dongle.watchdog_trips(i) << " tries "
+                    << dongle.retry_policy().tries(i) << '\n';
+            }
+        }
+        out << "end\n";
+        return;
+    }
+    if (command == "quit" && words.size() == 1)
+    {
+        out << "ok\n";
+        MainLoop::quit();
+        return;
+    }
+    if (words.size() < 2)
+    {
+        throw std::invalid_argument("unknown command " + command);
+    }
+
+    unsigned int index = parse_unsigned(words[1], NUM_ROBOTS);
+    MRFRobot &bot      = dongle.robot(index);
+    if (command == "prim" && (words.size() == 7 || words.size() == 8))
+    {
+        unsigned int code = parse_unsigned(
+            words[2], static_cast<unsigned int>(Drive::Primitive::SPIN) + 1);
+        Drive::LLPrimitive::Params params;
+        for (std::size_t i = 0; i != params.size(); ++i)
+        {
+            params[i] = parse_double(words[3 + i]);
+        }
+        uint8_t extra = static_cast<uint8_t>(
+            words.size() == 8 ? parse_unsigned(words[7], 256) : 0);
+        if (bot.direct_control)
+        {
+            throw std::invalid_argument("robot under direct control");
+        }
+        bot.send_prim(Drive::LLPrimitive(
+            static_cast<Drive::Primitive>(code), params, extra));
+    }
+    else if ((command == "coast" || command == "brake") && words.size() == 2)
+    {
+        if (bot.direct_control)
+        {
+            throw std::invalid_argument("robot under direct control");
+        }
+        bot.send_prim(
+            command == "brake" ? Drive::move_brake() : Drive::move_coast());
+    }
+    else if (
+        (command == "kick" || command == "chip" || command == "autokick" ||
+         command == "autochip") &&
+        words.size() == 3)
+    {
+        double power = parse_double(words[2]);
+        bool chip    = command == "chip" || command == "autochip";
+        if (command[0] == 'a')
+        {
+            bot.direct_chicker_auto(power, chip);
+        }
+        else
+        {
+            bot.direct_chicker(power, chip);
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("unknown command " + command);
+    }
+    out << "ok\n";
+}
@@ -0,0 +1,78 @@
+#ifndef MRF_CONSOLE_H
+#define MRF_CONSOLE_H
+
+/**
+ * \file
+ *
+ * \brief Provides a line-oriented command interface for running the radio
+ * stack without a window.
+ */
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+#include <sigc++/trackable.h>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "util/noncopyable.h"
+
+class MRFDongle;
+
+/**
+ * \brief Reads text commands from a file descriptor, normally standard input,
+ * and applies them to a dongle.
+ *
+ * Each command is one line of whitespace-separated words, and each gets one
+ * reply line, either \c ok (possibly followed by data) or \c error followed
+ * by a reason. The commands are:
+ *
+ * \li <code>prim ROBOT CODE P0 P1 P2 P3 [EXTRA]</code>: sends a movement
+ * primitive, where \c CODE is a Drive::Primitive value.
+ *
+ * \li <code>coast ROBOT</code> and <code>brake ROBOT</code>: stop a robot.
+ *
+ * \li <code>kick ROBOT POWER</code>, <code>chip ROBOT POWER</code>,
+ * <code>autokick ROBOT POWER</code> and <code>autochip ROBOT POWER</code>:
+ * fire or arm the chicker.
+ *
+ * \li <code>status</code>: prints the emergency stop state and one line per
+ * live robot.
+ *
+ * \li <code>quit</code>: exits the main loop.
+ *
+ * Blank lines and lines starting with \c # are ignored. End of file stops
+ * reading but does not exit, so a daemon with standard input redirected from
+ * \c /dev/null keeps running.
+ */
+class MRFConsole final : public NonCopyable, public sigc::trackable
+{
+   public:
+    /**
+     * \brief Starts reading commands.
+     *
+     * \param[in] dongle the dongle to command
+     *
+     * \param[in] fd the descriptor to read, which must outlive the console
+     *
+     * \param[in] out where to write replies
+     */
+    explicit MRFConsole(MRFDongle &dongle, int fd, std::ostream &out);
+
+    /**
+     * \brief Stops reading commands.
+     */
+    ~MRFConsole();
+
+   private:
+    MRFDongle &dongle;
+    const int fd;
+    std::ostream &out;
+    sigc::connection io_connection;
+    std::string pending;
+
+    bool handle_readable(Glib::IOCondition);
+    void handle_line(const std::string &line);
+    void handle_command(const std::vector<std::string> &words);
+};
+
+#endif
@@ -60,6 +60,15 @@ enum
     CONTROL_REQUEST_SET_TIME              = 0x0F,
 };
 
+/**
+ * \brief The first byte of a reliable message that carries several shorter
+ * messages for the same robot, each preceded by its length in one byte.
+ *
+ * The robot handles the contained messages in order, and the whole frame is
+ * acknowledged with a single message delivery report.
+ */
+constexpr uint8_t MESSAGE_TYPE_BATCH = 0x40;
+
 /**
  * \brief The delivery status codes reported in message delivery reports.
  */
@@ -0,0 +1,270 @@
+#include "mrf/control_server.h"
+#include <glibmm/ustring.h>
+#include <sigc++/functors/mem_fun.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include "mrf/dongle.h"
+#include "mrf/robot.h"
+#include "mrf/shm_channel.h"
+#include "util/codec.h"
+#include "util/dprint.h"
+#include "util/exception.h"
+#include "util/misc.h"
+#include "util/sockaddrs.h"
+
+constexpr uint8_t MRFControlServer::COMMAND_PRIMITIVES;
+constexpr uint8_t MRFControlServer::COMMAND_CAMERA;
+constexpr uint8_t MRFControlServer::COMMAND_CHICKER;
+constexpr uint8_t MRFControlServer::COMMAND_ATTACH_SHM;
+
+namespace
+{
+/**
+ * \brief The size of one robot record in a primitives command.
+ */
+const std::size_t PRIMITIVE_RECORD_LENGTH = 3 + 4 * 4;
+
+/**
+ * \brief The size of the fixed part of a camera command, after the count.
+ */
+const std::size_t CAMERA_HEADER_LENGTH = 4 + 4 + 8;
+
+/**
+ * \brief The size of one robot record in a camera command.
+ */
+const std::size_t CAMERA_RECORD_LENGTH = 1 + 3 * 4;
+
+/**
+ * \brief The number of robots a dongle drives.
+ */
+const unsigned int NUM_ROBOTS = 8;
+}
+
+MRFControlServer::MRFControlServer(
+    MRFDongle &dongle, const std::string &address, MRFShmChannel *shm)
+    : dongle(dongle),
+      shm(shm),
+      sock(create_local_datagram_socket(address, unlink_path)),
+      commands_(0),
+      rejected_(0)
+{
+    prims.reserve(NUM_ROBOTS);
+    camera_robots.reserve(NUM_ROBOTS);
+    io_connection = Glib::signal_io().connect(
+        sigc::mem_fun(this, &MRFControlServer::handle_readable), sock.fd(),
+        Glib::IO_IN);
+}
+
+MRFControlServer::~MRFControlServer()
+{
+    io_connection.disconnect();
+    if (!unlink_path.empty())
+    {
+        unlink(unlink_path.c_str());
+    }
+    if (dispatch_latency_.count())
+    {
+        LOG_INFO(Glib::ustring::compose(
+            u8"Control server: %1 commands, %2 rejected, dispatch µs "
+            u8"p50 %3 p99 %4 max %5",
+            commands_, rejected_, dispatch_latency_.percentile(0.5),
+            dispatch_latency_.percentile(0.99), dispatch_latency_.max()));
+    }
+}
+
+bool MRFControlServer::handle_readable(Glib::IOCondition)
+{
+    // Drain every queued datagram in this wakeup so a burst costs only one
+    // trip through the main loop.
+    for (;;)
+    {
+        uint8_t buffer[512];
+        sockaddr_storage from;
+        socklen_t from_len = sizeof(from);
+        ssize_t rc         = recvfrom(
+            sock.fd(), buffer, sizeof(buffer), MSG_TRUNC,
+            reinterpret_cast<sockaddr *>(&from), &from_len);
+        if (rc < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            throw SystemError("recvfrom", errno);
+        }
+        std::chrono::steady_clock::time_point received =
+            std::chrono::steady_clock::now();
+        std::size_t length = static_cast<std::size_t>(rc);
+        if (!length || length > sizeof(buffer))
+        {
+            ++rejected_;
+            continue;
+        }
+
+        bool ok;
+        switch (buffer[0])
+        {
+            case COMMAND_PRIMITIVES:
+                ok = handle_primitives(buffer + 1, length - 1);
+                break;
+            case COMMAND_CAMERA:
+                ok = handle_camera(buffer + 1, length - 1);
+                break;
+            case COMMAND_CHICKER:
+                ok = handle_chicker(buffer + 1, length - 1);
+                break;
+            case COMMAND_ATTACH_SHM:
+                ok = length == 1 && handle_attach_shm(from, from_len);
+                break;
+            default:
+                ok = false;
+                break;
+        }
+        if (ok)
+        {
+            ++commands_;
+            dispatch_latency_.record(
+                std::chrono::steady_clock::now() - received);
+        }
+        else
+        {
+            ++rejected_;
+        }
+    }
+}
+
+bool MRFControlServer::handle_primitives(const uint8_t *data, std::size_t length)
+{
+    if (!length)
+    {
+        return false;
+    }
+    std::size_t count = data[0];
+    ++data;
+    --length;
+    if (length != count * PRIMITIVE_RECORD_LENGTH)
+    {
+        return false;
+    }
+
+    prims.clear();
+    for (std::size_t i = 0; i != count; ++i, data += PRIMITIVE_RECORD_LENGTH)
+    {
+        unsigned int index = data[0];
+        unsigned int code  = data[1];
+        if (index >= NUM_ROBOTS ||
+            code > static_cast<unsigned int>(Drive::Primitive::SPIN) ||
+            dongle.robot(index).direct_control)
+        {
+            ++rejected_;
+            continue;
+        }
+        Drive::LLPrimitive::Params params;
+        for (std::size_t j = 0; j != params.size(); ++j)
+        {
+            params[j] = decode_float_le(data + 3 + j * 4);
+        }
+        prims.emplace_back(
+            index, Drive::LLPrimitive(
+                       static_cast<Drive::Primitive>(code), params, data[2]));
+    }
+    if (!prims.empty())
+    {
+        dongle.send_prims(prims);
+    }
+    return true;
+}
+
+bool MRFControlServer::handle_camera(const uint8_t *data, std::size_t length)
+{
+    if (length < 1 + CAMERA_HEADER_LENGTH)
+    {
+        return false;
+    }
+    std::size_t count = data[0];
+    if (count > NUM_ROBOTS ||
+        length != 1 + CAMERA_HEADER_LENGTH + count * CAMERA_RECORD_LENGTH)
+    {
+        return false;
+    }
+    Point ball(decode_float_le(data + 1), decode_float_le(data + 5));
+    uint64_t timestamp = decode_u64_le(data + 9);
+    data += 1 + CAMERA_HEADER_LENGTH;
+
+    camera_robots.clear();
+    for (std::size_t i = 0; i != count; ++i, data += CAMERA_RECORD_LENGTH)
+    {
+        if (data[0] >= NUM_ROBOTS)
+        {
+            return false;
+        }
+        camera_robots.emplace_back(
+            data[0], Point(decode_float_le(data + 1), decode_float_le(data + 5)),
+            Angle::of_radians(decode_float_le(data + 9)));
+    }
+    dongle.send_camera_packet(camera_robots, ball, timestamp);
+    return true;
+}
+
+bool MRFControlServer::handle_chicker(const uint8_t *data, std::size_t length)
+{
+    if (length != 6 || data[0] >= NUM_ROBOTS)
+    {
+        return false;
+    }
+    MRFRobot &bot = dongle.robot(data[0]);
+    bool chip     = !!(data[1] & 0x01);
+    double power  = decode_float_le(data + 2);
+    if (data[1] & 0x02)
+    {
+        bot.direct_chicker_auto(power, chip);
+    }
+    else
+    {
+        bot.direct_chicker(power, chip);
+    }
+    return true;
+}
+
+bool MRFControlServer::handle_attach_shm(
+    const sockaddr_storage &from, socklen_t from_len)
+{
+    if (!shm || from_len <= sizeof(sa_family_t))
+    {
+        return false;
+    }
+
+    int fds[3] = {shm->memory_fd().fd(), shm->command_event_fd().fd(),
+                  shm->feedback_event_fd().fd()};
+    uint8_t reply = COMMAND_ATTACH_SHM;
+    iovec iov;
+    iov.iov_base = &reply;
+    iov.iov_len  = sizeof(reply);
+    alignas(cmsghdr) char control[64];
+    std::memset(control, 0, sizeof(control));
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name       = const_cast<sockaddr_storage *>(&from);
+    msg.msg_namelen    = from_len;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = cmsg_space(sizeof(fds));
+    cmsghdr *cmsg      = cmsg_firsthdr(&msg);
+    cmsg->cmsg_level   = SOL_SOCKET;
+    cmsg->cmsg_type    = SCM_RIGHTS;
+    cmsg->cmsg_len     = cmsg_len(sizeof(fds));
+    std::memcpy(cmsg_data(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(sock.fd(), &msg, MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+    {
+        LOG_WARN(Glib::ustring::compose(
+            u8"Failed to send shared memory channel: %1",
+            std::strerror(errno)));
+        return false;
+    }
+    return true;
+}
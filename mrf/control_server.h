@@ -0,0 +1,158 @@
+#ifndef MRF_CONTROL_SERVER_H
+#define MRF_CONTROL_SERVER_H
+
+/**
+ * \file
+ *
+ * \brief Provides a local socket through which another process can command
+ * robots.
+ */
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+#include <sigc++/trackable.h>
+#include <sys/socket.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "drive/primitive.h"
+#include "geom/angle.h"
+#include "geom/point.h"
+#include "util/fd.h"
+#include "util/latency_histogram.h"
+#include "util/noncopyable.h"
+
+class MRFDongle;
+class MRFShmChannel;
+
+/**
+ * \brief Accepts robot commands from an external process over a local
+ * datagram socket.
+ *
+ * Each datagram carries one command. All integers and floats are
+ * little-endian, and the first byte selects the command:
+ *
+ * \li \ref COMMAND_PRIMITIVES: u8 count, then \c count records of u8 robot
+ * index, u8 primitive code, u8 extra field and four f32 parameters. The batch
+ * is applied with MRFDongle::send_prims, so it reaches the robots in one drive
+ * packet.
+ *
+ * \li \ref COMMAND_CAMERA: u8 count, f32 ball x, f32 ball y, u64 camera
+ * timestamp, then \c count records of u8 robot index, f32 x, f32 y and f32
+ * orientation in radians. The frame is passed to
+ * MRFDongle::send_camera_packet.
+ *
+ * \li \ref COMMAND_CHICKER: u8 robot index, u8 flags (bit 0 set to chip,
+ * bit 1 set to arm autokick rather than fire now), f32 power.
+ *
+ * \li \ref COMMAND_ATTACH_SHM: no payload. If the server has a shared-memory
+ * channel, it replies to the sender with a one-byte datagram carrying the
+ * channel’s memory file, command eventfd and feedback eventfd, in that order,
+ * as \c SCM_RIGHTS ancillary data. The sender must be bound to an address.
+ *
+ * Commands are applied as soon as the main loop sees them, and the time from
+ * receiving each datagram to handing it to the dongle is recorded. Malformed
+ * commands, direct-mode primitives and primitives for robots under direct
+ * control are counted and dropped. Only \ref COMMAND_ATTACH_SHM is
+ * answered.
+ */
+class MRFControlServer final : public NonCopyable, public sigc::trackable
+{
+   public:
+    /**
+     * \brief The command byte for a batch of movement primitives.
+     */
+    static constexpr uint8_t COMMAND_PRIMITIVES = 0x01;
+
+    /**
+     * \brief The command byte for a camera frame.
+     */
+    static constexpr uint8_t COMMAND_CAMERA = 0x02;
+
+    /**
+     * \brief The command byte for a chicker command.
+     */
+    static constexpr uint8_t COMMAND_CHICKER = 0x03;
+
+    /**
+     * \brief The command byte for a request for the shared-memory channel.
+     */
+    static constexpr uint8_t COMMAND_ATTACH_SHM = 0x04;
+
+    /**
+     * \brief Starts listening for commands.
+     *
+     * \param[in] dongle the dongle through which to apply commands
+     *
+     * \param[in] address where to listen, as for \ref
+     * create_local_datagram_socket
+     *
+     * \param[in] shm the shared-memory channel to hand out, or null for none
+     */
+    explicit MRFControlServer(
+        MRFDongle &dongle, const std::string &address,
+        MRFShmChannel *shm = nullptr);
+
+    /**
+     * \brief Stops listening and removes the socket file, if any.
+     */
+    ~MRFControlServer();
+
+    /**
+     * \brief Returns the number of commands applied.
+     *
+     * \return the command count
+     */
+    uint64_t commands() const
+    {
+        return commands_;
+    }
+
+    /**
+     * \brief Returns the number of commands or records dropped as malformed
+     * or not allowed.
+     *
+     * \return the rejection count
+     */
+    uint64_t rejected() const
+    {
+        return rejected_;
+    }
+
+    /**
+     * \brief Returns the time from receiving each command to handing it to the
+     * dongle.
+     *
+     * This does not include any time the dongle then spends before submitting
+     * a USB transfer, such as waiting for an earlier drive transfer to finish
+     * or for a slot in the unreliable message queue.
+     *
+     * \return the latency histogram
+     */
+    const LatencyHistogram &dispatch_latency() const
+    {
+        return dispatch_latency_;
+    }
+
+   private:
+    MRFDongle &dongle;
+    MRFShmChannel *const shm;
+    std::string unlink_path;
+    FileDescriptor sock;
+    sigc::connection io_connection;
+    uint64_t commands_, rejected_;
+    LatencyHistogram dispatch_latency_;
+    std::vector<std::pair<unsigned int, Drive::LLPrimitive>> prims;
+    std::vector<std::tuple<uint8_t, Point, Angle>> camera_robots;
+
+    bool handle_readable(Glib::IOCondition);
+    bool handle_primitives(const uint8_t *data, std::size_t length);
+    bool handle_camera(const uint8_t *data, std::size_t length);
+    bool handle_chicker(const uint8_t *data, std::size_t length);
+    bool handle_attach_shm(const sockaddr_storage &from, socklen_t from_len);
+};
+
+#endif
@@ -5,10 +5,12 @@
 #include <sigc++/bind.h>
 #include <sigc++/functors/mem_fun.h>
 #include <sigc++/reference_wrapper.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 #include <algorithm>
 #include <bitset>
 #include <cassert>
+#include <cerrno>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
@@ -21,6 +23,7 @@
 #include "mrf/robot.h"
 #include "util/annunciator.h"
 #include "util/dprint.h"
+#include "util/exception.h"
 
 namespace
 {
@@ -40,6 +43,23 @@ const RadioConfig DEFAULT_CONFIGS[4] = {
 
 const unsigned int ANNUNCIATOR_BEEP_LENGTH = 750;
 
+/**
+ * \brief How often to check robots’ command deadlines, in milliseconds.
+ */
+const unsigned int WATCHDOG_TICK_MS = 10;
+
+/**
+ * \brief The bounds and starting size of the pools of inbound transfers
+ * waiting for message delivery reports and received messages.
+ */
+const unsigned int IN_TRANSFER_POOL_MIN = 4, IN_TRANSFER_POOL_INITIAL = 32,
+                   IN_TRANSFER_POOL_MAX = 128;
+
+/**
+ * \brief The longest message transfer the dongle accepts, header included.
+ */
+const std::size_t MESSAGE_TRANSFER_MAX = 64;
+
 std::unique_ptr<USB::BulkOutTransfer> create_reliable_message_transfer(
     USB::DeviceHandle &device, unsigned int robot, uint8_t message_id,
     unsigned int tries, const void *data, std::size_t length)
@@ -55,33 +75,145 @@ std::unique_ptr<USB::BulkOutTransfer> create_reliable_message_transfer(
         new USB::BulkOutTransfer(device, 3, buffer, sizeof(buffer), 64, 0));
     return ptr;
 }
+
+void encode_camera_packet(
+    std::vector<std::tuple<uint8_t, Point, Angle>> &detbots, Point ball,
+    uint64_t timestamp, int8_t (&camera_packet)[55])
+{
+    std::fill(camera_packet, camera_packet + 55, static_cast<int8_t>(0));
+    int8_t mask_vec =
+        0;  // Assume all robots don't have valid position at the start
+    uint8_t numbots = static_cast<uint8_t>(detbots.size());
+
+    // Initialize pointer to start at location of storing ball data. First 2
+    // bytes are for mask and flag vector
+    int8_t *rptr = &camera_packet[1];
+
+    int16_t ballX = static_cast<int16_t>(ball.x * 1000.0);
+    int16_t ballY = static_cast<int16_t>(ball.y * 1000.0);
+
+    *rptr++ = static_cast<int8_t>(ballX);  // Add Ball x position
+    *rptr++ = static_cast<int8_t>(ballX >> 8);
+
+    *rptr++ = static_cast<int8_t>(ballY);  // Add Ball Y position
+    *rptr++ = static_cast<int8_t>(ballY >> 8);
+    struct
+    {
+        bool operator()(
+            std::tuple<uint8_t, Point, Angle> a,
+            std::tuple<uint8_t, Point, Angle> b) const
+        {
+            return std::get<0>(a) < std::get<0>(b);
+        }
+    } customLess;
+
+    std::sort(detbots.begin(), detbots.end(), customLess);
+
+    // For the number of robot for which data was passed in, assign robot ids to
+    // mask vector and position/angle data to camera packet
+    for (std::size_t i = 0; i < numbots; i++)
+    {
+        uint8_t robotID = std::get<0>(detbots[i]);
+        int16_t robotX =
+            static_cast<int16_t>((std::get<1>(detbots[i])).x * 1000);
+        int16_t robotY =
+            static_cast<int16_t>((std::get<1>(detbots[i])).y * 1000);
+        int16_t robotT =
+            static_cast<int16_t>((std::get<2>(detbots[i])).to_radians() * 1000);
+
+        mask_vec |= int8_t(0x01 << (robotID));
+        *rptr++ = static_cast<int8_t>(robotX);
+        *rptr++ = static_cast<int8_t>(robotX >> 8);
+        *rptr++ = static_cast<int8_t>(robotY);
+        *rptr++ = static_cast<int8_t>(robotY >> 8);
+        *rptr++ = static_cast<int8_t>(robotT);
+        *rptr++ = static_cast<int8_t>(robotT >> 8);
+
+        //*rptr = ((int16_t)(std::get<1>(detbots[i])).x) +
+        //((int16_t)((std::get<1>(detbots[i])).y) << 16) +
+        //((int16_t)((std::get<2>(detbots[i])).to_radians() * 1000) << 32);
+        // rptr += 6;
+    }
+    // Write out the timestamp
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        *rptr++ = static_cast<int8_t>(timestamp >> 8 * i);
+    }
+
+    // Mask and Flag Vectors should be fully initialized by now. Assign them to
+    // the packet
+    camera_packet[0] = mask_vec;
+}
 }
 
+constexpr unsigned int MRFDongle::SendReliableMessageOperation::ADAPTIVE_TRIES;
+const std::chrono::milliseconds MRFDongle::DEFAULT_COMMAND_DEADLINE(250);
+
 MRFDongle::SendReliableMessageOperation::SendReliableMessageOperation(
     MRFDongle &dongle, unsigned int robot, unsigned int tries, const void *data,
     std::size_t length)
     : dongle(dongle),
-      message_id(dongle.alloc_message_id()),
+      robot(robot),
+      tries(
+          tries == ADAPTIVE_TRIES ? dongle.retry_policy_.tries(robot) : tries),
+      message_id(dongle.message_ids.alloc()),
+      delivery_id(message_id),
       delivery_status(0xFF),
+      payload(
+          static_cast<const uint8_t *>(data),
+          static_cast<const uint8_t *>(data) + length),
       transfer(create_reliable_message_transfer(
-          dongle.device, robot, message_id, tries, data, length))
+          dongle.device, robot, message_id, this->tries, data, length))
 {
     if (dongle.logger)
     {
         dongle.logger->log_mrf_message_out(
             robot, true, message_id, data, length);
     }
+    dongle.schedule_message(*transfer, robot, 3 + length, this);
     transfer->signal_done.connect(
         sigc::mem_fun(this, &SendReliableMessageOperation::out_transfer_done));
-    transfer->submit();
     mdr_connection =
         dongle.signal_message_delivery_report.connect(sigc::mem_fun(
             this, &SendReliableMessageOperation::message_delivery_report));
 }
 
+MRFDongle::SendReliableMessageOperation::~SendReliableMessageOperation()
+{
+    // A shared frame stays in flight until its last member lets go of it.
+    bool queued = false;
+    if (!batch)
+    {
+        queued = dongle.forget_message(*transfer);
+    }
+    else if (batch.unique())
+    {
+        dongle.forget_message(*batch);
+    }
+
+    // If the delivery report is still to come, the ID cannot be reused until
+    // it arrives, or the report would complete the wrong message. Only an ID
+    // that went on the air can get a report: a batch goes out under its
+    // leader’s ID alone. An in-flight transfer is cancelled here, and whether
+    // it reached the dongle first is never learned, so its ID is abandoned
+    // and the pool reclaims it after a timeout if no report comes.
+    if (mdr_connection.connected())
+    {
+        mdr_connection.disconnect();
+        if (queued || message_id != delivery_id)
+        {
+            dongle.message_ids.free(message_id);
+        }
+        else
+        {
+            dongle.message_ids.abandon(message_id);
+        }
+    }
+}
+
 void MRFDongle::SendReliableMessageOperation::result() const
 {
-    transfer->result();
+    (batch ? *batch : *transfer).result();
     switch (delivery_status)
     {
         case MRF::MDR_STATUS_OK:
@@ -102,18 +234,39 @@ void MRFDongle::SendReliableMessageOperation::out_transfer_done(
 {
     if (!op.succeeded())
     {
+        // The dongle never got the message, so no report will come.
+        if (mdr_connection.connected())
+        {
+            mdr_connection.disconnect();
+            dongle.message_ids.free(message_id);
+        }
         signal_done.emit(*this);
     }
 }
 
+void MRFDongle::SendReliableMessageOperation::join_batch(
+    const std::shared_ptr<USB::BulkOutTransfer> &frame, uint8_t id)
+{
+    batch       = frame;
+    delivery_id = id;
+    batch->signal_done.connect(
+        sigc::mem_fun(this, &SendReliableMessageOperation::out_transfer_done));
+}
+
 void MRFDongle::SendReliableMessageOperation::message_delivery_report(
     uint8_t id, uint8_t code)
 {
-    if (id == message_id)
+    if (id == delivery_id)
     {
         mdr_connection.disconnect();
         delivery_status = code;
-        dongle.free_message_id(message_id);
+        // Every member of a batch sees the frame’s one report; only the
+        // leader counts it towards the retry policy.
+        if (message_id == delivery_id)
+        {
+            dongle.retry_policy_.record_delivery(robot, code);
+        }
+        dongle.message_ids.free(message_id);
         signal_done.emit(*this);
     }
 }
@@ -143,6 +296,12 @@ MRFDongle::MRFDongle()
       radio_interface(-1),
       configuration_altsetting(-1),
       normal_altsetting(-1),
+      mdr_transfers(
+          device, 1, 8, IN_TRANSFER_POOL_MIN, IN_TRANSFER_POOL_INITIAL,
+          IN_TRANSFER_POOL_MAX),
+      message_transfers(
+          device, 2, 105, IN_TRANSFER_POOL_MIN, IN_TRANSFER_POOL_INITIAL,
+          IN_TRANSFER_POOL_MAX),
       status_transfer(device, 3, 1, true, 0),
       rx_fcs_fail_message(
           u8"Dongle receive FCS fail", Annunciator::Message::TriggerMode::EDGE,
@@ -157,7 +316,16 @@ MRFDongle::MRFDongle()
       receive_queue_full_message(
           u8"Receive Queue Full", Annunciator::Message::TriggerMode::LEVEL,
           Annunciator::Message::Severity::HIGH),
-      pending_beep_length(0)
+      unreliable_coalesced_(0),
+      drive_batch_active(false),
+      ingress_wake_pending(false),
+      ingress_dropped_(0),
+      ingress_peak_depth_(0),
+      batch_messages(false),
+      message_frames_saved_(0),
+      pending_beep_length(0),
+      watchdogs(),
+      watchdog_trips_(0)
 {
     // Sanity-check the dongle by looking for an interface with the appropriate
     // subclass and alternate settings with the appropriate protocols.
@@ -283,6 +451,7 @@ MRFDongle::MRFDongle()
             LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_INTERFACE,
             MRF::CONTROL_REQUEST_SET_SYMBOL_RATE, symbol_rate == 625 ? 1 : 0,
             static_cast<uint16_t>(radio_interface), 0);
+        airtime_.set_bit_rate(static_cast<unsigned int>(symbol_rate));
         device.control_no_data(
             LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_INTERFACE,
             MRF::CONTROL_REQUEST_SET_PAN_ID, pan_,
@@ -317,29 +486,44 @@ MRFDongle::MRFDongle()
         robots[i].reset(new MRFRobot(*this, i));
     }
 
-    // Prepare the available message IDs for allocation.
-    for (unsigned int i = 0; i < 256; ++i)
+    // Arm the command watchdog if asked to.
     {
-        free_message_ids.push(static_cast<uint8_t>(i));
+        std::chrono::milliseconds deadline(0);
+        const char *watchdog_string = std::getenv("MRF_WATCHDOG");
+        if (watchdog_string)
+        {
+            int i = std::stoi(watchdog_string, nullptr, 0);
+            if (i < 0)
+            {
+                throw std::out_of_range(
+                    "Watchdog deadline must be zero or positive.");
+            }
+            deadline = std::chrono::milliseconds(i);
+        }
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            set_command_deadline(i, deadline);
+        }
     }
 
-    // Submit the message delivery report transfers.
-    for (auto &i : mdr_transfers)
+    // Pack reliable messages into shared frames if the robots support it.
     {
-        i.reset(new USB::BulkInTransfer(device, 1, 8, false, 0));
-        i->signal_done.connect(sigc::mem_fun(this, &MRFDongle::handle_mdrs));
-        i->submit();
+        const char *batch_string = std::getenv("MRF_BATCH_MESSAGES");
+        if (batch_string)
+        {
+            batch_messages = std::stoi(batch_string, nullptr, 0) != 0;
+        }
     }
 
+    // Submit the message delivery report transfers.
+    mdr_transfers.signal_transfer_done.connect(
+        sigc::mem_fun(this, &MRFDongle::handle_mdrs));
+    mdr_transfers.start();
+
     // Submit the received message transfers.
-    for (auto &i : message_transfers)
-    {
-        i.reset(new USB::BulkInTransfer(device, 2, 105, false, 0));
-        i->signal_done.connect(sigc::bind(
-            sigc::mem_fun(this, &MRFDongle::handle_message),
-            sigc::ref(*i.get())));
-        i->submit();
-    }
+    message_transfers.signal_transfer_done.connect(
+        sigc::mem_fun(this, &MRFDongle::handle_message));
+    message_transfers.start();
 
     // Submit the estop transfer.
     status_transfer.signal_done.connect(
@@ -353,6 +537,21 @@ MRFDongle::MRFDongle()
     annunciator_beep_connections[1] =
         Annunciator::signal_message_reactivated.connect(sigc::mem_fun(
             this, &MRFDongle::handle_annunciator_message_reactivated));
+
+    // Prepare to accept commands posted from other threads.
+    {
+        int efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (efd < 0)
+        {
+            throw SystemError("eventfd", errno);
+        }
+        ingress_event = FileDescriptor::create_from_fd(efd);
+    }
+    ingress_prims.reserve(ingress_queue.capacity());
+    ingress_prim_stamps.reserve(ingress_queue.capacity());
+    ingress_connection = Glib::signal_io().connect(
+        sigc::mem_fun(this, &MRFDongle::handle_ingress_event),
+        ingress_event.fd(), Glib::IO_IN);
 }
 
 MRFDongle::~MRFDongle()
@@ -361,6 +560,9 @@ MRFDongle::~MRFDongle()
     annunciator_beep_connections[0].disconnect();
     annunciator_beep_connections[1].disconnect();
     drive_submit_connection.disconnect();
+    ingress_connection.disconnect();
+    watchdog_connection.disconnect();
+    message_pump_connection.disconnect();
 
     // Mark USB device as shutting down to squelch cancelled transfer warnings.
     device.mark_shutting_down();
@@ -388,25 +590,8 @@ void MRFDongle::log_to(MRFPacketLogger &logger)
     this->logger = &logger;
 }
 
-uint8_t MRFDongle::alloc_message_id()
-{
-    if (free_message_ids.empty())
-    {
-        throw std::runtime_error("Out of reliable message IDs");
-    }
-    uint8_t id = free_message_ids.front();
-    free_message_ids.pop();
-    return id;
-}
-
-void MRFDongle::free_message_id(uint8_t id)
-{
-    free_message_ids.push(id);
-}
-
-void MRFDongle::handle_mdrs(AsyncOperation<void> &op)
+void MRFDongle::handle_mdrs(USB::BulkInTransfer &mdr_transfer)
 {
-    USB::BulkInTransfer &mdr_transfer = dynamic_cast<USB::BulkInTransfer &>(op);
     mdr_transfer.result();
     if ((mdr_transfer.size() % 2) != 0)
     {
@@ -421,17 +606,19 @@ void MRFDongle::handle_mdrs(AsyncOperation<void> &op)
         }
         signal_message_delivery_report.emit(
             mdr_transfer.data()[i], mdr_transfer.data()[i + 1]);
+        message_ids.report(mdr_transfer.data()[i]);
     }
-    mdr_transfer.submit();
 }
 
-void MRFDongle::handle_message(
-    AsyncOperation<void> &, USB::BulkInTransfer &transfer)
+void MRFDongle::handle_message(USB::BulkInTransfer &transfer)
 {
     transfer.result();
     if (transfer.size() > 2)
     {
         unsigned int robot = transfer.data()[0];
+        retry_policy_.record_link(
+            robot, transfer.data()[transfer.size() - 2],
+            transfer.data()[transfer.size() - 1]);
         if (logger)
         {
             logger->log_mrf_message_in(
@@ -444,7 +631,6 @@ void MRFDongle::handle_message(
             transfer.data()[transfer.size() - 2],
             transfer.data()[transfer.size() - 1]);
     }
-    transfer.submit();
 }
 
 void MRFDongle::handle_status(AsyncOperation<void> &)
@@ -458,12 +644,40 @@ void MRFDongle::handle_status(AsyncOperation<void> &)
     second_dongle_message.active(status_transfer.data()[0] & 8U);
     transmit_queue_full_message.active(status_transfer.data()[0] & 16U);
     receive_queue_full_message.active(status_transfer.data()[0] & 32U);
+    {
+        std::lock_guard<std::mutex> lock(airtime_mtx);
+        airtime_.set_transmit_queue_full(
+            status_transfer.data()[0] & 16U, std::chrono::steady_clock::now());
+    }
+    pump_messages();
 
     status_transfer.submit();
 }
 
+void MRFDongle::send_prims(
+    const std::vector<std::pair<unsigned int, Drive::LLPrimitive>> &prims)
+{
+    // Apply every primitive before building a packet so that a batch is never
+    // split across drive packets.
+    drive_batch_active = true;
+    for (const auto &i : prims)
+    {
+        robot(i.first).send_prim(Drive::LLPrimitive(i.second));
+    }
+    drive_batch_active = false;
+
+    // The batch is complete, so there is no reason to wait for idle.
+    drive_submit_connection.disconnect();
+    submit_drive_transfer();
+}
+
 void MRFDongle::dirty_drive()
 {
+    if (drive_batch_active)
+    {
+        // send_prims will submit the packet once the whole batch is applied.
+        return;
+    }
     if (!drive_submit_connection.connected())
     {
         // Tells the Glib control loop to send a drive transfer when it has
@@ -479,70 +693,13 @@ void MRFDongle::send_camera_packet(
     std::vector<std::tuple<uint8_t, Point, Angle>> detbots, Point ball,
     uint64_t timestamp)
 {
-    int8_t camera_packet[55] = {0};
-    int8_t mask_vec =
-        0;  // Assume all robots don't have valid position at the start
-    uint8_t numbots = static_cast<uint8_t>(detbots.size());
-
-    // Initialize pointer to start at location of storing ball data. First 2
-    // bytes are for mask and flag vector
-    int8_t *rptr = &camera_packet[1];
-
-    int16_t ballX = static_cast<int16_t>(ball.x * 1000.0);
-    int16_t ballY = static_cast<int16_t>(ball.y * 1000.0);
-
-    *rptr++ = static_cast<int8_t>(ballX);  // Add Ball x position
-    *rptr++ = static_cast<int8_t>(ballX >> 8);
-
-    *rptr++ = static_cast<int8_t>(ballY);  // Add Ball Y position
-    *rptr++ = static_cast<int8_t>(ballY >> 8);
-    struct
-    {
-        bool operator()(
-            std::tuple<uint8_t, Point, Angle> a,
-            std::tuple<uint8_t, Point, Angle> b) const
-        {
-            return std::get<0>(a) < std::get<0>(b);
-        }
-    } customLess;
-
-    std::sort(detbots.begin(), detbots.end(), customLess);
-
-    // For the number of robot for which data was passed in, assign robot ids to
-    // mask vector and position/angle data to camera packet
-    for (std::size_t i = 0; i < numbots; i++)
-    {
-        uint8_t robotID = std::get<0>(detbots[i]);
-        int16_t robotX =
-            static_cast<int16_t>((std::get<1>(detbots[i])).x * 1000);
-        int16_t robotY =
-            static_cast<int16_t>((std::get<1>(detbots[i])).y * 1000);
-        int16_t robotT =
-            static_cast<int16_t>((std::get<2>(detbots[i])).to_radians() * 1000);
-
-        mask_vec |= int8_t(0x01 << (robotID));
-        *rptr++ = static_cast<int8_t>(robotX);
-        *rptr++ = static_cast<int8_t>(robotX >> 8);
-        *rptr++ = static_cast<int8_t>(robotY);
-        *rptr++ = static_cast<int8_t>(robotY >> 8);
-        *rptr++ = static_cast<int8_t>(robotT);
-        *rptr++ = static_cast<int8_t>(robotT >> 8);
-
-        //*rptr = ((int16_t)(std::get<1>(detbots[i])).x) +
-        //((int16_t)((std::get<1>(detbots[i])).y) << 16) +
-        //((int16_t)((std::get<2>(detbots[i])).to_radians() * 1000) << 32);
-        // rptr += 6;
-    }
-    // Write out the timestamp
-    for (std::size_t i = 0; i < 8; i++)
-    {
-        *rptr++ = static_cast<int8_t>(timestamp >> 8 * i);
-    }
-
-    // Mask and Flag Vectors should be fully initialized by now. Assign them to
-    // the packet
-    camera_packet[0] = mask_vec;
+    int8_t camera_packet[55];
+    encode_camera_packet(detbots, ball, timestamp, camera_packet);
+    submit_camera_packet(camera_packet);
+}
 
+void MRFDongle::submit_camera_packet(const int8_t (&packet)[55])
+{
     std::lock_guard<std::mutex> lock(cam_mtx);
 
     if (camera_transfers.size() >= 8)
@@ -561,7 +718,7 @@ void MRFDongle::send_camera_packet(
         std::chrono::duration_cast<std::chrono::microseconds>(diff);
     uint64_t stamp = static_cast<uint64_t>(micros.count());
     std::unique_ptr<USB::BulkOutTransfer> elt(
-        new USB::BulkOutTransfer(device, 2, camera_packet, 55, 55, 0));
+        new USB::BulkOutTransfer(device, 2, packet, 55, 55, 0));
     auto i = camera_transfers.insert(
         camera_transfers.end(),
         std::pair<std::unique_ptr<USB::BulkOutTransfer>, uint64_t>(
@@ -569,10 +726,290 @@ void MRFDongle::send_camera_packet(
     (*i).first->signal_done.connect(sigc::bind(
         sigc::mem_fun(this, &MRFDongle::handle_camera_transfer_done), i));
     (*i).first->submit();
+    {
+        std::lock_guard<std::mutex> airtime_lock(airtime_mtx);
+        airtime_.submitted(
+            MRFAirtimeScheduler::Class::CAMERA, sizeof(packet),
+            std::chrono::steady_clock::now());
+    }
 
     // std::cout << "Submitted camera transfer in position:"<<
     // camera_transfers.size() << std::endl;
 }
+bool MRFDongle::post_prim(unsigned int robot, const Drive::LLPrimitive &prim)
+{
+    assert(robot < 8);
+    IngressCommand cmd;
+    cmd.type      = IngressCommand::Type::PRIMITIVE;
+    cmd.robot     = static_cast<uint8_t>(robot);
+    cmd.primitive = prim;
+    return post_command(cmd);
+}
+
+bool MRFDongle::post_camera_packet(
+    std::vector<std::tuple<uint8_t, Point, Angle>> robots, Point ball,
+    uint64_t timestamp)
+{
+    // Encode on the caller’s thread so the main loop only has to submit.
+    int8_t camera_packet[55];
+    encode_camera_packet(robots, ball, timestamp, camera_packet);
+    IngressCommand cmd;
+    cmd.type   = IngressCommand::Type::CAMERA;
+    cmd.length = sizeof(camera_packet);
+    std::memcpy(cmd.data, camera_packet, sizeof(camera_packet));
+    return post_command(cmd);
+}
+
+bool MRFDongle::post_chicker(
+    unsigned int robot, double power, bool chip, bool autokick)
+{
+    assert(robot < 8);
+    IngressCommand cmd;
+    cmd.type     = IngressCommand::Type::CHICKER;
+    cmd.robot    = static_cast<uint8_t>(robot);
+    cmd.power    = power;
+    cmd.chip     = chip;
+    cmd.autokick = autokick;
+    return post_command(cmd);
+}
+
+bool MRFDongle::post_message(
+    unsigned int robot, unsigned int tries, const void *data, std::size_t len)
+{
+    assert(robot < 8);
+    assert(tries <= 256);
+    if (len > MAX_POSTED_MESSAGE_LENGTH)
+    {
+        throw std::length_error("Posted message too long");
+    }
+    IngressCommand cmd;
+    cmd.type   = IngressCommand::Type::MESSAGE;
+    cmd.robot  = static_cast<uint8_t>(robot);
+    cmd.tries  = tries;
+    cmd.length = static_cast<uint8_t>(len);
+    std::memcpy(cmd.data, data, len);
+    return post_command(cmd);
+}
+
+bool MRFDongle::post_command(IngressCommand &cmd)
+{
+    cmd.enqueued = std::chrono::steady_clock::now();
+    if (!ingress_queue.push(std::move(cmd)))
+    {
+        ingress_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Only the first command since the main loop last woke up needs to write
+    // the eventfd; the rest will be picked up by the same drain. This and the
+    // clear in handle_ingress_event are each a store followed by a load of
+    // the other side's data, so both must be sequentially consistent.
+    if (!ingress_wake_pending.exchange(true, std::memory_order_seq_cst))
+    {
+        uint64_t one = 1;
+        if (write(ingress_event.fd(), &one, sizeof(one)) < 0 &&
+            errno != EAGAIN)
+        {
+            throw SystemError("write", errno);
+        }
+    }
+    return true;
+}
+
+bool MRFDongle::handle_ingress_event(Glib::IOCondition)
+{
+    uint64_t count;
+    if (read(ingress_event.fd(), &count, sizeof(count)) < 0 &&
+        errno != EAGAIN)
+    {
+        throw SystemError("read", errno);
+    }
+
+    // Clear the flag before draining so that a command pushed after the last
+    // pop below always causes another wakeup. A release store could become
+    // visible after the queue is checked, letting a producer see the flag
+    // still set while the drain sees its command missing.
+    ingress_wake_pending.exchange(false, std::memory_order_seq_cst);
+    ingress_peak_depth_ = std::max(ingress_peak_depth_, ingress_queue.size());
+
+    IngressCommand cmd;
+    while (ingress_queue.pop(cmd))
+    {
+        if (cmd.type != IngressCommand::Type::PRIMITIVE)
+        {
+            // Primitives posted before this command must be sent first, so
+            // that, for example, a movement followed by a kick is not
+            // reordered.
+            flush_ingress_prims();
+        }
+
+        switch (cmd.type)
+        {
+            case IngressCommand::Type::PRIMITIVE:
+                ingress_prims.emplace_back(cmd.robot, cmd.primitive);
+                ingress_prim_stamps.push_back(cmd.enqueued);
+                continue;
+
+            case IngressCommand::Type::CAMERA:
+            {
+                int8_t camera_packet[55];
+                std::memcpy(camera_packet, cmd.data, sizeof(camera_packet));
+                submit_camera_packet(camera_packet);
+                break;
+            }
+
+            case IngressCommand::Type::CHICKER:
+                if (cmd.autokick)
+                {
+                    robot(cmd.robot).direct_chicker_auto(cmd.power, cmd.chip);
+                }
+                else
+                {
+                    robot(cmd.robot).direct_chicker(cmd.power, cmd.chip);
+                }
+                break;
+
+            case IngressCommand::Type::MESSAGE:
+            {
+                auto i = posted_messages.insert(
+                    posted_messages.end(),
+                    std::unique_ptr<SendReliableMessageOperation>(
+                        new SendReliableMessageOperation(
+                            *this, cmd.robot, cmd.tries, cmd.data,
+                            cmd.length)));
+                (*i)->signal_done.connect(sigc::bind(
+                    sigc::mem_fun(this, &MRFDongle::check_posted_message), i));
+                break;
+            }
+        }
+        ingress_latency_.record(
+            std::chrono::steady_clock::now() - cmd.enqueued);
+    }
+
+    // Send every primitive drained since the last other command as one
+    // batch.
+    flush_ingress_prims();
+    return true;
+}
+
+void MRFDongle::flush_ingress_prims()
+{
+    if (ingress_prims.empty())
+    {
+        return;
+    }
+    send_prims(ingress_prims);
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    for (std::chrono::steady_clock::time_point stamp : ingress_prim_stamps)
+    {
+        ingress_latency_.record(now - stamp);
+    }
+    ingress_prims.clear();
+    ingress_prim_stamps.clear();
+}
+
+void MRFDongle::check_posted_message(
+    AsyncOperation<void> &,
+    std::list<std::unique_ptr<SendReliableMessageOperation>>::iterator iter)
+{
+    try
+    {
+        (*iter)->result();
+    }
+    catch (const std::exception &exp)
+    {
+        LOG_ERROR(Glib::ustring::compose(
+            u8"Posted message failed: %1", exp.what()));
+    }
+    posted_messages.erase(iter);
+}
+
+void MRFDongle::set_command_deadline(
+    unsigned int robot, std::chrono::milliseconds deadline, bool brake)
+{
+    assert(robot < 8);
+    CommandWatchdog &wd = watchdogs[robot];
+    wd.deadline         = deadline;
+    wd.refreshed        = std::chrono::steady_clock::now();
+    wd.brake            = brake;
+
+    // Only tick while at least one robot has a deadline.
+    bool armed = std::any_of(
+        watchdogs, watchdogs + sizeof(watchdogs) / sizeof(*watchdogs),
+        [](const CommandWatchdog &i) {
+            return i.deadline != std::chrono::steady_clock::duration::zero();
+        });
+    if (!armed)
+    {
+        watchdog_connection.disconnect();
+    }
+    else if (!watchdog_connection.connected())
+    {
+        watchdog_connection = Glib::signal_timeout().connect(
+            sigc::mem_fun(this, &MRFDongle::handle_watchdog_tick),
+            WATCHDOG_TICK_MS);
+    }
+}
+
+void MRFDongle::arm_default_command_deadlines()
+{
+    // An explicit MRF_WATCHDOG, including zero, was already applied by the
+    // constructor and takes precedence.
+    if (std::getenv("MRF_WATCHDOG"))
+    {
+        return;
+    }
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        set_command_deadline(i, DEFAULT_COMMAND_DEADLINE);
+    }
+}
+
+void MRFDongle::refresh_command_deadline(unsigned int robot)
+{
+    CommandWatchdog &wd = watchdogs[robot];
+    wd.refreshed        = std::chrono::steady_clock::now();
+    wd.tripped          = false;
+}
+
+bool MRFDongle::handle_watchdog_tick()
+{
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i != sizeof(watchdogs) / sizeof(*watchdogs); ++i)
+    {
+        CommandWatchdog &wd = watchdogs[i];
+        MRFRobot &bot       = *robots[i];
+        if (wd.deadline == std::chrono::steady_clock::duration::zero() ||
+            wd.tripped || bot.direct_control ||
+            bot.primitive.get() == Drive::Primitive::STOP ||
+            now - wd.refreshed < wd.deadline)
+        {
+            continue;
+        }
+
+        // Bypass MRFRobot::send_prim so the stop does not count as a fresh
+        // command.
+        Drive::LLPrimitive stop =
+            wd.brake ? Drive::move_brake() : Drive::move_coast();
+        bot.primitive = stop.prim;
+        bot.params    = stop.params;
+        bot.extra     = stop.extra;
+        bot.dirty_drive();
+        wd.tripped = true;
+        ++wd.trips;
+        ++watchdog_trips_;
+        LOG_WARN(Glib::ustring::compose(
+            u8"Bot %1 command watchdog tripped after %2 ms without a "
+            u8"primitive",
+            i, std::chrono::duration_cast<std::chrono::milliseconds>(
+                   now - wd.refreshed)
+                   .count()));
+    }
+    return true;
+}
+
 bool MRFDongle::submit_drive_transfer()
 {
     if (!drive_transfer)
@@ -623,6 +1060,12 @@ bool MRFDongle::submit_drive_transfer()
             drive_transfer->signal_done.connect(
                 sigc::mem_fun(this, &MRFDongle::handle_drive_transfer_done));
             drive_transfer->submit();
+            {
+                std::lock_guard<std::mutex> lock(airtime_mtx);
+                airtime_.submitted(
+                    MRFAirtimeScheduler::Class::DRIVE, length,
+                    std::chrono::steady_clock::now());
+            }
             if (logger)
             {
                 logger->log_mrf_drive(drive_packet, length);
@@ -635,6 +1078,10 @@ bool MRFDongle::submit_drive_transfer()
 void MRFDongle::handle_drive_transfer_done(AsyncOperation<void> &op)
 {
     // std::cout << "Drive Transfer done" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(airtime_mtx);
+        airtime_.completed(MRFAirtimeScheduler::Class::DRIVE);
+    }
     op.result();
     drive_transfer.reset();
     if (std::find_if(
@@ -662,17 +1109,20 @@ void MRFDongle::handle_camera_transfer_done(
     uint64_t stamp = static_cast<uint64_t>(micros.count());
 
     std::lock_guard<std::mutex> lock(cam_mtx);
+    {
+        std::lock_guard<std::mutex> airtime_lock(airtime_mtx);
+        airtime_.completed(MRFAirtimeScheduler::Class::CAMERA);
+    }
     // std::cout << "Camera transfer done, took: " << stamp - (*iter).second <<
     // " microseconds" << std::endl;
     (*iter).first->result();
     camera_transfers.erase(iter);
 }
 void MRFDongle::send_unreliable(
-    unsigned int robot, unsigned int tries, const void *data, std::size_t len)
+    unsigned int robot, unsigned int kind, const void *data, std::size_t len)
 {
-    std::cout << "sending unreliable packet" << std::endl;
     assert(robot < 8);
-    assert((1 <= tries) && (tries <= 256));
+    unsigned int tries = retry_policy_.tries(robot);
     if (logger)
     {
         logger->log_mrf_message_out(robot, false, 0, data, len);
@@ -683,20 +1133,235 @@ void MRFDongle::send_unreliable(
     std::memcpy(buffer + 2, data, len);
     std::unique_ptr<USB::BulkOutTransfer> elt(
         new USB::BulkOutTransfer(device, 3, buffer, sizeof(buffer), 64, 0));
-    auto i =
-        unreliable_messages.insert(unreliable_messages.end(), std::move(elt));
-    (*i)->signal_done.connect(sigc::bind(
+
+    // Only the latest message of a kind matters, so if an older one is still
+    // waiting for airtime, send this one in its place.
+    for (auto i = unreliable_messages.begin(); i != unreliable_messages.end();
+         ++i)
+    {
+        if (i->robot == robot && i->kind == kind &&
+            replace_queued_message(*i->transfer, *elt, sizeof(buffer)))
+        {
+            elt->signal_done.connect(sigc::bind(
+                sigc::mem_fun(this, &MRFDongle::check_unreliable_transfer),
+                i));
+            i->transfer = std::move(elt);
+            ++unreliable_coalesced_;
+            return;
+        }
+    }
+
+    auto i = unreliable_messages.insert(
+        unreliable_messages.end(),
+        UnreliableMessage{std::move(elt), robot, kind});
+    schedule_message(*i->transfer, robot, sizeof(buffer));
+    i->transfer->signal_done.connect(sigc::bind(
         sigc::mem_fun(this, &MRFDongle::check_unreliable_transfer), i));
-    (*i)->submit();
 }
 
 void MRFDongle::check_unreliable_transfer(
-    AsyncOperation<void> &,
-    std::list<std::unique_ptr<USB::BulkOutTransfer>>::iterator iter)
+    AsyncOperation<void> &, std::list<UnreliableMessage>::iterator iter)
 {
-    (*iter)->result();
+    iter->transfer->result();
     unreliable_messages.erase(iter);
 }
+
+void MRFDongle::schedule_message(
+    USB::BulkOutTransfer &transfer, unsigned int robot, std::size_t length,
+    SendReliableMessageOperation *reliable)
+{
+    // Connect before the owner does, so the scheduler learns of completion
+    // before the owner has a chance to destroy the transfer.
+    transfer.signal_done.connect(sigc::bind(
+        sigc::mem_fun(this, &MRFDongle::handle_message_transfer_done),
+        &transfer));
+    queued_messages.push_back(
+        QueuedMessage{&transfer, robot, length, reliable});
+    pump_messages();
+}
+
+bool MRFDongle::replace_queued_message(
+    USB::BulkOutTransfer &old_transfer, USB::BulkOutTransfer &transfer,
+    std::size_t length)
+{
+    for (auto &i : queued_messages)
+    {
+        if (i.transfer == &old_transfer)
+        {
+            transfer.signal_done.connect(sigc::bind(
+                sigc::mem_fun(this, &MRFDongle::handle_message_transfer_done),
+                &transfer));
+            i.transfer = &transfer;
+            i.length   = length;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MRFDongle::forget_message(USB::BulkOutTransfer &transfer)
+{
+    auto queued = std::find_if(
+        queued_messages.begin(), queued_messages.end(),
+        [&transfer](const QueuedMessage &i) {
+            return i.transfer == &transfer;
+        });
+    if (queued != queued_messages.end())
+    {
+        queued_messages.erase(queued);
+        std::lock_guard<std::mutex> lock(airtime_mtx);
+        airtime_.set_queued(
+            MRFAirtimeScheduler::Class::MESSAGE, queued_messages.size());
+        return true;
+    }
+    auto in_flight = std::find(
+        in_flight_messages.begin(), in_flight_messages.end(), &transfer);
+    if (in_flight != in_flight_messages.end())
+    {
+        in_flight_messages.erase(in_flight);
+        std::lock_guard<std::mutex> lock(airtime_mtx);
+        airtime_.completed(MRFAirtimeScheduler::Class::MESSAGE);
+    }
+    return false;
+}
+
+std::size_t MRFDongle::gather_message_batch()
+{
+    // Take reliable messages for the front message’s robot, in queue order,
+    // while they fit in one frame alongside the batch type byte. Stop at the
+    // first one that does not fit, or at an unreliable message for the same
+    // robot, so that no robot sees its messages reordered.
+    message_batch.clear();
+    const QueuedMessage &front = queued_messages.front();
+    if (!batch_messages || !front.reliable)
+    {
+        return front.length;
+    }
+    std::size_t length = 4;
+    for (std::size_t i = 0; i != queued_messages.size(); ++i)
+    {
+        const QueuedMessage &qm = queued_messages[i];
+        if (qm.robot != front.robot)
+        {
+            continue;
+        }
+        if (!qm.reliable ||
+            length + 1 + qm.reliable->payload.size() > MESSAGE_TRANSFER_MAX)
+        {
+            break;
+        }
+        length += 1 + qm.reliable->payload.size();
+        message_batch.push_back(i);
+    }
+    return message_batch.size() > 1 ? length : front.length;
+}
+
+void MRFDongle::submit_message_batch(
+    std::size_t length, std::chrono::steady_clock::time_point now)
+{
+    SendReliableMessageOperation &leader =
+        *queued_messages[message_batch.front()].reliable;
+    uint8_t buffer[MESSAGE_TRANSFER_MAX];
+    buffer[0] = static_cast<uint8_t>(leader.robot | 0x10);
+    buffer[1] = leader.message_id;
+    buffer[3] = MRF::MESSAGE_TYPE_BATCH;
+
+    std::size_t pos    = 4;
+    unsigned int tries = 0;
+    for (std::size_t i : message_batch)
+    {
+        const SendReliableMessageOperation &op = *queued_messages[i].reliable;
+        tries         = std::max(tries, op.tries);
+        buffer[pos++] = static_cast<uint8_t>(op.payload.size());
+        std::copy(op.payload.begin(), op.payload.end(), buffer + pos);
+        pos += op.payload.size();
+    }
+    assert(pos == length);
+    buffer[2] = static_cast<uint8_t>(tries & 0xFF);
+
+    // The whole frame is acknowledged by one delivery report under the
+    // leader’s message ID, which completes every member.
+    std::shared_ptr<USB::BulkOutTransfer> frame =
+        std::make_shared<USB::BulkOutTransfer>(
+            device, 3, buffer, length, MESSAGE_TRANSFER_MAX, 0);
+    frame->signal_done.connect(sigc::bind(
+        sigc::mem_fun(this, &MRFDongle::handle_message_transfer_done),
+        frame.get()));
+    for (std::size_t i : message_batch)
+    {
+        queued_messages[i].reliable->join_batch(frame, leader.message_id);
+    }
+    for (auto i = message_batch.rbegin(), iend = message_batch.rend();
+         i != iend; ++i)
+    {
+        queued_messages.erase(
+            queued_messages.begin() + static_cast<std::ptrdiff_t>(*i));
+    }
+    in_flight_messages.push_back(frame.get());
+    frame->submit();
+    airtime_.submitted(MRFAirtimeScheduler::Class::MESSAGE, length, now);
+    message_frames_saved_ += message_batch.size() - 1;
+}
+
+void MRFDongle::pump_messages()
+{
+    std::lock_guard<std::mutex> lock(airtime_mtx);
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    while (!queued_messages.empty())
+    {
+        std::size_t length = gather_message_batch();
+        if (!airtime_.admit_message(length, now))
+        {
+            break;
+        }
+        if (message_batch.size() > 1)
+        {
+            submit_message_batch(length, now);
+            continue;
+        }
+        USB::BulkOutTransfer *transfer = queued_messages.front().transfer;
+        queued_messages.pop_front();
+        in_flight_messages.push_back(transfer);
+        transfer->submit();
+        airtime_.submitted(MRFAirtimeScheduler::Class::MESSAGE, length, now);
+    }
+    airtime_.set_queued(
+        MRFAirtimeScheduler::Class::MESSAGE, queued_messages.size());
+
+    // If the budget is what holds the next message back, wake up when it has
+    // refilled; otherwise a completion or status report will pump again.
+    if (!queued_messages.empty() && !message_pump_connection.connected())
+    {
+        std::chrono::steady_clock::duration delay =
+            airtime_.message_delay(gather_message_batch(), now);
+        if (delay != std::chrono::steady_clock::duration::max())
+        {
+            unsigned int ms = static_cast<unsigned int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(delay)
+                    .count() +
+                1);
+            message_pump_connection = Glib::signal_timeout().connect(
+                sigc::mem_fun(this, &MRFDongle::handle_message_pump_timeout),
+                ms);
+        }
+    }
+}
+
+bool MRFDongle::handle_message_pump_timeout()
+{
+    message_pump_connection.disconnect();
+    pump_messages();
+    return false;
+}
+
+void MRFDongle::handle_message_transfer_done(
+    AsyncOperation<void> &, USB::BulkOutTransfer *transfer)
+{
+    forget_message(*transfer);
+    pump_messages();
+}
+
 void MRFDongle::handle_beep_done(AsyncOperation<void> &)
 {
     beep_transfer->result();
@@ -7,25 +7,35 @@
  * \brief Provides access to an MRF24J40 dongle.
  */
 
+#include <glibmm/main.h>
 #include <sigc++/connection.h>
 #include <sigc++/signal.h>
 #include <sigc++/trackable.h>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <tuple>
 #include <utility>
 #include <vector>
 #include "drive/dongle.h"
 #include "geom/angle.h"
 #include "geom/point.h"
+#include "mrf/airtime_scheduler.h"
+#include "mrf/message_ids.h"
 #include "mrf/packet_logger.h"
+#include "mrf/retry_policy.h"
 #include "mrf/robot.h"
 #include "util/async_operation.h"
+#include "util/fd.h"
+#include "util/latency_histogram.h"
 #include "util/libusb.h"
+#include "util/mpsc_queue.h"
 #include "util/noncopyable.h"
 #include "util/property.h"
 
@@ -75,6 +85,20 @@ class MRFDongle final : public Drive::Dongle
         return *robots[i].get();
     }
 
+    /**
+     * \brief Sends movement primitives to several robots as one transaction.
+     *
+     * All the primitives are applied before any drive packet is built, and
+     * exactly one drive packet carrying all of them is then sent (or, if a
+     * drive packet is already in flight, queued to be sent as soon as it
+     * finishes).
+     *
+     * \param[in] prims the robot indices and the primitives to send to them
+     */
+    void send_prims(
+        const std::vector<std::pair<unsigned int, Drive::LLPrimitive>> &prims)
+        override;
+
     /**
      * \brief Generates an audible beep on the dongle.
      *
@@ -103,10 +127,383 @@ class MRFDongle final : public Drive::Dongle
         std::vector<std::tuple<uint8_t, Point, Angle>> robots, Point ball,
         uint64_t timestamp);
 
+    /**
+     * \name Cross-thread command ingress
+     *
+     * The functions in this group may be called from any thread. They never
+     * block or take locks; each one encodes its command into a fixed-size
+     * record and pushes it onto a lock-free queue, which the main loop drains
+     * when woken through an eventfd. Primitives drained in the same wakeup are
+     * sent as a single batch, as with send_prims.
+     *
+     * Commands posted from one thread are applied in the order they were
+     * posted: any primitives still waiting to be batched are passed to
+     * send_prims before a camera packet, chicker command or message is
+     * applied.
+     *
+     * Each function returns \c false, dropping the command, if the queue is
+     * full.
+     *
+     * \{
+     */
+
+    /**
+     * \brief Queues a movement primitive for a robot.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] prim the primitive to send
+     *
+     * \return \c true if the command was queued
+     */
+    bool post_prim(unsigned int robot, const Drive::LLPrimitive &prim);
+
+    /**
+     * \brief Queues a camera packet.
+     *
+     * \param[in] robots the detected robots’ indices, positions and
+     * orientations
+     *
+     * \param[in] ball the ball position
+     *
+     * \param[in] timestamp the camera timestamp
+     *
+     * \return \c true if the command was queued
+     */
+    bool post_camera_packet(
+        std::vector<std::tuple<uint8_t, Point, Angle>> robots, Point ball,
+        uint64_t timestamp);
+
+    /**
+     * \brief Queues a chicker command for a robot.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] power the power level, as for Drive::Robot::direct_chicker
+     *
+     * \param[in] chip \c true to chip or \c false to kick
+     *
+     * \param[in] autokick \c true to arm autokick, as for
+     * Drive::Robot::direct_chicker_auto, or \c false to fire immediately
+     *
+     * \return \c true if the command was queued
+     */
+    bool post_chicker(
+        unsigned int robot, double power, bool chip, bool autokick);
+
+    /**
+     * \brief Queues a reliable message for a robot.
+     *
+     * The outcome of the message is logged rather than reported to the caller.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] tries the number of times to try sending the message, or
+     * SendReliableMessageOperation::ADAPTIVE_TRIES to let \ref retry_policy
+     * choose
+     *
+     * \param[in] data the message, which is copied before returning
+     *
+     * \param[in] len the length of the message, at most \ref
+     * MAX_POSTED_MESSAGE_LENGTH bytes
+     *
+     * \return \c true if the command was queued
+     */
+    bool post_message(
+        unsigned int robot, unsigned int tries, const void *data,
+        std::size_t len);
+
+    /**
+     * \brief The longest message that can be passed to post_message.
+     */
+    static constexpr std::size_t MAX_POSTED_MESSAGE_LENGTH = 61;
+
+    /**
+     * \}
+     */
+
+    /**
+     * \brief Returns the number of posted commands waiting to be applied.
+     *
+     * \return the queue depth
+     */
+    std::size_t ingress_depth() const
+    {
+        return ingress_queue.size();
+    }
+
+    /**
+     * \brief Returns the largest number of posted commands seen waiting at
+     * once.
+     *
+     * \return the peak queue depth
+     */
+    std::size_t ingress_peak_depth() const
+    {
+        return ingress_peak_depth_;
+    }
+
+    /**
+     * \brief Returns the number of posted commands dropped because the queue
+     * was full.
+     *
+     * \return the drop count
+     */
+    uint64_t ingress_dropped() const
+    {
+        return ingress_dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Returns the time from posting each command to handing it to USB.
+     *
+     * This must only be called from the main loop thread.
+     *
+     * \return the latency histogram
+     */
+    const LatencyHistogram &ingress_latency() const
+    {
+        return ingress_latency_;
+    }
+
+    /**
+     * \brief Returns the USB context used to talk to the dongle.
+     *
+     * This is intended for inspecting event dispatch statistics.
+     *
+     * \return the context
+     */
+    const USB::Context &usb_context() const
+    {
+        return context;
+    }
+
+    /**
+     * \brief Returns the USB device handle used to talk to the dongle.
+     *
+     * This is intended for inspecting transfer statistics.
+     *
+     * \return the device handle
+     */
+    const USB::DeviceHandle &usb_device() const
+    {
+        return device;
+    }
+
+    /**
+     * \brief Returns the pool of transfers used to receive message delivery
+     * reports.
+     *
+     * \return the pool
+     */
+    const USB::BulkInTransferPool &mdr_transfer_pool() const
+    {
+        return mdr_transfers;
+    }
+
+    /**
+     * \brief Returns the pool of transfers used to receive messages from
+     * robots.
+     *
+     * \return the pool
+     */
+    const USB::BulkInTransferPool &message_transfer_pool() const
+    {
+        return message_transfers;
+    }
+
+    /**
+     * \brief Returns the scheduler that paces transfers by radio airtime.
+     *
+     * Drive and camera packets are submitted as soon as they are ready and
+     * charged against the airtime budget; messages wait on the host until
+     * the budget allows them and the dongle’s transmit queue has room.
+     *
+     * This must only be called from the main loop thread.
+     *
+     * \return the scheduler, from which per-class queue occupancy can be read
+     */
+    const MRFAirtimeScheduler &airtime() const
+    {
+        return airtime_;
+    }
+
+    /**
+     * \brief Returns the policy that chooses how many times to try sending
+     * each message to each robot.
+     *
+     * Unreliable messages always use the policy’s choice, as do reliable
+     * messages sent with SendReliableMessageOperation::ADAPTIVE_TRIES.
+     *
+     * \return the policy, from which per-robot choices and delivery counts can
+     * be read
+     */
+    const MRFRetryPolicy &retry_policy() const
+    {
+        return retry_policy_;
+    }
+
+    /**
+     * \brief Returns the number of unreliable messages that were never sent
+     * because a newer message of the same kind for the same robot replaced
+     * them while they waited for airtime.
+     *
+     * \return the count
+     */
+    uint64_t unreliable_coalesced() const
+    {
+        return unreliable_coalesced_;
+    }
+
+    /**
+     * \brief Returns the number of radio frames saved by packing reliable
+     * messages for the same robot into shared frames.
+     *
+     * Batching is only done if the \c MRF_BATCH_MESSAGES environment variable
+     * is set to a nonzero value, as the robots’ firmware must understand
+     * MRF::MESSAGE_TYPE_BATCH.
+     *
+     * \return the count
+     */
+    uint64_t message_frames_saved() const
+    {
+        return message_frames_saved_;
+    }
+
+    /**
+     * \brief Zeroes the USB transfer, command ingress, airtime, coalescing
+     * and batching statistics of the dongle.
+     */
+    void reset_usb_statistics()
+    {
+        device.reset_endpoint_statistics();
+        ingress_dropped_.store(0, std::memory_order_relaxed);
+        ingress_peak_depth_ = ingress_queue.size();
+        ingress_latency_.reset();
+        unreliable_coalesced_ = 0;
+        message_frames_saved_ = 0;
+        std::lock_guard<std::mutex> lock(airtime_mtx);
+        airtime_.reset_statistics();
+    }
+
+    /**
+     * \name Command watchdog
+     *
+     * Each robot may have a command deadline. If a robot that is not under
+     * direct control is running anything other than a stop primitive and
+     * receives no new primitive within its deadline, its primitive is replaced
+     * with Drive::move_brake or Drive::move_coast, which goes out in the next
+     * drive packet, and a trip is counted. The next primitive sent to the
+     * robot rearms the watchdog.
+     *
+     * Deadlines start at the value of the \c MRF_WATCHDOG environment
+     * variable, in milliseconds, or at zero (disabled) if it is unset. A
+     * caller that lets another process or a script drive the robots should
+     * call arm_default_command_deadlines, so that a client which stops
+     * sending does not leave robots running.
+     *
+     * \{
+     */
+
+    /**
+     * \brief Sets a robot’s command deadline.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] deadline how long a primitive may go unrefreshed, or zero to
+     * disable the watchdog for the robot
+     *
+     * \param[in] brake \c true to brake on a trip, or \c false to coast
+     */
+    void set_command_deadline(
+        unsigned int robot, std::chrono::milliseconds deadline,
+        bool brake = true);
+
+    /**
+     * \brief Sets every robot’s command deadline to \ref
+     * DEFAULT_COMMAND_DEADLINE, unless \c MRF_WATCHDOG is set.
+     */
+    void arm_default_command_deadlines();
+
+    /**
+     * \brief The command deadline set by arm_default_command_deadlines.
+     */
+    static const std::chrono::milliseconds DEFAULT_COMMAND_DEADLINE;
+
+    /**
+     * \brief Returns the number of times a robot’s watchdog has tripped.
+     *
+     * \param[in] robot the robot index
+     *
+     * \return the trip count
+     */
+    uint64_t watchdog_trips(unsigned int robot) const
+    {
+        assert(robot < 8);
+        return watchdogs[robot].trips;
+    }
+
+    /**
+     * \brief Returns the number of times any robot’s watchdog has tripped.
+     *
+     * \return the trip count
+     */
+    uint64_t watchdog_trips() const
+    {
+        return watchdog_trips_;
+    }
+
+    /**
+     * \}
+     */
+
    private:
     friend class MRFRobot;
     friend class SendReliableMessageOperation;
 
+    struct IngressCommand final
+    {
+        enum class Type
+        {
+            PRIMITIVE,
+            CAMERA,
+            CHICKER,
+            MESSAGE,
+        };
+
+        Type type;
+        uint8_t robot;
+        bool chip, autokick;
+        double power;
+        Drive::LLPrimitive primitive;
+        unsigned int tries;
+        uint8_t length;
+        uint8_t data[64];
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    struct UnreliableMessage final
+    {
+        std::unique_ptr<USB::BulkOutTransfer> transfer;
+        unsigned int robot, kind;
+    };
+
+    struct QueuedMessage final
+    {
+        USB::BulkOutTransfer *transfer;
+        unsigned int robot;
+        std::size_t length;
+        SendReliableMessageOperation *reliable;
+    };
+
+    struct CommandWatchdog final
+    {
+        std::chrono::steady_clock::duration deadline;
+        std::chrono::steady_clock::time_point refreshed;
+        bool brake, tripped;
+        uint64_t trips;
+    };
+
     std::mutex cam_mtx;
     MRFPacketLogger *logger;
     USB::Context context;
@@ -115,47 +512,91 @@ class MRFDongle final : public Drive::Dongle
     std::unique_ptr<USB::InterfaceClaimer> interface_claimer;
     uint8_t channel_;
     uint16_t pan_;
-    std::array<std::unique_ptr<USB::BulkInTransfer>, 32> mdr_transfers;
-    std::array<std::unique_ptr<USB::BulkInTransfer>, 32> message_transfers;
+    USB::BulkInTransferPool mdr_transfers, message_transfers;
     USB::InterruptInTransfer status_transfer;
     Annunciator::Message rx_fcs_fail_message, second_dongle_message,
         transmit_queue_full_message, receive_queue_full_message;
     std::unique_ptr<USB::BulkOutTransfer> drive_transfer;
     std::unique_ptr<USB::BulkOutTransfer> camera_transfer;
-    std::list<std::unique_ptr<USB::BulkOutTransfer>> unreliable_messages;
+    std::list<UnreliableMessage> unreliable_messages;
+    uint64_t unreliable_coalesced_;
     std::list<std::pair<std::unique_ptr<USB::BulkOutTransfer>, uint64_t>>
         camera_transfers;
     std::unique_ptr<MRFRobot> robots[8];
     uint8_t drive_packet[64];
     sigc::connection drive_submit_connection;
-    std::queue<uint8_t> free_message_ids;
+    bool drive_batch_active;
+    MPSCQueue<IngressCommand, 256> ingress_queue;
+    FileDescriptor ingress_event;
+    std::atomic<bool> ingress_wake_pending;
+    std::atomic<uint64_t> ingress_dropped_;
+    std::size_t ingress_peak_depth_;
+    LatencyHistogram ingress_latency_;
+    sigc::connection ingress_connection;
+    std::vector<std::pair<unsigned int, Drive::LLPrimitive>> ingress_prims;
+    std::vector<std::chrono::steady_clock::time_point> ingress_prim_stamps;
+    MRFMessageIDPool message_ids;
+    MRFRetryPolicy retry_policy_;
+    std::mutex airtime_mtx;
+    MRFAirtimeScheduler airtime_;
+    std::deque<QueuedMessage> queued_messages;
+    std::vector<USB::BulkOutTransfer *> in_flight_messages;
+    bool batch_messages;
+    std::vector<std::size_t> message_batch;
+    uint64_t message_frames_saved_;
+    sigc::connection message_pump_connection;
     sigc::signal<void, uint8_t, uint8_t> signal_message_delivery_report;
+    std::list<std::unique_ptr<SendReliableMessageOperation>> posted_messages;
     std::unique_ptr<USB::ControlNoDataTransfer> beep_transfer;
     unsigned int pending_beep_length;
     sigc::connection annunciator_beep_connections[2];
+    CommandWatchdog watchdogs[8];
+    uint64_t watchdog_trips_;
+    sigc::connection watchdog_connection;
 
-    uint8_t alloc_message_id();
-    void free_message_id(uint8_t id);
-    void handle_mdrs(AsyncOperation<void> &);
-    void handle_message(AsyncOperation<void> &, USB::BulkInTransfer &transfer);
+    void handle_mdrs(USB::BulkInTransfer &mdr_transfer);
+    void handle_message(USB::BulkInTransfer &transfer);
     void handle_status(AsyncOperation<void> &);
     void dirty_drive();
     bool submit_drive_transfer();
     void handle_drive_transfer_done(AsyncOperation<void> &);
+    void submit_camera_packet(const int8_t (&packet)[55]);
+    bool post_command(IngressCommand &cmd);
+    bool handle_ingress_event(Glib::IOCondition);
+    void flush_ingress_prims();
+    void check_posted_message(
+        AsyncOperation<void> &,
+        std::list<std::unique_ptr<SendReliableMessageOperation>>::iterator
+            iter);
     void handle_camera_transfer_done(
         AsyncOperation<void> &,
         std::list<std::pair<std::unique_ptr<USB::BulkOutTransfer>, uint64_t>>::
             iterator iter);
     void send_unreliable(
-        unsigned int robot, unsigned int tries, const void *data,
+        unsigned int robot, unsigned int kind, const void *data,
         std::size_t len);
     void check_unreliable_transfer(
-        AsyncOperation<void> &,
-        std::list<std::unique_ptr<USB::BulkOutTransfer>>::iterator iter);
+        AsyncOperation<void> &, std::list<UnreliableMessage>::iterator iter);
     void submit_beep();
     void handle_beep_done(AsyncOperation<void> &);
     void handle_annunciator_message_activated();
     void handle_annunciator_message_reactivated(std::size_t index);
+    void refresh_command_deadline(unsigned int robot);
+    void schedule_message(
+        USB::BulkOutTransfer &transfer, unsigned int robot, std::size_t length,
+        SendReliableMessageOperation *reliable = nullptr);
+    bool replace_queued_message(
+        USB::BulkOutTransfer &old_transfer, USB::BulkOutTransfer &transfer,
+        std::size_t length);
+    bool forget_message(USB::BulkOutTransfer &transfer);
+    std::size_t gather_message_batch();
+    void submit_message_batch(
+        std::size_t length, std::chrono::steady_clock::time_point now);
+    void pump_messages();
+    bool handle_message_pump_timeout();
+    void handle_message_transfer_done(
+        AsyncOperation<void> &, USB::BulkOutTransfer *transfer);
+    bool handle_watchdog_tick();
 };
 
 class MRFDongle::SendReliableMessageOperation final
@@ -181,12 +622,19 @@ class MRFDongle::SendReliableMessageOperation final
      */
     class ClearChannelError;
 
+    /**
+     * \brief A value for \p tries that lets the dongle’s retry policy choose
+     * the number of attempts from the robot’s link history.
+     */
+    static constexpr unsigned int ADAPTIVE_TRIES = 0;
+
     /**
      * \brief Queues a message for transmission.
      *
      * \param[in] dongle the dongle on which to send the message
      * \param[in] robot the robot index to which to send the message
-     * \param[in] tries the number of times to try sending the message
+     * \param[in] tries the number of times to try sending the message, or
+     * \ref ADAPTIVE_TRIES
      * \param[in] data the data to send (the data is copied into an internal
      * buffer)
      * \param[in] len the length of the data, including the header
@@ -195,6 +643,14 @@ class MRFDongle::SendReliableMessageOperation final
         MRFDongle &dongle, unsigned int robot, unsigned int tries,
         const void *data, std::size_t len);
 
+    /**
+     * \brief Abandons the message if it has not been sent yet.
+     *
+     * If the message was sent but its delivery report has not arrived, its
+     * ID is reclaimed when the report does.
+     */
+    ~SendReliableMessageOperation();
+
     /**
      * \brief Checks for the success of the operation.
      *
@@ -203,11 +659,18 @@ class MRFDongle::SendReliableMessageOperation final
     void result() const override;
 
    private:
+    friend class MRFDongle;
+
     MRFDongle &dongle;
-    uint8_t message_id, delivery_status;
+    unsigned int robot, tries;
+    uint8_t message_id, delivery_id, delivery_status;
+    std::vector<uint8_t> payload;
     std::unique_ptr<USB::BulkOutTransfer> transfer;
+    std::shared_ptr<USB::BulkOutTransfer> batch;
     sigc::connection mdr_connection;
 
+    void join_batch(
+        const std::shared_ptr<USB::BulkOutTransfer> &frame, uint8_t id);
     void out_transfer_done(AsyncOperation<void> &);
     void message_delivery_report(uint8_t id, uint8_t code);
 };
@@ -0,0 +1,73 @@
+#include "mrf/message_ids.h"
+#include <cassert>
+#include <stdexcept>
+
+constexpr std::size_t MRFMessageIDPool::SIZE;
+const std::chrono::steady_clock::duration MRFMessageIDPool::ABANDON_TIMEOUT =
+    std::chrono::seconds(5);
+
+MRFMessageIDPool::MRFMessageIDPool()
+    : abandoned_ids(), abandon_times(), num_abandoned(0)
+{
+    for (std::size_t i = 0; i != SIZE; ++i)
+    {
+        free_ids.push(static_cast<uint8_t>(i));
+    }
+}
+
+uint8_t MRFMessageIDPool::alloc(std::chrono::steady_clock::time_point now)
+{
+    expire(now);
+    if (free_ids.empty())
+    {
+        throw std::runtime_error("Out of reliable message IDs");
+    }
+    uint8_t id = free_ids.front();
+    free_ids.pop();
+    return id;
+}
+
+void MRFMessageIDPool::free(uint8_t id)
+{
+    assert(!abandoned_ids[id]);
+    free_ids.push(id);
+}
+
+void MRFMessageIDPool::abandon(
+    uint8_t id, std::chrono::steady_clock::time_point now)
+{
+    assert(!abandoned_ids[id]);
+    abandoned_ids[id] = true;
+    abandon_times[id] = now;
+    abandon_order.emplace(id, now);
+    ++num_abandoned;
+}
+
+void MRFMessageIDPool::report(uint8_t id)
+{
+    if (abandoned_ids[id])
+    {
+        abandoned_ids[id] = false;
+        --num_abandoned;
+        free_ids.push(id);
+    }
+}
+
+void MRFMessageIDPool::expire(std::chrono::steady_clock::time_point now)
+{
+    while (!abandon_order.empty() &&
+           now - abandon_order.front().second >= ABANDON_TIMEOUT)
+    {
+        // Skip entries for IDs whose report has already come in, including
+        // any that have since been reused and abandoned again.
+        uint8_t id = abandon_order.front().first;
+        if (abandoned_ids[id] &&
+            abandon_times[id] == abandon_order.front().second)
+        {
+            abandoned_ids[id] = false;
+            --num_abandoned;
+            free_ids.push(id);
+        }
+        abandon_order.pop();
+    }
+}
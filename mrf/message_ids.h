@@ -0,0 +1,123 @@
+#ifndef MRF_MESSAGE_IDS_H
+#define MRF_MESSAGE_IDS_H
+
+/**
+ * \file
+ *
+ * \brief Provides allocation of reliable message IDs.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include "util/noncopyable.h"
+
+/**
+ * \brief Hands out the IDs that tag reliable messages and their delivery
+ * reports.
+ *
+ * An ID must not be reused while a delivery report for it may still arrive,
+ * or the report would be taken as the new message’s. A message whose sender
+ * stops waiting before its report arrives therefore abandons its ID rather
+ * than freeing it, and the ID returns to the pool when the late report comes
+ * in. A report may never come, for example if the message’s transfer was
+ * cancelled before it reached the dongle, so an abandoned ID is also returned
+ * to the pool once \ref ABANDON_TIMEOUT has passed.
+ */
+class MRFMessageIDPool final : public NonCopyable
+{
+   public:
+    /**
+     * \brief The number of distinct IDs.
+     */
+    static constexpr std::size_t SIZE = 256;
+
+    /**
+     * \brief How long an abandoned ID waits for its delivery report before it
+     * is reused anyway.
+     *
+     * This is far longer than the dongle takes to report on even the most
+     * retried message.
+     */
+    static const std::chrono::steady_clock::duration ABANDON_TIMEOUT;
+
+    /**
+     * \brief Constructs a pool with every ID available.
+     */
+    explicit MRFMessageIDPool();
+
+    /**
+     * \brief Takes an ID from the pool.
+     *
+     * \param[in] now the current time, used to reclaim abandoned IDs that have
+     * timed out
+     *
+     * \return the ID
+     *
+     * \exception std::runtime_error if every ID is in use
+     */
+    uint8_t alloc(
+        std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now());
+
+    /**
+     * \brief Returns an ID to the pool.
+     *
+     * \param[in] id an ID that has no delivery report outstanding
+     */
+    void free(uint8_t id);
+
+    /**
+     * \brief Gives up on an ID whose delivery report is still outstanding.
+     *
+     * \param[in] id the ID, which returns to the pool when report is called
+     * for it or after \ref ABANDON_TIMEOUT
+     *
+     * \param[in] now the current time
+     */
+    void abandon(
+        uint8_t id, std::chrono::steady_clock::time_point now =
+                        std::chrono::steady_clock::now());
+
+    /**
+     * \brief Notes that a delivery report has arrived.
+     *
+     * \param[in] id the ID in the report
+     */
+    void report(uint8_t id);
+
+    /**
+     * \brief Returns the number of IDs that can be allocated.
+     *
+     * \return the number of free IDs
+     */
+    std::size_t available() const
+    {
+        return free_ids.size();
+    }
+
+    /**
+     * \brief Returns the number of IDs waiting for a late delivery report.
+     *
+     * \return the number of abandoned IDs
+     */
+    std::size_t abandoned() const
+    {
+        return num_abandoned;
+    }
+
+   private:
+    std::queue<uint8_t> free_ids;
+    std::array<bool, SIZE> abandoned_ids;
+    std::array<std::chrono::steady_clock::time_point, SIZE> abandon_times;
+    std::queue<std::pair<uint8_t, std::chrono::steady_clock::time_point>>
+        abandon_order;
+    std::size_t num_abandoned;
+
+    void expire(std::chrono::steady_clock::time_point now);
+};
+
+#endif
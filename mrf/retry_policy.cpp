@@ -0,0 +1,136 @@
+#include "mrf/retry_policy.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "mrf/constants.h"
+
+constexpr unsigned int MRFRetryPolicy::NUM_ROBOTS;
+constexpr unsigned int MRFRetryPolicy::MIN_TRIES;
+constexpr unsigned int MRFRetryPolicy::MAX_TRIES;
+constexpr double MRFRetryPolicy::TARGET_DELIVERY;
+
+namespace
+{
+/**
+ * \brief The weights given to the newest sample in the link and failure
+ * moving averages.
+ */
+const double LINK_ALPHA = 0.1, FAILURE_ALPHA = 0.2;
+
+/**
+ * \brief The link quality indicator values at which a single attempt is taken
+ * to be hopeless and nearly certain, respectively.
+ */
+const double LQI_FLOOR = 40.0, LQI_GOOD = 220.0;
+
+/**
+ * \brief The raw received signal strength values at which a single attempt is
+ * taken to be hopeless and nearly certain, respectively.
+ *
+ * These are roughly −87 dBm and −68 dBm.
+ */
+const double RSSI_FLOOR = 5.0, RSSI_GOOD = 100.0;
+
+/**
+ * \brief The bounds on the estimated chance of one attempt being delivered.
+ */
+const double ATTEMPT_SUCCESS_MIN = 0.05, ATTEMPT_SUCCESS_MAX = 0.99;
+
+/**
+ * \brief How much the attempt count is scaled up at a failure rate of one.
+ */
+const double FAILURE_GAIN = 4.0;
+
+double ramp(double x, double floor, double good)
+{
+    return std::min(1.0, std::max(0.0, (x - floor) / (good - floor)));
+}
+}
+
+MRFRetryPolicy::MRFRetryPolicy()
+{
+    for (Report &i : robots)
+    {
+        i.tries            = MAX_TRIES;
+        i.attempt_success  = ATTEMPT_SUCCESS_MIN;
+        i.failure_rate     = 0.0;
+        i.delivered        = 0;
+        i.not_acknowledged = 0;
+        i.no_clear_channel = 0;
+    }
+    for (LinkHistory &i : links)
+    {
+        i.heard = false;
+        i.lqi   = 0.0;
+        i.rssi  = 0.0;
+    }
+}
+
+void MRFRetryPolicy::record_link(unsigned int robot, uint8_t lqi, uint8_t rssi)
+{
+    assert(robot < NUM_ROBOTS);
+    LinkHistory &link = links[robot];
+    if (link.heard)
+    {
+        link.lqi += LINK_ALPHA * (lqi - link.lqi);
+        link.rssi += LINK_ALPHA * (rssi - link.rssi);
+    }
+    else
+    {
+        link.heard = true;
+        link.lqi   = lqi;
+        link.rssi  = rssi;
+    }
+    update(robot);
+}
+
+void MRFRetryPolicy::record_delivery(unsigned int robot, uint8_t status)
+{
+    assert(robot < NUM_ROBOTS);
+    Report &r = robots[robot];
+    switch (status)
+    {
+        case MRF::MDR_STATUS_OK:
+            ++r.delivered;
+            r.failure_rate -= FAILURE_ALPHA * r.failure_rate;
+            break;
+
+        case MRF::MDR_STATUS_NOT_ACKNOWLEDGED:
+            ++r.not_acknowledged;
+            r.failure_rate += FAILURE_ALPHA * (1.0 - r.failure_rate);
+            break;
+
+        case MRF::MDR_STATUS_NO_CLEAR_CHANNEL:
+            ++r.no_clear_channel;
+            return;
+
+        default:
+            return;
+    }
+    update(robot);
+}
+
+void MRFRetryPolicy::update(unsigned int robot)
+{
+    Report &r               = robots[robot];
+    const LinkHistory &link = links[robot];
+    if (!link.heard)
+    {
+        r.tries = MAX_TRIES;
+        return;
+    }
+
+    // A link is only as good as the weaker of its two indicators.
+    double p = std::min(
+        ramp(link.lqi, LQI_FLOOR, LQI_GOOD),
+        ramp(link.rssi, RSSI_FLOOR, RSSI_GOOD));
+    p = std::min(ATTEMPT_SUCCESS_MAX, std::max(ATTEMPT_SUCCESS_MIN, p));
+    r.attempt_success = p;
+
+    // Independent attempts: P(all n fail) = (1 − p)^n ≤ 1 − target.
+    double n = std::log(1.0 - TARGET_DELIVERY) / std::log(1.0 - p);
+    n *= 1.0 + FAILURE_GAIN * r.failure_rate;
+    r.tries = static_cast<unsigned int>(std::min(
+        static_cast<double>(MAX_TRIES),
+        std::max(static_cast<double>(MIN_TRIES), std::ceil(n))));
+}
@@ -0,0 +1,155 @@
+#ifndef MRF_RETRY_POLICY_H
+#define MRF_RETRY_POLICY_H
+
+/**
+ * \file
+ *
+ * \brief Provides per-robot radio retry counts derived from link history.
+ */
+
+#include <array>
+#include <cstdint>
+#include "util/noncopyable.h"
+
+/**
+ * \brief Chooses how many times the dongle should try to send each message to
+ * each robot.
+ *
+ * For each robot, the policy keeps moving averages of the link quality
+ * indicator and received signal strength of packets heard from the robot, and
+ * of the fraction of reliable messages that were not acknowledged. From the
+ * first two it estimates the chance that a single attempt is delivered, picks
+ * the number of attempts needed to deliver a message with probability \ref
+ * TARGET_DELIVERY, and scales that up while recent messages are going
+ * unacknowledged.
+ *
+ * Reports that no clear channel was found are counted but do not raise the
+ * retry count: retrying into a busy channel only adds to the congestion.
+ *
+ * Until anything has been heard from a robot, it gets \ref MAX_TRIES.
+ */
+class MRFRetryPolicy final : public NonCopyable
+{
+   public:
+    /**
+     * \brief The number of robots tracked.
+     */
+    static constexpr unsigned int NUM_ROBOTS = 8;
+
+    /**
+     * \brief The fewest attempts ever chosen.
+     */
+    static constexpr unsigned int MIN_TRIES = 2;
+
+    /**
+     * \brief The most attempts ever chosen.
+     */
+    static constexpr unsigned int MAX_TRIES = 20;
+
+    /**
+     * \brief The delivery probability the chosen attempt count aims for.
+     */
+    static constexpr double TARGET_DELIVERY = 0.999;
+
+    /**
+     * \brief The outcome counters and current choice for one robot.
+     */
+    struct Report final
+    {
+        /**
+         * \brief The number of attempts currently chosen.
+         */
+        unsigned int tries;
+
+        /**
+         * \brief The estimated chance that one attempt is delivered.
+         */
+        double attempt_success;
+
+        /**
+         * \brief The moving average of the fraction of reliable messages not
+         * acknowledged.
+         */
+        double failure_rate;
+
+        /**
+         * \brief The number of reliable messages delivered.
+         */
+        uint64_t delivered;
+
+        /**
+         * \brief The number of reliable messages not acknowledged after all
+         * attempts.
+         */
+        uint64_t not_acknowledged;
+
+        /**
+         * \brief The number of reliable messages dropped because no clear
+         * channel was found.
+         */
+        uint64_t no_clear_channel;
+    };
+
+    /**
+     * \brief Constructs a policy with no history.
+     */
+    explicit MRFRetryPolicy();
+
+    /**
+     * \brief Records the link quality of a packet received from a robot.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] lqi the link quality indicator reported by the dongle
+     *
+     * \param[in] rssi the raw received signal strength reported by the dongle
+     */
+    void record_link(unsigned int robot, uint8_t lqi, uint8_t rssi);
+
+    /**
+     * \brief Records the outcome of a reliable message.
+     *
+     * \param[in] robot the robot index
+     *
+     * \param[in] status the message delivery report status code
+     */
+    void record_delivery(unsigned int robot, uint8_t status);
+
+    /**
+     * \brief Returns the number of attempts to use for a message.
+     *
+     * \param[in] robot the robot index
+     *
+     * \return the attempt count, between \ref MIN_TRIES and \ref MAX_TRIES
+     */
+    unsigned int tries(unsigned int robot) const
+    {
+        return robots[robot].tries;
+    }
+
+    /**
+     * \brief Returns the state of the policy for a robot.
+     *
+     * \param[in] robot the robot index
+     *
+     * \return the report
+     */
+    const Report &report(unsigned int robot) const
+    {
+        return robots[robot];
+    }
+
+   private:
+    struct LinkHistory final
+    {
+        bool heard;
+        double lqi, rssi;
+    };
+
+    std::array<Report, NUM_ROBOTS> robots;
+    std::array<LinkHistory, NUM_ROBOTS> links;
+
+    void update(unsigned int robot);
+};
+
+#endif
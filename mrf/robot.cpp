@@ -30,6 +30,17 @@ const unsigned int REQUEST_BUILD_IDS_COUNT = 7;
  */
 const double REQUEST_BUILD_IDS_INTERVAL = 0.5;
 
+/**
+ * \brief The kinds of unreliable message, for coalescing by
+ * MRFDongle::send_unreliable.
+ *
+ * A tunable variable update’s kind also includes the variable index, so only
+ * updates to the same variable replace one another.
+ */
+const unsigned int UNRELIABLE_FIRE_CHICKER = 0x000, UNRELIABLE_AUTOKICK = 0x001,
+                   UNRELIABLE_REQUEST_BUILD_IDS = 0x002,
+                   UNRELIABLE_TUNABLE_VAR       = 0x100;
+
 struct RSSITableEntry final
 {
     int rssi;
@@ -133,16 +144,13 @@ void MRFRobot::set_charger_state(ChargerState state)
     dirty_drive();
 }
 
-void MRFRobot::send_prim(Drive::LLPrimitive p)
+void MRFRobot::send_prim(Drive::LLPrimitive &&p)
 {
     assert(!direct_control);
     primitive = p.prim;
-    for (std::size_t i = 0; i < Drive::LLPrimitive::PARAMS_MAX_SIZE; ++i)
-    {
-        params[i] = p.params[i];
-    }
-    extra = p.extra;
-    if(p.prim == Drive::Primitive::MOVE) /*extra = 1;*/printf("extra: %i", extra);
+    params    = p.params;
+    extra     = p.extra;
+    dongle_.refresh_command_deadline(index);
     dirty_drive();
 }
 
@@ -193,7 +201,8 @@ void MRFRobot::direct_chicker(double power, bool chip)
     buffer[2] = static_cast<uint8_t>(width);
     buffer[3] = static_cast<uint8_t>(width >> 8);
 
-    dongle_.send_unreliable(index, 20, buffer, sizeof(buffer));
+    dongle_.send_unreliable(
+        index, UNRELIABLE_FIRE_CHICKER, buffer, sizeof(buffer));
 }
 
 void MRFRobot::direct_chicker_auto(double power, bool chip)
@@ -208,14 +217,16 @@ void MRFRobot::direct_chicker_auto(double power, bool chip)
         buffer[1] = chip ? 0x01 : 0x00;
         buffer[2] = static_cast<uint8_t>(width);
         buffer[3] = static_cast<uint8_t>(width >> 8);
-        dongle_.send_unreliable(index, 20, buffer, sizeof(buffer));
+        dongle_.send_unreliable(
+            index, UNRELIABLE_AUTOKICK, buffer, sizeof(buffer));
     }
     else
     {
         uint8_t buffer[1];
         buffer[0] = 0x02;
 
-        dongle_.send_unreliable(index, 20, buffer, sizeof(buffer));
+        dongle_.send_unreliable(
+            index, UNRELIABLE_AUTOKICK, buffer, sizeof(buffer));
     }
 }
 
@@ -228,7 +239,8 @@ void MRFRobot::update_tunable_var(uint8_t var_index, uint8_t value)
     buffer[0] = 0x20;  // signifies message type is tuning constant update
     buffer[1] = var_index;
     buffer[2] = value;
-    dongle_.send_unreliable(index, 20, buffer, sizeof(buffer));
+    dongle_.send_unreliable(
+        index, UNRELIABLE_TUNABLE_VAR | var_index, buffer, sizeof(buffer));
 }
 
 constexpr unsigned int MRFRobot::SD_MESSAGE_COUNT;
@@ -253,7 +265,7 @@ MRFRobot::MRFRobot(MRFDongle &dongle, unsigned int index)
           Annunciator::Message::Severity::LOW),
       charger_state(ChargerState::FLOAT),
       slow(false),
-      params{0.0, 0.0, 0.0, 0.0},
+      params{{0.0, 0.0, 0.0, 0.0}},
       extra(0),
       drive_dirty(false),
       request_build_ids_counter(REQUEST_BUILD_IDS_COUNT)
@@ -320,7 +332,7 @@ void MRFRobot::encode_drive_packet(void *out)
     uint16_t words[4];
 
     // Encode the parameter words.
-    for (std::size_t i = 0; i != sizeof(params) / sizeof(*params); ++i)
+    for (std::size_t i = 0; i != params.size(); ++i)
     {
         double value = params[i];
         switch (std::fpclassify(value))
@@ -395,6 +407,9 @@ void MRFRobot::encode_drive_packet(void *out)
 void MRFRobot::handle_message(
     const void *data, std::size_t len, uint8_t lqi, uint8_t rssi)
 {
+    // Notify feedback listeners once for the whole packet.
+    PropertyTransaction transaction;
+
     link_quality = lqi / 255.0;
     {
         bool found = false;
@@ -484,6 +499,7 @@ void MRFRobot::handle_message(
                     --len;
 
                     bool has_error_extension = false;
+                    bool has_lps_extension   = false;
                     while (len)
                     {
                         // Decode extensions.
@@ -557,6 +573,7 @@ void MRFRobot::handle_message(
                                 --len;
                                 if (len >= 4)
                                 {
+                                    has_lps_extension = true;
                                     for (unsigned int i = 0; i < 4; ++i)
                                     {
                                         lps_values[i] =
@@ -584,6 +601,34 @@ void MRFRobot::handle_message(
                         }
                     }
 
+                    {
+                        using Field = Drive::TelemetryHistory::Field;
+                        Drive::TelemetryHistory::Values record =
+                            Drive::TelemetryHistory::empty_values();
+                        auto set = [&record](Field field, double value) {
+                            record[static_cast<std::size_t>(field)] =
+                                static_cast<float>(value);
+                        };
+                        set(Field::BATTERY_VOLTAGE, battery_voltage);
+                        set(Field::CAPACITOR_VOLTAGE, capacitor_voltage);
+                        set(Field::BREAK_BEAM_READING, break_beam_reading);
+                        set(Field::BOARD_TEMPERATURE, board_temperature);
+                        set(Field::DRIBBLER_TEMPERATURE, dribbler_temperature);
+                        set(Field::DRIBBLER_SPEED, dribbler_speed);
+                        set(Field::LINK_QUALITY, link_quality);
+                        set(Field::RECEIVED_SIGNAL_STRENGTH,
+                            received_signal_strength);
+                        if (has_lps_extension)
+                        {
+                            set(Field::LPS_0, lps_values[0]);
+                            set(Field::LPS_1, lps_values[1]);
+                            set(Field::LPS_2, lps_values[2]);
+                            set(Field::LPS_3, lps_values[3]);
+                        }
+                        telemetry.append(
+                            Drive::TelemetryHistory::Clock::now(), record);
+                    }
+
                     if (!has_error_extension)
                     {
                         // Error reporting extension is absent → no errors are
@@ -620,7 +665,8 @@ void MRFRobot::handle_message(
                     {
                         --request_build_ids_counter;
                         static const uint8_t REQUEST = 0x0D;
-                        dongle_.send_unreliable(index, 20, &REQUEST, 1);
+                        dongle_.send_unreliable(
+                            index, UNRELIABLE_REQUEST_BUILD_IDS, &REQUEST, 1);
                     }
                     else
                     {
@@ -28,7 +28,7 @@ class MRFRobot final : public Drive::Robot
     const Drive::Dongle &dongle() const override;
     void set_charger_state(ChargerState state) override;
 
-    void send_prim(Drive::LLPrimitive p) override;
+    void send_prim(Drive::LLPrimitive &&p) override;
 
     void move_slow(bool slow) override;
     void direct_wheels(const int (&wheels)[4]) override;
@@ -60,7 +60,7 @@ class MRFRobot final : public Drive::Robot
     sigc::connection feedback_timeout_connection;
     ChargerState charger_state;
     bool slow;
-    double params[Drive::LLPrimitive::PARAMS_MAX_SIZE];
+    Drive::LLPrimitive::Params params;
     uint8_t extra;
     bool drive_dirty;
     Glib::Timer request_build_ids_timer;
@@ -0,0 +1,166 @@
+#include "mrf/shm_bridge.h"
+#include <sigc++/bind.h>
+#include <sigc++/functors/mem_fun.h>
+#include <chrono>
+#include "mrf/dongle.h"
+#include "mrf/robot.h"
+
+namespace
+{
+/**
+ * \brief The number of times to try reading a slot before giving up until
+ * the next wakeup.
+ */
+const unsigned int MAX_LOAD_TRIES = 64;
+
+/**
+ * \brief Reads a slot, giving up if it stays mid-write.
+ *
+ * The writer is another process that may die during a write, leaving the
+ * sequence odd forever, so the main loop must not wait on it.
+ */
+template <typename T>
+bool bounded_load(const Seqlock<T> &slot, T &v)
+{
+    for (unsigned int i = 0; i != MAX_LOAD_TRIES; ++i)
+    {
+        if (slot.try_load(v))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+MRFShmBridge::MRFShmBridge(MRFDongle &dongle, MRFShmChannel &channel)
+    : dongle(dongle), channel(channel)
+{
+    MRFShmChannel::Layout &layout = channel.layout();
+    for (unsigned int i = 0; i != MRFShmChannel::NUM_ROBOTS; ++i)
+    {
+        primitive_generations[i] = layout.primitives[i].generation();
+    }
+    camera_generation = layout.camera.generation();
+    prims.reserve(MRFShmChannel::NUM_ROBOTS);
+    prim_stamps.reserve(MRFShmChannel::NUM_ROBOTS);
+    camera_robots.reserve(MRFShmChannel::NUM_ROBOTS);
+
+    io_connection = Glib::signal_io().connect(
+        sigc::mem_fun(this, &MRFShmBridge::handle_command),
+        channel.command_event_fd().fd(), Glib::IO_IN);
+    for (unsigned int i = 0; i != MRFShmChannel::NUM_ROBOTS; ++i)
+    {
+        feedback_connections.push_back(
+            dongle.robot(i).feedback.signal_changed().connect(sigc::bind(
+                sigc::mem_fun(this, &MRFShmBridge::publish_feedback), i)));
+        publish_feedback(i);
+    }
+}
+
+MRFShmBridge::~MRFShmBridge()
+{
+    io_connection.disconnect();
+    for (sigc::connection &i : feedback_connections)
+    {
+        i.disconnect();
+    }
+}
+
+bool MRFShmBridge::handle_command(Glib::IOCondition)
+{
+    channel.wait_command(0);
+    MRFShmChannel::Layout &layout = channel.layout();
+
+    // Collect every robot whose slot changed since the last wakeup.
+    prims.clear();
+    prim_stamps.clear();
+    for (unsigned int i = 0; i != MRFShmChannel::NUM_ROBOTS; ++i)
+    {
+        uint32_t generation = layout.primitives[i].generation();
+        if (generation == primitive_generations[i])
+        {
+            continue;
+        }
+        MRFShmChannel::Primitive slot;
+        if (!bounded_load(layout.primitives[i], slot))
+        {
+            continue;
+        }
+        primitive_generations[i] = generation;
+        if (!slot.valid ||
+            slot.primitive > static_cast<uint8_t>(Drive::Primitive::SPIN) ||
+            dongle.robot(i).direct_control)
+        {
+            continue;
+        }
+        Drive::LLPrimitive::Params params;
+        for (std::size_t j = 0; j != params.size(); ++j)
+        {
+            params[j] = slot.params[j];
+        }
+        prims.emplace_back(
+            i, Drive::LLPrimitive(
+                   static_cast<Drive::Primitive>(slot.primitive), params,
+                   slot.extra));
+        prim_stamps.push_back(slot.posted_ns);
+    }
+    if (!prims.empty())
+    {
+        dongle.send_prims(prims);
+        uint64_t now = MRFShmChannel::now_ns();
+        for (uint64_t stamp : prim_stamps)
+        {
+            latency_.record(std::chrono::nanoseconds(now - stamp));
+        }
+    }
+
+    uint32_t generation = layout.camera.generation();
+    MRFShmChannel::CameraFrame frame;
+    if (generation != camera_generation && bounded_load(layout.camera, frame))
+    {
+        camera_generation = generation;
+        camera_robots.clear();
+        for (unsigned int i = 0;
+             i != frame.count && i != MRFShmChannel::NUM_ROBOTS; ++i)
+        {
+            if (frame.robots[i].index < MRFShmChannel::NUM_ROBOTS)
+            {
+                camera_robots.emplace_back(
+                    frame.robots[i].index,
+                    Point(frame.robots[i].x, frame.robots[i].y),
+                    Angle::of_radians(frame.robots[i].orientation));
+            }
+        }
+        dongle.send_camera_packet(
+            camera_robots, Point(frame.ball_x, frame.ball_y), frame.timestamp);
+        latency_.record(std::chrono::nanoseconds(
+            MRFShmChannel::now_ns() - frame.posted_ns));
+    }
+    return true;
+}
+
+void MRFShmBridge::publish_feedback(unsigned int index)
+{
+    const MRFRobot &bot = dongle.robot(index);
+    MRFShmChannel::Feedback fb;
+    fb.flags = static_cast<uint8_t>(
+        (bot.alive ? 0x01 : 0) | (bot.ball_in_beam ? 0x02 : 0) |
+        (bot.capacitor_charged ? 0x04 : 0) | (bot.direct_control ? 0x08 : 0));
+    fb.primitive            = static_cast<uint8_t>(bot.primitive.get());
+    fb.battery_voltage      = static_cast<float>(bot.battery_voltage);
+    fb.capacitor_voltage    = static_cast<float>(bot.capacitor_voltage);
+    fb.break_beam_reading   = static_cast<float>(bot.break_beam_reading);
+    fb.board_temperature    = static_cast<float>(bot.board_temperature);
+    fb.dribbler_temperature = static_cast<float>(bot.dribbler_temperature);
+    fb.link_quality         = static_cast<float>(bot.link_quality);
+    for (std::size_t i = 0; i != bot.lps_values.size(); ++i)
+    {
+        fb.lps_values[i] = static_cast<float>(bot.lps_values[i]);
+    }
+    fb.dribbler_speed           = bot.dribbler_speed;
+    fb.received_signal_strength = bot.received_signal_strength;
+    fb.stamp_ns                 = MRFShmChannel::now_ns();
+    channel.layout().feedback[index].store(fb);
+    channel.notify_feedback();
+}
@@ -0,0 +1,73 @@
+#ifndef MRF_SHM_BRIDGE_H
+#define MRF_SHM_BRIDGE_H
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+#include <sigc++/trackable.h>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "drive/primitive.h"
+#include "geom/angle.h"
+#include "geom/point.h"
+#include "mrf/shm_channel.h"
+#include "util/latency_histogram.h"
+#include "util/noncopyable.h"
+
+class MRFDongle;
+
+/**
+ * \brief Connects an MRFShmChannel to a dongle in the radio process.
+ *
+ * When the command eventfd fires, every primitive slot written since the last
+ * wakeup is sent as one batch with MRFDongle::send_prims, and a new camera
+ * frame, if any, is passed to MRFDongle::send_camera_packet. Whenever a
+ * robot’s feedback changes, its feedback slot is rewritten and the feedback
+ * eventfd is signalled.
+ */
+class MRFShmBridge final : public NonCopyable, public sigc::trackable
+{
+   public:
+    /**
+     * \brief Starts bridging.
+     *
+     * \param[in] dongle the dongle to drive
+     *
+     * \param[in] channel the channel to serve, which must outlive the bridge
+     */
+    explicit MRFShmBridge(MRFDongle &dongle, MRFShmChannel &channel);
+
+    /**
+     * \brief Stops bridging.
+     */
+    ~MRFShmBridge();
+
+    /**
+     * \brief Returns the time from the AI writing each primitive or camera
+     * frame to submitting it to USB.
+     *
+     * \return the latency histogram
+     */
+    const LatencyHistogram &latency() const
+    {
+        return latency_;
+    }
+
+   private:
+    MRFDongle &dongle;
+    MRFShmChannel &channel;
+    uint32_t primitive_generations[MRFShmChannel::NUM_ROBOTS];
+    uint32_t camera_generation;
+    sigc::connection io_connection;
+    std::vector<sigc::connection> feedback_connections;
+    LatencyHistogram latency_;
+    std::vector<std::pair<unsigned int, Drive::LLPrimitive>> prims;
+    std::vector<uint64_t> prim_stamps;
+    std::vector<std::tuple<uint8_t, Point, Angle>> camera_robots;
+
+    bool handle_command(Glib::IOCondition);
+    void publish_feedback(unsigned int index);
+};
+
+#endif
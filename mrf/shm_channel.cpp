@@ -0,0 +1,144 @@
+#include "mrf/shm_channel.h"
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "util/exception.h"
+
+constexpr unsigned int MRFShmChannel::NUM_ROBOTS;
+
+namespace
+{
+const uint32_t MAGIC   = 0x4D524653U;  // “MRFS”
+const uint32_t VERSION = 1;
+
+FileDescriptor create_memory()
+{
+    int fd = memfd_create("mrf-shm", MFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        return FileDescriptor::create_from_fd(fd);
+    }
+    if (errno != ENOSYS)
+    {
+        throw SystemError("memfd_create", errno);
+    }
+    return FileDescriptor::create_temp("/tmp/mrf-shm-XXXXXX");
+}
+
+FileDescriptor create_event()
+{
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd < 0)
+    {
+        throw SystemError("eventfd", errno);
+    }
+    return FileDescriptor::create_from_fd(fd);
+}
+
+void signal_event(const FileDescriptor &fd)
+{
+    uint64_t one = 1;
+    if (write(fd.fd(), &one, sizeof(one)) < 0 && errno != EAGAIN)
+    {
+        throw SystemError("write", errno);
+    }
+}
+
+bool wait_event(const FileDescriptor &fd, int timeout_ms)
+{
+    for (;;)
+    {
+        uint64_t count;
+        if (read(fd.fd(), &count, sizeof(count)) >= 0)
+        {
+            return true;
+        }
+        if (errno != EAGAIN)
+        {
+            throw SystemError("read", errno);
+        }
+        pollfd pfd;
+        pfd.fd     = fd.fd();
+        pfd.events = POLLIN;
+        int rc     = poll(&pfd, 1, timeout_ms);
+        if (rc < 0 && errno != EINTR)
+        {
+            throw SystemError("poll", errno);
+        }
+        if (!rc)
+        {
+            return false;
+        }
+    }
+}
+}
+
+uint64_t MRFShmChannel::now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * UINT64_C(1000000000) +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+MRFShmChannel::MRFShmChannel()
+    : memory(create_memory()),
+      command_event(create_event()),
+      feedback_event(create_event())
+{
+    if (ftruncate(memory.fd(), sizeof(Layout)) < 0)
+    {
+        throw SystemError("ftruncate", errno);
+    }
+    mapping.reset(
+        new MappedFile(memory, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FILE));
+    layout_          = new (mapping->data()) Layout;
+    layout_->magic   = MAGIC;
+    layout_->version = VERSION;
+}
+
+MRFShmChannel::MRFShmChannel(
+    FileDescriptor &&memory, FileDescriptor &&command_event,
+    FileDescriptor &&feedback_event)
+    : memory(std::move(memory)),
+      command_event(std::move(command_event)),
+      feedback_event(std::move(feedback_event))
+{
+    mapping.reset(new MappedFile(
+        this->memory, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FILE));
+    if (mapping->size() < sizeof(Layout))
+    {
+        throw std::runtime_error("Shared memory channel too small");
+    }
+    layout_ = static_cast<Layout *>(mapping->data());
+    if (layout_->magic != MAGIC || layout_->version != VERSION)
+    {
+        throw std::runtime_error("Shared memory channel version mismatch");
+    }
+}
+
+void MRFShmChannel::notify_command()
+{
+    signal_event(command_event);
+}
+
+void MRFShmChannel::notify_feedback()
+{
+    signal_event(feedback_event);
+}
+
+bool MRFShmChannel::wait_command(int timeout_ms)
+{
+    return wait_event(command_event, timeout_ms);
+}
+
+bool MRFShmChannel::wait_feedback(int timeout_ms)
+{
+    return wait_event(feedback_event, timeout_ms);
+}
@@ -0,0 +1,271 @@
+#ifndef MRF_SHM_CHANNEL_H
+#define MRF_SHM_CHANNEL_H
+
+/**
+ * \file
+ *
+ * \brief Provides a shared-memory channel between an AI process and the radio
+ * process.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "util/fd.h"
+#include "util/mapped_file.h"
+#include "util/noncopyable.h"
+#include "util/seqlock.h"
+
+/**
+ * \brief A region of shared memory plus two eventfds through which an AI
+ * process and the radio process exchange commands and feedback.
+ *
+ * The region holds one \ref Seqlock per robot for the latest primitive, one
+ * for the latest camera frame, and one per robot for the latest feedback.
+ * Each slot has exactly one writer: the AI writes primitives and camera
+ * frames and then signals the command eventfd; the radio process writes
+ * feedback and then signals the feedback eventfd. Only the latest value in
+ * each slot matters, so a slow reader skips stale values instead of queueing
+ * them.
+ *
+ * Both processes hold the same descriptors; the radio process creates them
+ * and hands them to the AI over a Unix-domain socket (see \ref
+ * MRFControlServer). Timestamps are \c CLOCK_MONOTONIC nanoseconds, which are
+ * comparable between processes on one machine.
+ */
+class MRFShmChannel final : public NonCopyable
+{
+   public:
+    /**
+     * \brief The number of robot slots in each direction.
+     */
+    static constexpr unsigned int NUM_ROBOTS = 8;
+
+    /**
+     * \brief A movement primitive for one robot.
+     */
+    struct Primitive final
+    {
+        /**
+         * \brief Whether the slot holds a primitive at all.
+         */
+        uint8_t valid;
+
+        /**
+         * \brief The primitive code, as in Drive::Primitive.
+         */
+        uint8_t primitive;
+
+        /**
+         * \brief The extra field.
+         */
+        uint8_t extra;
+
+        /**
+         * \brief The parameters.
+         */
+        double params[4];
+
+        /**
+         * \brief When the AI wrote the slot.
+         */
+        uint64_t posted_ns;
+    };
+
+    /**
+     * \brief A camera frame.
+     */
+    struct CameraFrame final
+    {
+        /**
+         * \brief The number of valid entries in \ref robots.
+         */
+        uint8_t count;
+
+        /**
+         * \brief The detected robots.
+         */
+        struct
+        {
+            uint8_t index;
+            double x, y, orientation;
+        } robots[NUM_ROBOTS];
+
+        /**
+         * \brief The ball position.
+         */
+        double ball_x, ball_y;
+
+        /**
+         * \brief The camera timestamp, passed through to the robots.
+         */
+        uint64_t timestamp;
+
+        /**
+         * \brief When the AI wrote the slot.
+         */
+        uint64_t posted_ns;
+    };
+
+    /**
+     * \brief The latest feedback from one robot.
+     */
+    struct Feedback final
+    {
+        /**
+         * \brief Bit 0 alive, bit 1 ball in beam, bit 2 capacitor charged,
+         * bit 3 direct control.
+         */
+        uint8_t flags;
+
+        /**
+         * \brief The current primitive code.
+         */
+        uint8_t primitive;
+
+        /**
+         * \brief The analogue readings, in the units of the corresponding
+         * Drive::Robot properties.
+         */
+        float battery_voltage, capacitor_voltage, break_beam_reading,
+            board_temperature, dribbler_temperature, link_quality;
+
+        /**
+         * \brief The LPS values.
+         */
+        float lps_values[4];
+
+        /**
+         * \brief The dribbler speed, in RPM.
+         */
+        int32_t dribbler_speed;
+
+        /**
+         * \brief The received signal strength, in dB.
+         */
+        int32_t received_signal_strength;
+
+        /**
+         * \brief When the radio process wrote the slot.
+         */
+        uint64_t stamp_ns;
+    };
+
+    /**
+     * \brief The layout of the shared region.
+     */
+    struct Layout final
+    {
+        uint32_t magic, version;
+        Seqlock<Primitive> primitives[NUM_ROBOTS];
+        Seqlock<CameraFrame> camera;
+        Seqlock<Feedback> feedback[NUM_ROBOTS];
+    };
+
+    /**
+     * \brief Returns the current \c CLOCK_MONOTONIC time.
+     *
+     * \return the time, in nanoseconds
+     */
+    static uint64_t now_ns();
+
+    /**
+     * \brief Creates a new channel.
+     *
+     * The region is an anonymous memory file, or an unlinked temporary file
+     * if the kernel does not support those.
+     */
+    explicit MRFShmChannel();
+
+    /**
+     * \brief Attaches to a channel created by another process.
+     *
+     * \param[in] memory the shared memory file
+     *
+     * \param[in] command_event the eventfd signalled when commands are
+     * written
+     *
+     * \param[in] feedback_event the eventfd signalled when feedback is
+     * written
+     */
+    explicit MRFShmChannel(
+        FileDescriptor &&memory, FileDescriptor &&command_event,
+        FileDescriptor &&feedback_event);
+
+    /**
+     * \brief Returns the shared region.
+     *
+     * \return the region
+     */
+    Layout &layout()
+    {
+        return *layout_;
+    }
+
+    /**
+     * \brief Returns the shared memory file.
+     *
+     * \return the descriptor
+     */
+    const FileDescriptor &memory_fd() const
+    {
+        return memory;
+    }
+
+    /**
+     * \brief Returns the command eventfd.
+     *
+     * \return the descriptor
+     */
+    const FileDescriptor &command_event_fd() const
+    {
+        return command_event;
+    }
+
+    /**
+     * \brief Returns the feedback eventfd.
+     *
+     * \return the descriptor
+     */
+    const FileDescriptor &feedback_event_fd() const
+    {
+        return feedback_event;
+    }
+
+    /**
+     * \brief Wakes the radio process after writing commands.
+     */
+    void notify_command();
+
+    /**
+     * \brief Wakes the AI process after writing feedback.
+     */
+    void notify_feedback();
+
+    /**
+     * \brief Waits for the command eventfd and resets it.
+     *
+     * \param[in] timeout_ms how long to wait, in milliseconds, zero to poll,
+     * or negative to wait forever
+     *
+     * \return \c true if commands were signalled, or \c false on timeout
+     */
+    bool wait_command(int timeout_ms);
+
+    /**
+     * \brief Waits for the feedback eventfd and resets it.
+     *
+     * \param[in] timeout_ms how long to wait, in milliseconds, zero to poll,
+     * or negative to wait forever
+     *
+     * \return \c true if feedback was signalled, or \c false on timeout
+     */
+    bool wait_feedback(int timeout_ms);
+
+   private:
+    FileDescriptor memory, command_event, feedback_event;
+    std::unique_ptr<MappedFile> mapping;
+    Layout *layout_;
+};
+
+#endif
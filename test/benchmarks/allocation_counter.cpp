@@ -0,0 +1,45 @@
+#include "test/benchmarks/allocation_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> allocations(0);
+
+void *counted_allocate(std::size_t size)
+{
+    ++allocations;
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+}
+
+uint64_t AllocationCounter::count()
+{
+    return allocations.load();
+}
+
+void *operator new(std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return counted_allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
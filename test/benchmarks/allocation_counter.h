@@ -0,0 +1,22 @@
+#ifndef TEST_BENCHMARKS_ALLOCATION_COUNTER_H
+#define TEST_BENCHMARKS_ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * \brief Counts calls to the global allocation functions.
+ *
+ * Linking allocation_counter.cpp into a program replaces the global
+ * <code>operator new</code> family with versions that count their calls.
+ */
+namespace AllocationCounter
+{
+/**
+ * \brief Returns the number of allocations made so far by the program.
+ *
+ * \return the allocation count
+ */
+uint64_t count();
+}
+
+#endif
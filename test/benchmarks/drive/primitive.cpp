@@ -0,0 +1,86 @@
+#include "drive/primitive.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "test/benchmarks/allocation_counter.h"
+
+namespace
+{
+const unsigned int NUM_ROBOTS = 8;
+const unsigned int NUM_TICKS  = 100000;
+
+/**
+ * \brief Stands in for a robot, storing the primitive the same way
+ * MRFRobot::send_prim does.
+ */
+struct PrimitiveSink final
+{
+    Drive::Primitive primitive;
+    Drive::LLPrimitive::Params params;
+    uint8_t extra;
+
+    void send_prim(Drive::LLPrimitive &&p)
+    {
+        primitive = p.prim;
+        params    = p.params;
+        extra     = p.extra;
+    }
+};
+
+Drive::LLPrimitive build(unsigned int robot, unsigned int tick)
+{
+    Point dest(0.001 * tick, 0.002 * robot);
+    Angle orient = Angle::of_radians(0.01 * (tick + robot));
+    switch ((robot + tick) % 8)
+    {
+        case 0:
+            return Drive::move_move(dest, orient, 1.0);
+        case 1:
+            return Drive::move_move(dest, 0.5);
+        case 2:
+            return Drive::move_dribble(dest, orient, 3000.0, true);
+        case 3:
+            return Drive::move_shoot(dest, orient, 4.0, false);
+        case 4:
+            return Drive::move_shoot(dest, 2.0, true);
+        case 5:
+            return Drive::move_catch(1.0, 2000.0, 0.05);
+        case 6:
+            return Drive::move_pivot(dest, orient, orient);
+        default:
+            return Drive::move_spin(dest, orient);
+    }
+}
+
+TEST(PrimitiveBenchmark, zero_allocations_per_tick)
+{
+    PrimitiveSink robots[NUM_ROBOTS];
+
+    uint64_t allocations_before = AllocationCounter::count();
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int tick = 0; tick < NUM_TICKS; ++tick)
+    {
+        for (unsigned int robot = 0; robot < NUM_ROBOTS; ++robot)
+        {
+            robots[robot].send_prim(build(robot, tick));
+        }
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    uint64_t allocations = AllocationCounter::count() - allocations_before;
+
+    double ns_per_tick =
+        static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count()) /
+        NUM_TICKS;
+    std::cout << "[ BENCH    ] " << NUM_ROBOTS << " primitives per tick: "
+              << ns_per_tick << " ns/tick, "
+              << static_cast<double>(allocations) / NUM_TICKS
+              << " allocations/tick\n";
+
+    EXPECT_EQ(0U, allocations);
+}
+}
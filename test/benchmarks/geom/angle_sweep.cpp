@@ -0,0 +1,232 @@
+#include "geom/angle_sweep.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include "geom/util.h"
+#include "test/benchmarks/allocation_counter.h"
+
+using namespace Geom;
+
+namespace
+{
+const std::size_t NUM_OBSTACLES[] = {4, 12, 24};
+const unsigned int NUM_SOURCES    = 256;
+const unsigned int ROUNDS         = 200;
+
+/**
+ * \brief The best-window search as it was before \ref AngleSweep, kept as a
+ * baseline.
+ */
+std::pair<Point, Angle> legacy_angle_sweep_circles(
+    const Point &src, const Point &p1, const Point &p2,
+    const std::vector<Point> &obstacles, const double &radius)
+{
+    Point bestshot       = (p1 + p2) * 0.5;
+    const Angle offangle = (p1 - src).orientation();
+    if (collinear(src, p1, p2))
+    {
+        return std::make_pair(bestshot, Angle::zero());
+    }
+    std::vector<std::pair<Angle, int>> events;
+    events.reserve(2 * obstacles.size() + 2);
+    events.push_back(std::make_pair(Angle::zero(), 1));
+    events.push_back(
+        std::make_pair(((p2 - src).orientation() - offangle).angle_mod(), -1));
+    for (Point i : obstacles)
+    {
+        Point diff = i - src;
+        if (diff.len() < radius)
+        {
+            return std::make_pair(bestshot, Angle::zero());
+        }
+        const Angle cent   = (diff.orientation() - offangle).angle_mod();
+        const Angle span   = Angle::asin(radius / diff.len());
+        const Angle range1 = cent - span;
+        const Angle range2 = cent + span;
+        if (range1 < -Angle::half() || range2 > Angle::half())
+        {
+            continue;
+        }
+        events.push_back(std::make_pair(range1, -1));
+        events.push_back(std::make_pair(range2, 1));
+    }
+    std::sort(events.begin(), events.end());
+    Angle best  = Angle::zero();
+    Angle sum   = Angle::zero();
+    Angle start = events[0].first;
+    int cnt     = 0;
+    for (std::size_t i = 0; i + 1 < events.size(); ++i)
+    {
+        cnt += events[i].second;
+        if (cnt > 0)
+        {
+            sum += events[i + 1].first - events[i].first;
+            if (best < sum)
+            {
+                best              = sum;
+                const Angle mid   = start + sum / 2 + offangle;
+                const Point ray   = Point::of_angle(mid) * 10.0;
+                const Point inter = line_intersect(src, src + ray, p1, p2);
+                bestshot          = inter;
+            }
+        }
+        else
+        {
+            sum   = Angle::zero();
+            start = events[i + 1].first;
+        }
+    }
+    return std::make_pair(bestshot, best);
+}
+
+/**
+ * \brief Robot-sized obstacles and shooting positions on a field, with both
+ * goals and a pass receiver as targets.
+ */
+struct Scene final
+{
+    std::vector<Point> obstacles;
+    std::vector<Point> sources;
+    std::vector<Seg> targets;
+
+    explicit Scene(std::size_t n)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> x(-4.0, 4.0), y(-2.8, 2.8);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            obstacles.push_back(Point(x(rng), y(rng)));
+        }
+        while (sources.size() != NUM_SOURCES)
+        {
+            Point p(x(rng), y(rng));
+            bool clear = true;
+            for (const Point &i : obstacles)
+            {
+                clear = clear && (i - p).len() > 0.2;
+            }
+            if (clear)
+            {
+                sources.push_back(p);
+            }
+        }
+        targets.push_back(Seg(Point(4.5, -0.5), Point(4.5, 0.5)));
+        targets.push_back(Seg(Point(-4.5, 0.5), Point(-4.5, -0.5)));
+        targets.push_back(Seg(Point(0.5, 2.0), Point(-0.5, 2.0)));
+    }
+};
+
+template <typename F>
+double ns_per_source(F f)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r != ROUNDS; ++r)
+    {
+        for (unsigned int s = 0; s != NUM_SOURCES; ++s)
+        {
+            f(s);
+        }
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (static_cast<double>(ROUNDS) * NUM_SOURCES);
+}
+
+TEST(GeomAngleSweepBenchmark, best_of_three_targets)
+{
+    for (std::size_t n : NUM_OBSTACLES)
+    {
+        Scene scene(n);
+        const double radius = 0.09;
+        double sink_legacy = 0.0, sink_engine = 0.0;
+
+        double legacy = ns_per_source([&](unsigned int s) {
+            for (const Seg &t : scene.targets)
+            {
+                sink_legacy += legacy_angle_sweep_circles(
+                                   scene.sources[s], t.start, t.end,
+                                   scene.obstacles, radius)
+                                   .second.to_radians();
+            }
+        });
+
+        double wrapper = ns_per_source([&](unsigned int s) {
+            for (const Seg &t : scene.targets)
+            {
+                angle_sweep_circles(
+                    scene.sources[s], t.start, t.end, scene.obstacles, radius);
+            }
+        });
+
+        AngleSweep sweep;
+        std::vector<AngleSweep::Window> out;
+        double engine = ns_per_source([&](unsigned int s) {
+            sweep.set_source(scene.sources[s], scene.obstacles, radius);
+            sweep.best(scene.targets, out);
+            for (const AngleSweep::Window &w : out)
+            {
+                sink_engine += w.width.to_radians();
+            }
+        });
+
+        std::cout << "[ BENCH    ] " << n << " obstacles, 3 targets: legacy "
+                  << legacy << " ns, wrapper " << wrapper
+                  << " ns, reused engine " << engine << " ns per source ("
+                  << legacy / engine << "x)\n";
+        EXPECT_NEAR(sink_legacy, sink_engine, 1e-6 * sink_legacy);
+    }
+}
+
+TEST(GeomAngleSweepBenchmark, matches_legacy)
+{
+    Scene scene(12);
+    AngleSweep sweep;
+    for (const Point &src : scene.sources)
+    {
+        sweep.set_source(src, scene.obstacles, 0.09);
+        for (const Seg &t : scene.targets)
+        {
+            std::pair<Point, Angle> expected = legacy_angle_sweep_circles(
+                src, t.start, t.end, scene.obstacles, 0.09);
+            AngleSweep::Window actual = sweep.best(t);
+            EXPECT_NEAR(
+                expected.second.to_radians(), actual.width.to_radians(),
+                1e-12);
+            EXPECT_LT((expected.first - actual.target).len(), 1e-9);
+        }
+    }
+}
+
+TEST(GeomAngleSweepBenchmark, zero_allocations_when_reused)
+{
+    Scene scene(24);
+    AngleSweep sweep;
+    std::vector<AngleSweep::Window> out;
+    for (const Point &src : scene.sources)
+    {
+        sweep.set_source(src, scene.obstacles, 0.09);
+        sweep.best(scene.targets, out);
+    }
+
+    uint64_t allocations_before = AllocationCounter::count();
+    for (const Point &src : scene.sources)
+    {
+        sweep.set_source(src, scene.obstacles, 0.09);
+        sweep.best(scene.targets, out);
+        sweep.coverage(scene.targets[1]);
+    }
+    uint64_t allocations = AllocationCounter::count() - allocations_before;
+    std::cout << "[ BENCH    ] " << allocations
+              << " allocations over " << NUM_SOURCES << " sources\n";
+    EXPECT_EQ(0U, allocations);
+}
+}
@@ -0,0 +1,149 @@
+#include "geom/batch.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+const std::size_t SIZES[]        = {12, 100, 1000};
+const unsigned int NUM_SEGMENTS  = 64;
+const unsigned int TOTAL_QUERIES = 4000000;
+
+/**
+ * \brief Random shapes scattered over a field-sized area.
+ */
+struct Scene final
+{
+    PointSet points;
+    CircleSet circles;
+    std::vector<Seg> segs;
+
+    explicit Scene(std::size_t n)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> x(-4.5, 4.5), y(-3.0, 3.0),
+            radius(0.0215, 0.09);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            points.push_back(Vector2(x(rng), y(rng)));
+            circles.push_back(Circle(Vector2(x(rng), y(rng)), radius(rng)));
+        }
+        for (unsigned int i = 0; i != NUM_SEGMENTS; ++i)
+        {
+            segs.push_back(
+                Seg(Vector2(x(rng), y(rng)), Vector2(x(rng), y(rng))));
+        }
+    }
+};
+
+/**
+ * \brief Runs a kernel over every segment enough times to make about \ref
+ * TOTAL_QUERIES element queries, and returns nanoseconds per element.
+ */
+template <typename F>
+double time_per_element(std::size_t n, F kernel)
+{
+    unsigned int rounds = static_cast<unsigned int>(
+        TOTAL_QUERIES / (n * NUM_SEGMENTS) + 1);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r != rounds; ++r)
+    {
+        for (unsigned int s = 0; s != NUM_SEGMENTS; ++s)
+        {
+            kernel(s);
+        }
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (static_cast<double>(rounds) * NUM_SEGMENTS * n);
+}
+
+void report(const char *name, std::size_t n, double scalar, double batch)
+{
+    std::cout << "[ BENCH    ] " << name << " x" << n << ": scalar " << scalar
+              << " ns, batch " << batch << " ns per element ("
+              << scalar / batch << "x)\n";
+}
+
+TEST(GeomBatchBenchmark, dist_point_seg)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        std::vector<double> out(n);
+        double sink   = 0.0;
+        double scalar = time_per_element(n, [&](unsigned int s) {
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                out[i] = dist(scene.points[i], scene.segs[s]);
+            }
+            sink += out[0];
+        });
+        double batch = time_per_element(n, [&](unsigned int s) {
+            dist(scene.segs[s], scene.points, out.data());
+            sink += out[0];
+        });
+        report("dist(point, seg)", n, scalar, batch);
+        EXPECT_GT(sink, 0.0);
+    }
+}
+
+TEST(GeomBatchBenchmark, intersects_seg_circle)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        std::unique_ptr<bool[]> out(new bool[n]);
+        std::size_t hits_scalar = 0, hits_batch = 0;
+        double scalar = time_per_element(n, [&](unsigned int s) {
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                out[i] = intersects(scene.segs[s], scene.circles[i]);
+                hits_scalar += out[i];
+            }
+        });
+        double batch = time_per_element(n, [&](unsigned int s) {
+            hits_batch += intersects(scene.segs[s], scene.circles, out.get());
+        });
+        report("intersects(seg, circle)", n, scalar, batch);
+        EXPECT_EQ(hits_scalar, hits_batch);
+    }
+}
+
+TEST(GeomBatchBenchmark, contains_rect_point)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        std::unique_ptr<bool[]> out(new bool[n]);
+        std::vector<Rect> rects;
+        for (const Seg &seg : scene.segs)
+        {
+            rects.push_back(Rect(seg.start, seg.end));
+        }
+        std::size_t hits_scalar = 0, hits_batch = 0;
+        double scalar = time_per_element(n, [&](unsigned int s) {
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                out[i] = contains(rects[s], scene.points[i]);
+                hits_scalar += out[i];
+            }
+        });
+        double batch = time_per_element(n, [&](unsigned int s) {
+            hits_batch += contains(rects[s], scene.points, out.get());
+        });
+        report("contains(rect, point)", n, scalar, batch);
+        EXPECT_EQ(hits_scalar, hits_batch);
+    }
+}
+}
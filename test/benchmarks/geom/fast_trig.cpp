@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "geom/angle.h"
+#include "geom/batch.h"
+#include "geom/point.h"
+
+using namespace Geom;
+
+namespace
+{
+const std::size_t NUM_VALUES = 1000;
+const unsigned int ROUNDS    = 4000;
+
+/**
+ * \brief Runs a kernel over the values \ref ROUNDS times and returns
+ * nanoseconds per value.
+ */
+template <typename F>
+double time_per_value(F kernel)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r != ROUNDS; ++r)
+    {
+        kernel();
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (static_cast<double>(ROUNDS) * NUM_VALUES);
+}
+
+void report(const char *name, double libm, double fast, double batch)
+{
+    std::cout << "[ BENCH    ] " << name << ": libm " << libm << " ns, fast "
+              << fast << " ns (" << libm / fast << "x), batch " << batch
+              << " ns (" << libm / batch << "x) per value\n";
+}
+
+std::vector<double> random_values(double lo, double hi, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> values(NUM_VALUES);
+    for (double &v : values)
+    {
+        v = dist(rng);
+    }
+    return values;
+}
+
+TEST(FastTrigBenchmark, sin)
+{
+    const std::vector<double> in = random_values(-M_PI, M_PI, 1);
+    std::vector<double> out(NUM_VALUES);
+    double sink = 0.0;
+    double libm = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = Angle::of_radians(in[i]).sin();
+        }
+        sink += out[0];
+    });
+    double fast = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = Angle::of_radians(in[i]).fast_sin();
+        }
+        sink += out[0];
+    });
+    double batch = time_per_value([&]() {
+        fast_sin(in.data(), NUM_VALUES, out.data());
+        sink += out[0];
+    });
+    report("sin", libm, fast, batch);
+    EXPECT_TRUE(std::isfinite(sink));
+}
+
+TEST(FastTrigBenchmark, asin)
+{
+    const std::vector<double> in = random_values(-1.0, 1.0, 2);
+    std::vector<double> out(NUM_VALUES);
+    double sink = 0.0;
+    double libm = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = Angle::asin(in[i]).to_radians();
+        }
+        sink += out[0];
+    });
+    double fast = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = Angle::fast_asin(in[i]).to_radians();
+        }
+        sink += out[0];
+    });
+    double batch = time_per_value([&]() {
+        fast_asin(in.data(), NUM_VALUES, out.data());
+        sink += out[0];
+    });
+    report("asin", libm, fast, batch);
+    EXPECT_TRUE(std::isfinite(sink));
+}
+
+TEST(FastTrigBenchmark, orientation)
+{
+    const std::vector<double> x = random_values(-4.5, 4.5, 3),
+                              y = random_values(-3.0, 3.0, 4);
+    PointSet points;
+    for (std::size_t i = 0; i != NUM_VALUES; ++i)
+    {
+        points.push_back(Vector2(x[i], y[i]));
+    }
+    std::vector<double> out(NUM_VALUES);
+    double sink = 0.0;
+    double libm = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = points[i].orientation().to_radians();
+        }
+        sink += out[0];
+    });
+    double fast = time_per_value([&]() {
+        for (std::size_t i = 0; i != NUM_VALUES; ++i)
+        {
+            out[i] = points[i].fast_orientation().to_radians();
+        }
+        sink += out[0];
+    });
+    double batch = time_per_value([&]() {
+        fast_orientation(points, out.data());
+        sink += out[0];
+    });
+    report("orientation", libm, fast, batch);
+    EXPECT_TRUE(std::isfinite(sink));
+}
+}
@@ -0,0 +1,183 @@
+#include "geom/spatial_index.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "geom/util.h"
+#include "test/benchmarks/allocation_counter.h"
+
+using namespace Geom;
+
+namespace
+{
+const Rect FIELD(Point(-4.7, -3.2), Point(4.7, 3.2));
+const std::size_t SIZES[]      = {12, 24, 100};
+const unsigned int NUM_QUERIES = 256;
+const unsigned int ROUNDS      = 400;
+const double CELL_SIZE         = 0.5;
+const double ROBOT_RADIUS      = 0.09;
+
+/**
+ * \brief Robots scattered over the field, with query locations and paths of
+ * the sort a navigator or pass evaluator asks about.
+ */
+struct Scene final
+{
+    std::vector<Point> obstacles;
+    std::vector<Point> locations;
+    std::vector<Seg> paths;
+
+    explicit Scene(std::size_t n)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> x(-4.5, 4.5), y(-3.0, 3.0);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            obstacles.push_back(Point(x(rng), y(rng)));
+        }
+        std::uniform_real_distribution<double> dir(-3.14159, 3.14159),
+            len(0.5, 4.0);
+        for (unsigned int i = 0; i != NUM_QUERIES; ++i)
+        {
+            Point p(x(rng), y(rng));
+            locations.push_back(p);
+            paths.push_back(Seg(p, p + Point::of_angle(
+                                           Angle::of_radians(dir(rng))) *
+                                           len(rng)));
+        }
+    }
+};
+
+template <typename F>
+double ns_per_query(F f)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r != ROUNDS; ++r)
+    {
+        for (unsigned int q = 0; q != NUM_QUERIES; ++q)
+        {
+            f(q);
+        }
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (static_cast<double>(ROUNDS) * NUM_QUERIES);
+}
+
+void report(const char *name, std::size_t n, double scan, double index)
+{
+    std::cout << "[ BENCH    ] " << name << " x" << n << ": scan " << scan
+              << " ns, index " << index << " ns per query (" << scan / index
+              << "x)\n";
+}
+
+TEST(GeomSpatialIndexBenchmark, build)
+{
+    SpatialIndex index(FIELD, CELL_SIZE);
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        index.build(scene.obstacles);
+        uint64_t allocations_before = AllocationCounter::count();
+        double ns = ns_per_query(
+            [&](unsigned int) { index.build(scene.obstacles); });
+        uint64_t allocations = AllocationCounter::count() - allocations_before;
+        std::cout << "[ BENCH    ] build x" << n << ": " << ns << " ns, "
+                  << allocations << " allocations\n";
+        EXPECT_EQ(0U, allocations);
+    }
+}
+
+TEST(GeomSpatialIndexBenchmark, within_radius)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        SpatialIndex index(FIELD, CELL_SIZE);
+        index.build(scene.obstacles);
+        const double r = 4 * ROBOT_RADIUS;
+        std::vector<std::size_t> out;
+        std::size_t hits_scan = 0, hits_index = 0;
+        double scan = ns_per_query([&](unsigned int q) {
+            out.clear();
+            for (std::size_t i = 0; i != scene.obstacles.size(); ++i)
+            {
+                if (distsq(scene.obstacles[i], scene.locations[q]) <= r * r)
+                {
+                    out.push_back(i);
+                }
+            }
+            hits_scan += out.size();
+        });
+        double indexed = ns_per_query([&](unsigned int q) {
+            index.within(scene.locations[q], r, out);
+            hits_index += out.size();
+        });
+        report("within(point, radius)", n, scan, indexed);
+        EXPECT_EQ(hits_scan, hits_index);
+    }
+}
+
+TEST(GeomSpatialIndexBenchmark, within_corridor)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        SpatialIndex index(FIELD, CELL_SIZE);
+        index.build(scene.obstacles);
+        const double r = 2 * ROBOT_RADIUS;
+        std::vector<std::size_t> out;
+        std::size_t hits_scan = 0, hits_index = 0;
+        double scan = ns_per_query([&](unsigned int q) {
+            out.clear();
+            for (std::size_t i = 0; i != scene.obstacles.size(); ++i)
+            {
+                if (distsq(scene.obstacles[i], scene.paths[q]) <= r * r)
+                {
+                    out.push_back(i);
+                }
+            }
+            hits_scan += out.size();
+        });
+        double indexed = ns_per_query([&](unsigned int q) {
+            index.within(scene.paths[q], r, out);
+            hits_index += out.size();
+        });
+        report("within(seg, radius)", n, scan, indexed);
+        EXPECT_EQ(hits_scan, hits_index);
+    }
+}
+
+TEST(GeomSpatialIndexBenchmark, nearest)
+{
+    for (std::size_t n : SIZES)
+    {
+        Scene scene(n);
+        SpatialIndex index(FIELD, CELL_SIZE);
+        index.build(scene.obstacles);
+        std::size_t sum_scan = 0, sum_index = 0;
+        double scan = ns_per_query([&](unsigned int q) {
+            std::size_t best = 0;
+            for (std::size_t i = 1; i != scene.obstacles.size(); ++i)
+            {
+                if (distsq(scene.obstacles[i], scene.locations[q]) <
+                    distsq(scene.obstacles[best], scene.locations[q]))
+                {
+                    best = i;
+                }
+            }
+            sum_scan += best;
+        });
+        double indexed = ns_per_query([&](unsigned int q) {
+            sum_index += index.nearest(scene.locations[q]);
+        });
+        report("nearest(point)", n, scan, indexed);
+        EXPECT_EQ(sum_scan, sum_index);
+    }
+}
+}
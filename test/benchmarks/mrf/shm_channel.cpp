@@ -0,0 +1,174 @@
+#include "mrf/shm_channel.h"
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "util/exception.h"
+#include "util/fd.h"
+
+namespace
+{
+const unsigned int NUM_ROUND_TRIPS = 20000;
+
+/**
+ * \brief How long either side waits for the other before giving up, so that
+ * a failure on one thread cannot leave the other blocked forever.
+ */
+const int TIMEOUT_MS = 1000;
+
+/**
+ * \brief Prints the median and 99th percentile of a set of round-trip times.
+ */
+void report(const char *name, std::vector<uint64_t> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+    std::cout << "[ BENCH    ] " << name << " round trip: median "
+              << samples[samples.size() / 2] / 1000.0 << " µs, p99 "
+              << samples[samples.size() * 99 / 100] / 1000.0 << " µs\n";
+}
+
+// Checks are made only on the main thread, and each test stops at the first
+// failure and joins the echo thread before returning. The echo thread gives up
+// once it has waited TIMEOUT_MS without hearing from the main thread.
+
+TEST(ShmChannelBenchmark, round_trip)
+{
+    // The radio side echoes each primitive’s parameters back as feedback.
+    MRFShmChannel ai;
+    MRFShmChannel radio(
+        FileDescriptor::create_from_fd(dup(ai.memory_fd().fd())),
+        FileDescriptor::create_from_fd(dup(ai.command_event_fd().fd())),
+        FileDescriptor::create_from_fd(dup(ai.feedback_event_fd().fd())));
+    std::thread echo([&radio]() {
+        MRFShmChannel::Layout &layout = radio.layout();
+        for (unsigned int i = 0; i < NUM_ROUND_TRIPS; ++i)
+        {
+            if (!radio.wait_command(TIMEOUT_MS))
+            {
+                return;
+            }
+            MRFShmChannel::Primitive p = layout.primitives[0].load();
+            MRFShmChannel::Feedback fb = MRFShmChannel::Feedback();
+            fb.battery_voltage         = static_cast<float>(p.params[0]);
+            fb.stamp_ns                = p.posted_ns;
+            layout.feedback[0].store(fb);
+            radio.notify_feedback();
+        }
+    });
+
+    std::vector<uint64_t> samples;
+    samples.reserve(NUM_ROUND_TRIPS);
+    MRFShmChannel::Layout &layout = ai.layout();
+    for (unsigned int i = 0; i < NUM_ROUND_TRIPS; ++i)
+    {
+        MRFShmChannel::Primitive p = MRFShmChannel::Primitive();
+        p.valid                    = 1;
+        p.params[0]                = i;
+        p.posted_ns                = MRFShmChannel::now_ns();
+        layout.primitives[0].store(p);
+        ai.notify_command();
+        bool ok = ai.wait_feedback(TIMEOUT_MS);
+        EXPECT_TRUE(ok);
+        if (!ok)
+        {
+            break;
+        }
+        MRFShmChannel::Feedback fb = layout.feedback[0].load();
+        EXPECT_EQ(static_cast<float>(i), fb.battery_voltage);
+        if (fb.battery_voltage != static_cast<float>(i))
+        {
+            break;
+        }
+        samples.push_back(MRFShmChannel::now_ns() - fb.stamp_ns);
+    }
+    echo.join();
+    if (samples.size() == NUM_ROUND_TRIPS)
+    {
+        report("Shared memory", samples);
+    }
+}
+
+TEST(ShmChannelBenchmark, socket_round_trip)
+{
+    // The same exchange over a raw Unix datagram socket pair, copying the same
+    // structures through the kernel. This is a lower bound for the transport
+    // underneath MRFControlServer, not a measurement of the server itself,
+    // which also decodes each command and runs it through the main loop.
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv) < 0)
+    {
+        throw SystemError("socketpair", errno);
+    }
+    FileDescriptor ai    = FileDescriptor::create_from_fd(sv[0]);
+    FileDescriptor radio = FileDescriptor::create_from_fd(sv[1]);
+    timeval timeout = {TIMEOUT_MS / 1000, 0};
+    for (int fd : {ai.fd(), radio.fd()})
+    {
+        if (setsockopt(
+                fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0)
+        {
+            throw SystemError("setsockopt", errno);
+        }
+    }
+    std::thread echo([&radio]() {
+        for (unsigned int i = 0; i < NUM_ROUND_TRIPS; ++i)
+        {
+            MRFShmChannel::Primitive p;
+            if (recv(radio.fd(), &p, sizeof(p), 0) !=
+                static_cast<ssize_t>(sizeof(p)))
+            {
+                return;
+            }
+            MRFShmChannel::Feedback fb = MRFShmChannel::Feedback();
+            fb.battery_voltage         = static_cast<float>(p.params[0]);
+            fb.stamp_ns                = p.posted_ns;
+            if (send(radio.fd(), &fb, sizeof(fb), 0) !=
+                static_cast<ssize_t>(sizeof(fb)))
+            {
+                return;
+            }
+        }
+    });
+
+    std::vector<uint64_t> samples;
+    samples.reserve(NUM_ROUND_TRIPS);
+    for (unsigned int i = 0; i < NUM_ROUND_TRIPS; ++i)
+    {
+        MRFShmChannel::Primitive p = MRFShmChannel::Primitive();
+        p.valid                    = 1;
+        p.params[0]                = i;
+        p.posted_ns                = MRFShmChannel::now_ns();
+        ssize_t rc = send(ai.fd(), &p, sizeof(p), 0);
+        EXPECT_EQ(static_cast<ssize_t>(sizeof(p)), rc);
+        if (rc != static_cast<ssize_t>(sizeof(p)))
+        {
+            break;
+        }
+        MRFShmChannel::Feedback fb;
+        rc = recv(ai.fd(), &fb, sizeof(fb), 0);
+        EXPECT_EQ(static_cast<ssize_t>(sizeof(fb)), rc);
+        if (rc != static_cast<ssize_t>(sizeof(fb)))
+        {
+            break;
+        }
+        EXPECT_EQ(static_cast<float>(i), fb.battery_voltage);
+        if (fb.battery_voltage != static_cast<float>(i))
+        {
+            break;
+        }
+        samples.push_back(MRFShmChannel::now_ns() - fb.stamp_ns);
+    }
+    echo.join();
+    if (samples.size() == NUM_ROUND_TRIPS)
+    {
+        report("Unix socket", samples);
+    }
+}
+}
@@ -0,0 +1,165 @@
+#include "util/assignment.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "util/hungarian.h"
+
+namespace
+{
+const std::size_t SIZES[]     = {8, 12, 16};
+const unsigned int NUM_FRAMES = 20000;
+const double FRAME_MOTION     = 0.03;
+
+/**
+ * \brief Objects wandering over an area, seen each frame with some noise and
+ * in a shuffled order, as a cost matrix of detections against tracks.
+ */
+struct Frames final
+{
+    std::vector<std::vector<double>> costs;
+
+    explicit Frames(std::size_t n, double width, double height, double noise)
+    {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> x(-width / 2, width / 2),
+            y(-height / 2, height / 2), step(-FRAME_MOTION, FRAME_MOTION),
+            error(-noise, noise);
+        std::vector<double> tx(n), ty(n);
+        for (std::size_t j = 0; j != n; ++j)
+        {
+            tx[j] = x(rng);
+            ty[j] = y(rng);
+        }
+        std::vector<std::size_t> order(n);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            order[i] = i;
+        }
+        for (unsigned int f = 0; f != NUM_FRAMES; ++f)
+        {
+            std::shuffle(order.begin(), order.end(), rng);
+            std::vector<double> frame(n * n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                double dx = tx[order[i]] + error(rng),
+                       dy = ty[order[i]] + error(rng);
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    frame[i * n + j] = std::hypot(dx - tx[j], dy - ty[j]);
+                }
+            }
+            costs.push_back(frame);
+            for (std::size_t j = 0; j != n; ++j)
+            {
+                tx[j] += step(rng);
+                ty[j] += step(rng);
+            }
+        }
+    }
+};
+
+template <typename F>
+double us_per_frame(F f)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i != NUM_FRAMES; ++i)
+    {
+        f(i);
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (1000.0 * NUM_FRAMES);
+}
+
+void run(const char *name, double width, double height, double noise)
+{
+    for (std::size_t n : SIZES)
+    {
+        Frames frames(n, width, height, noise);
+        double total_hungarian = 0.0, total_cold = 0.0, total_warm = 0.0;
+
+        // What dist_matching did: a fresh Hungarian maximizing negated costs.
+        double hungarian = us_per_frame([&](unsigned int f) {
+            Hungarian hung(n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    hung.weight(i, j) = -frames.costs[f][i * n + j];
+                }
+            }
+            hung.execute();
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                total_hungarian += frames.costs[f][i * n + hung.matchX(i)];
+            }
+        });
+
+        Assignment cold;
+        std::size_t cold_searches = 0;
+        double cold_us            = us_per_frame([&](unsigned int f) {
+            cold.resize(n, n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    cold.cost(i, j) = frames.costs[f][i * n + j];
+                }
+            }
+            cold.reset();
+            cold.solve();
+            cold_searches += cold.augmentations();
+            total_cold += cold.total_cost();
+        });
+
+        Assignment warm;
+        std::size_t warm_searches = 0;
+        double warm_us            = us_per_frame([&](unsigned int f) {
+            warm.resize(n, n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    warm.cost(i, j) = frames.costs[f][i * n + j];
+                }
+            }
+            warm.solve();
+            warm_searches += warm.augmentations();
+            total_warm += warm.total_cost();
+        });
+
+        std::cout << "[ BENCH    ] " << name << " x" << n << ": Hungarian "
+                  << hungarian << " us, cold " << cold_us << " us, warm "
+                  << warm_us << " us per frame (" << hungarian / warm_us
+                  << "x); searches per frame cold "
+                  << static_cast<double>(cold_searches) / NUM_FRAMES
+                  << ", warm "
+                  << static_cast<double>(warm_searches) / NUM_FRAMES << "\n";
+        EXPECT_NEAR(total_hungarian, total_cold, 1e-6 * total_hungarian);
+        EXPECT_NEAR(total_hungarian, total_warm, 1e-6 * total_hungarian);
+    }
+}
+
+TEST(AssignmentBenchmark, spread_over_field)
+{
+    run("field", 9.0, 6.0, 0.01);
+}
+
+TEST(AssignmentBenchmark, crowded)
+{
+    run("crowd", 1.0, 0.6, 0.01);
+}
+
+TEST(AssignmentBenchmark, crowded_and_noisy)
+{
+    run("noisy crowd", 1.0, 0.6, 0.12);
+}
+}
@@ -0,0 +1,270 @@
+#include "util/hungarian.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+const std::size_t SIZES[]  = {8, 16, 32, 64};
+const unsigned int NUM_RUNS = 2000;
+
+/**
+ * \brief The solver as it was before the Jonker–Volgenant rewrite: the
+ * O(n<sup>3</sup>) Hungarian method over nested vectors and stack arrays,
+ * finding tight edges by epsilon comparison.
+ */
+class LegacyHungarian final
+{
+   public:
+    explicit LegacyHungarian(std::size_t size)
+        : weights(size, std::vector<double>(size, 0.0)),
+          mx(size, std::numeric_limits<unsigned int>::max()),
+          my(size, std::numeric_limits<unsigned int>::max())
+    {
+    }
+
+    double &weight(std::size_t x, std::size_t y)
+    {
+        return weights[x][y];
+    }
+
+    std::size_t matchX(std::size_t x) const
+    {
+        return mx[x];
+    }
+
+    void execute()
+    {
+        const std::size_t N = weights.size();
+
+        double lx[N], ly[N];
+        std::fill(lx, lx + N, 0);
+        std::fill(ly, ly + N, 0);
+
+        double sy[N];
+        std::size_t py[N];
+        bool S[N];
+
+        std::fill(
+            mx.begin(), mx.end(), std::numeric_limits<unsigned int>::max());
+        std::fill(
+            my.begin(), my.end(), std::numeric_limits<unsigned int>::max());
+
+        for (unsigned int i = 0; i < N; i++)
+        {
+            for (unsigned int j = 0; j < N; j++)
+            {
+                ly[j] = std::max(ly[j], weights[i][j]);
+            }
+        }
+
+        for (unsigned int szm = 0; szm < N; ++szm)
+        {
+            unsigned int u = 0;
+            while (u < N && mx[u] != std::numeric_limits<unsigned int>::max())
+            {
+                u++;
+            }
+            std::fill(S, S + N, false);
+            S[u] = true;
+            std::fill(py, py + N, std::numeric_limits<std::size_t>::max());
+            for (std::size_t y = 0; y < N; y++)
+            {
+                sy[y] = ly[y] + lx[u] - weights[u][y];
+            }
+            for (;;)
+            {
+                std::size_t y = 0;
+                while (y < N &&
+                       !(equal(sy[y], 0.0) &&
+                         py[y] == std::numeric_limits<std::size_t>::max()))
+                {
+                    y++;
+                }
+                if (y == N)
+                {
+                    double a = 1.0 / 0.0;
+                    for (std::size_t i = 0; i < N; i++)
+                    {
+                        if (py[i] == std::numeric_limits<std::size_t>::max())
+                        {
+                            a = std::min(a, sy[i]);
+                        }
+                    }
+                    for (std::size_t v = 0; v < N; v++)
+                    {
+                        if (S[v])
+                        {
+                            lx[v] -= a;
+                        }
+                        if (py[v] != std::numeric_limits<std::size_t>::max())
+                        {
+                            ly[v] += a;
+                        }
+                        else
+                        {
+                            sy[v] -= a;
+                        }
+                    }
+                }
+                else
+                {
+                    for (std::size_t x = 0; x < N; x++)
+                    {
+                        if (S[x] && equal(lx[x] + ly[y], weights[x][y]))
+                        {
+                            py[y] = x;
+                            break;
+                        }
+                    }
+                    if (my[y] != std::numeric_limits<unsigned int>::max())
+                    {
+                        S[my[y]] = true;
+                        for (std::size_t z = 0; z < N; z++)
+                        {
+                            sy[z] = std::min(
+                                sy[z], lx[my[y]] + ly[z] - weights[my[y]][z]);
+                        }
+                    }
+                    else
+                    {
+                        while (y < N)
+                        {
+                            std::size_t p, ny;
+                            p     = py[y];
+                            ny    = mx[p];
+                            my[y] = p;
+                            mx[p] = y;
+                            y     = ny;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+   private:
+    std::vector<std::vector<double>> weights;
+    std::vector<std::size_t> mx, my;
+
+    static bool equal(double x, double y)
+    {
+        return std::fabs(x - y) < 1e-9;
+    }
+};
+
+template <typename F>
+double us_per_run(F f)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i != NUM_RUNS; ++i)
+    {
+        f(i);
+    }
+    std::chrono::steady_clock::duration elapsed =
+        std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count()) /
+           (1000.0 * NUM_RUNS);
+}
+
+/**
+ * \brief Negated distances between random robots and random targets, the
+ * shape of problem the AI hands the solver.
+ */
+std::vector<std::vector<double>> make_problems(std::size_t n)
+{
+    std::mt19937 rng(static_cast<unsigned int>(n));
+    std::uniform_real_distribution<double> x(-4.5, 4.5), y(-3.0, 3.0);
+    std::vector<std::vector<double>> problems;
+    for (unsigned int r = 0; r != NUM_RUNS; ++r)
+    {
+        std::vector<double> ax(n), ay(n), bx(n), by(n), weights(n * n);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            ax[i] = x(rng);
+            ay[i] = y(rng);
+            bx[i] = x(rng);
+            by[i] = y(rng);
+        }
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            for (std::size_t j = 0; j != n; ++j)
+            {
+                weights[i * n + j] = -std::hypot(ax[i] - bx[j], ay[i] - by[j]);
+            }
+        }
+        problems.push_back(weights);
+    }
+    return problems;
+}
+
+TEST(HungarianBenchmark, legacy_vs_jonker_volgenant)
+{
+    for (std::size_t n : SIZES)
+    {
+        const std::vector<std::vector<double>> problems = make_problems(n);
+        double total_legacy = 0.0, total_new = 0.0;
+
+        // The old class was built afresh for each problem.
+        double legacy_us = us_per_run([&](unsigned int r) {
+            LegacyHungarian h(n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    h.weight(i, j) = problems[r][i * n + j];
+                }
+            }
+            h.execute();
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                total_legacy += problems[r][i * n + h.matchX(i)];
+            }
+        });
+
+        double fresh_us = us_per_run([&](unsigned int r) {
+            Hungarian h(n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    h.weight(i, j) = problems[r][i * n + j];
+                }
+            }
+            h.execute();
+        });
+
+        Hungarian reused(n);
+        double reused_us = us_per_run([&](unsigned int r) {
+            reused.resize(n, n);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                for (std::size_t j = 0; j != n; ++j)
+                {
+                    reused.weight(i, j) = problems[r][i * n + j];
+                }
+            }
+            reused.execute();
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                total_new += problems[r][i * n + reused.matchX(i)];
+            }
+        });
+
+        std::cout << "[ BENCH    ] x" << n << ": legacy " << legacy_us
+                  << " us, new " << fresh_us << " us, new reused "
+                  << reused_us << " us per problem ("
+                  << legacy_us / reused_us << "x)\n";
+        EXPECT_NEAR(total_legacy, total_new, 1e-6 * std::fabs(total_legacy));
+    }
+}
+}
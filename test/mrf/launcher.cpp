@@ -5,7 +5,11 @@
 using namespace std::placeholders;
 
 TesterLauncher::TesterLauncher(MRFDongle &dongle)
-    : dongle(dongle), table(3, 4, true), mapper_toggle(u8"Joystick Mapper")
+    : dongle(dongle),
+      table(3, 4, true),
+      mapper_toggle(u8"Joystick Mapper"),
+      usb_stats_frame(u8"USB"),
+      usb_stats_panel(dongle)
 {
     set_title(u8"Tester");
     for (unsigned int i = 0; i < G_N_ELEMENTS(robot_toggles); ++i)
@@ -23,6 +27,8 @@ TesterLauncher::TesterLauncher(MRFDongle &dongle)
         mapper_toggle, 0, 4, 2, 3, Gtk::FILL | Gtk::EXPAND,
         Gtk::FILL | Gtk::SHRINK);
     vbox.pack_start(table, Gtk::PACK_SHRINK);
+    usb_stats_frame.add(usb_stats_panel);
+    vbox.pack_start(usb_stats_frame, Gtk::PACK_SHRINK);
     vbox.pack_start(ann, Gtk::PACK_EXPAND_WIDGET);
     add(vbox);
     show_all();
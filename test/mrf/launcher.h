@@ -2,12 +2,14 @@
 #define TEST_MRF_LAUNCHER_H
 
 #include <gtkmm/box.h>
+#include <gtkmm/frame.h>
 #include <gtkmm/table.h>
 #include <gtkmm/togglebutton.h>
 #include <gtkmm/window.h>
 #include <memory>
 #include "mrf/dongle.h"
 #include "test/common/mapper.h"
+#include "test/mrf/usb_stats.h"
 #include "test/mrf/window.h"
 #include "uicomponents/annunciator.h"
 
@@ -33,6 +35,8 @@ class TesterLauncher final : public Gtk::Window
     std::unique_ptr<TesterWindow> windows[8];
     Gtk::ToggleButton mapper_toggle;
     std::unique_ptr<MapperWindow> mapper_window;
+    Gtk::Frame usb_stats_frame;
+    USBStatsPanel usb_stats_panel;
     GUIAnnunciator ann;
 
     void on_robot_toggled(unsigned int i);
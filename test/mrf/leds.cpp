@@ -48,7 +48,9 @@ void LEDsPanel::set_mode()
         data[0] = 0x03;
         data[1] = MODES[mode_chooser.get_active_row_number()].value;
         message.reset(new MRFDongle::SendReliableMessageOperation(
-            dongle, index, 3, data, sizeof(data)));
+            dongle, index,
+            MRFDongle::SendReliableMessageOperation::ADAPTIVE_TRIES, data,
+            sizeof(data)));
         message->signal_done.connect(
             sigc::mem_fun(this, &LEDsPanel::check_result));
     }
@@ -1,27 +1,91 @@
 #include "main.h"
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <glibmm/optioncontext.h>
+#include <glibmm/optionentry.h>
+#include <glibmm/optiongroup.h>
 #include <gtkmm/main.h>
+#include <sigc++/bind.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <locale>
+#include <memory>
+#include "drive/telemetry_publisher.h"
+#include "mrf/console.h"
+#include "mrf/control_server.h"
 #include "mrf/dongle.h"
+#include "mrf/shm_bridge.h"
+#include "mrf/shm_channel.h"
 #include "test/mrf/launcher.h"
 #include "util/annunciator.h"
 #include "util/config.h"
 #include "util/main_loop.h"
 
+namespace
+{
+/**
+ * \brief Reports how long startup took and how much memory is resident.
+ *
+ * \param[in] start when \ref app_main was entered
+ */
+void report_startup(std::chrono::steady_clock::time_point start)
+{
+    long size = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> size >> resident;
+    std::cout << "Started in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms, resident " << resident * sysconf(_SC_PAGESIZE) / 1024
+              << " KiB\n"
+              << std::flush;
+}
+}
+
 int app_main(int argc, char **argv)
 {
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
     // Set the current locale from environment variables.
     std::locale::global(std::locale(""));
 
     // Parse the command-line arguments.
     Glib::OptionContext option_context;
     option_context.set_summary(u8"Allows testing robot subsystems.");
+    Glib::OptionGroup option_group(
+        u8"mrftest", u8"Radio Options", u8"Show radio options");
+    bool headless = false;
+    {
+        Glib::OptionEntry entry;
+        entry.set_long_name(u8"headless");
+        entry.set_description(
+            u8"Runs without a window, taking commands from standard input and "
+            u8"any control socket.");
+        option_group.add_entry(entry, headless);
+    }
+    option_context.set_main_group(option_group);
+
+    // Pick out our own options first, so GTK is only initialized when a
+    // window will be shown.
+    Glib::init();
+    option_context.set_ignore_unknown_options(true);
+    option_context.parse(argc, argv);
+    option_context.set_ignore_unknown_options(false);
 
     // Load the configuration file.
     Config::load();
 
     // Initialize GTK.
-    Gtk::Main m(argc, argv, option_context);
+    std::unique_ptr<Gtk::Main> gtk;
+    if (!headless)
+    {
+        gtk.reset(new Gtk::Main(argc, argv, option_context));
+    }
     if (argc != 1)
     {
         std::cout << option_context.get_help();
@@ -33,9 +97,60 @@ int app_main(int argc, char **argv)
     MRFDongle dongle;
     std::cout << "OK\n";
 
-    // Create the window.
-    TesterLauncher win(dongle);
-    MainLoop::run(win);
+    // Publish robot feedback if asked to.
+    std::unique_ptr<Drive::TelemetryPublisher> telemetry;
+    {
+        const char *telemetry_address = std::getenv("MRF_TELEMETRY");
+        if (telemetry_address)
+        {
+            telemetry.reset(
+                new Drive::TelemetryPublisher(dongle, 8, telemetry_address));
+        }
+    }
+
+    // Share memory with another process if asked to. The channel is handed
+    // out through the control server.
+    std::unique_ptr<MRFShmChannel> shm_channel;
+    std::unique_ptr<MRFShmBridge> shm_bridge;
+    if (std::getenv("MRF_SHM"))
+    {
+        shm_channel.reset(new MRFShmChannel);
+        shm_bridge.reset(new MRFShmBridge(dongle, *shm_channel));
+    }
+
+    // Accept commands from another process if asked to.
+    std::unique_ptr<MRFControlServer> control_server;
+    {
+        const char *control_address = std::getenv("MRF_CONTROL");
+        if (control_address)
+        {
+            control_server.reset(new MRFControlServer(
+                dongle, control_address, shm_channel.get()));
+        }
+    }
+
+    // Stop robots whose commands come from another process or a script if
+    // those commands stop arriving. When only the window can command the
+    // robots, its set-once primitives are left running.
+    if (headless || shm_bridge || control_server)
+    {
+        dongle.arm_default_command_deadlines();
+    }
+
+    Glib::signal_idle().connect_once(sigc::bind(&report_startup, start));
+
+    if (headless)
+    {
+        // Take commands from standard input.
+        MRFConsole console(dongle, STDIN_FILENO, std::cout);
+        MainLoop::run();
+    }
+    else
+    {
+        // Create the window.
+        TesterLauncher win(dongle);
+        MainLoop::run(win);
+    }
 
     return 0;
 }
@@ -1,5 +1,15 @@
 #include "test/mrf/power.h"
 #include <glibmm/main.h>
+#include <chrono>
+#include "util/async_combinators.h"
+
+namespace
+{
+/**
+ * \brief How long to wait for a message delivery report before giving up.
+ */
+const std::chrono::milliseconds MESSAGE_TIMEOUT(2000);
+}
 
 PowerPanel::PowerPanel(MRFDongle &dongle, unsigned int index)
     : Gtk::VButtonBox(Gtk::BUTTONBOX_SPREAD),
@@ -41,8 +51,13 @@ void PowerPanel::send_message(uint8_t code, Gtk::Button &button)
     set_buttons_sensitive(false);
     current_action_button = &button;
     button.set_label(u8"Sending…");
-    message.reset(new MRFDongle::SendReliableMessageOperation(
-        dongle, index, 3, &code, sizeof(code)));
+    message = Async::with_timeout(
+        std::unique_ptr<MRFDongle::SendReliableMessageOperation>(
+            new MRFDongle::SendReliableMessageOperation(
+                dongle, index,
+                MRFDongle::SendReliableMessageOperation::ADAPTIVE_TRIES, &code,
+                sizeof(code))),
+        MESSAGE_TIMEOUT);
     message->signal_done.connect(
         sigc::mem_fun(this, &PowerPanel::check_result));
 }
@@ -68,6 +83,10 @@ void PowerPanel::check_result(AsyncOperation<void> &op)
     {
         message = u8"CCA fail";
     }
+    catch (const Async::TimeoutError &)
+    {
+        message = u8"Timed out";
+    }
 
     current_action_button->set_label(message);
     current_action_button = nullptr;
@@ -29,7 +29,7 @@ class PowerPanel final : public Gtk::VButtonBox
     unsigned int index;
     Gtk::Button power_drivetrain_button, reboot_button, shut_down_button,
         *current_action_button;
-    std::unique_ptr<MRFDongle::SendReliableMessageOperation> message;
+    std::unique_ptr<AsyncOperation<void>> message;
 
     void power_drivetrain();
     void reboot();
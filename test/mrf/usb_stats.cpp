@@ -0,0 +1,195 @@
+#include "test/mrf/usb_stats.h"
+#include <glibmm/main.h>
+#include <glibmm/ustring.h>
+#include <chrono>
+#include <iomanip>
+
+namespace
+{
+struct EndpointInfo final
+{
+    unsigned char address;
+    const char *name;
+};
+
+const EndpointInfo ENDPOINTS[] = {
+    {0x00, u8"Control"},        {0x01, u8"OUT 1 (drive)"},
+    {0x02, u8"OUT 2 (camera)"}, {0x03, u8"OUT 3 (message)"},
+    {0x81, u8"IN 1 (MDR)"},     {0x82, u8"IN 2 (message)"},
+    {0x83, u8"IN 3 (status)"},
+};
+
+const char *const HEADINGS[] = {
+    u8"Endpoint",         u8"Submits",
+    u8"Completions",      u8"Bytes",
+    u8"Errors",           u8"Stall retries",
+    u8"In flight (peak)", u8"Latency µs (p50/p90/p99)",
+};
+
+const unsigned int REFRESH_INTERVAL = 500;
+}
+
+USBStatsPanel::USBStatsPanel(MRFDongle &dongle)
+    : Gtk::Table(NUM_ENDPOINTS + 6, NUM_COLUMNS),
+      dongle(dongle),
+      reset_button(u8"Reset")
+{
+    static_assert(
+        G_N_ELEMENTS(ENDPOINTS) == NUM_ENDPOINTS,
+        "Endpoint table size mismatch");
+    static_assert(
+        G_N_ELEMENTS(HEADINGS) == NUM_COLUMNS, "Heading table size mismatch");
+
+    for (unsigned int col = 0; col < NUM_COLUMNS; ++col)
+    {
+        headings[col].set_text(HEADINGS[col]);
+        attach(
+            headings[col], col, col + 1, 0, 1, Gtk::SHRINK | Gtk::FILL,
+            Gtk::SHRINK | Gtk::FILL, 4, 0);
+    }
+    for (unsigned int row = 0; row < NUM_ENDPOINTS; ++row)
+    {
+        cells[row][0].set_text(ENDPOINTS[row].name);
+        cells[row][0].set_alignment(0.0, 0.5);
+        for (unsigned int col = 0; col < NUM_COLUMNS; ++col)
+        {
+            if (col)
+            {
+                cells[row][col].set_alignment(1.0, 0.5);
+            }
+            attach(
+                cells[row][col], col, col + 1, row + 1, row + 2,
+                Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4, 0);
+        }
+    }
+    pools_label.set_alignment(0.0, 0.5);
+    attach(
+        pools_label, 0, NUM_COLUMNS - 1, NUM_ENDPOINTS + 1, NUM_ENDPOINTS + 2,
+        Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4, 0);
+    events_label.set_alignment(0.0, 0.5);
+    attach(
+        events_label, 0, NUM_COLUMNS - 1, NUM_ENDPOINTS + 2, NUM_ENDPOINTS + 3,
+        Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4, 0);
+    ingress_label.set_alignment(0.0, 0.5);
+    attach(
+        ingress_label, 0, NUM_COLUMNS - 1, NUM_ENDPOINTS + 3,
+        NUM_ENDPOINTS + 4, Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4,
+        0);
+    airtime_label.set_alignment(0.0, 0.5);
+    attach(
+        airtime_label, 0, NUM_COLUMNS - 1, NUM_ENDPOINTS + 4,
+        NUM_ENDPOINTS + 5, Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4,
+        0);
+    retry_label.set_alignment(0.0, 0.5);
+    attach(
+        retry_label, 0, NUM_COLUMNS - 1, NUM_ENDPOINTS + 5, NUM_ENDPOINTS + 6,
+        Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL, 4, 0);
+    reset_button.signal_clicked().connect(
+        sigc::mem_fun(this, &USBStatsPanel::reset));
+    attach(
+        reset_button, NUM_COLUMNS - 1, NUM_COLUMNS, NUM_ENDPOINTS + 1,
+        NUM_ENDPOINTS + 2, Gtk::SHRINK | Gtk::FILL, Gtk::SHRINK | Gtk::FILL);
+
+    refresh();
+    refresh_connection = Glib::signal_timeout().connect(
+        sigc::mem_fun(this, &USBStatsPanel::refresh), REFRESH_INTERVAL);
+}
+
+USBStatsPanel::~USBStatsPanel()
+{
+    refresh_connection.disconnect();
+}
+
+bool USBStatsPanel::refresh()
+{
+    for (unsigned int row = 0; row < NUM_ENDPOINTS; ++row)
+    {
+        const USB::EndpointStatistics &stats =
+            dongle.usb_device().endpoint_statistics(ENDPOINTS[row].address);
+        uint64_t errors = stats.errors + stats.timeouts + stats.cancellations +
+                          stats.stalls + stats.disconnections +
+                          stats.overflows;
+        cells[row][1].set_text(Glib::ustring::format(stats.submits));
+        cells[row][2].set_text(Glib::ustring::format(stats.completions));
+        cells[row][3].set_text(Glib::ustring::format(stats.bytes));
+        cells[row][4].set_text(Glib::ustring::format(errors));
+        cells[row][5].set_text(Glib::ustring::format(stats.stall_retries));
+        cells[row][6].set_text(Glib::ustring::compose(
+            u8"%1 (%2)", stats.in_flight, stats.peak_in_flight));
+        cells[row][7].set_text(Glib::ustring::compose(
+            u8"%1/%2/%3", stats.latency.percentile(0.5),
+            stats.latency.percentile(0.9), stats.latency.percentile(0.99)));
+        cells[row][4].set_tooltip_text(Glib::ustring::compose(
+            u8"Error: %1\nTimeout: %2\nCancelled: %3\nStall: %4\n"
+            u8"Disconnected: %5\nOverflow: %6",
+            stats.errors, stats.timeouts, stats.cancellations, stats.stalls,
+            stats.disconnections, stats.overflows));
+    }
+    pools_label.set_text(Glib::ustring::compose(
+        u8"IN pool depth: MDR %1 (%2 starved), message %3 (%4 starved)",
+        dongle.mdr_transfer_pool().depth(),
+        dongle.mdr_transfer_pool().starvations(),
+        dongle.message_transfer_pool().depth(),
+        dongle.message_transfer_pool().starvations()));
+    const USB::EventStatistics &events =
+        dongle.usb_context().event_statistics();
+    events_label.set_text(Glib::ustring::compose(
+        u8"Events: %1 completions in %2 wakeups (%3 per wakeup, max %4)",
+        events.completions, events.wakeups,
+        Glib::ustring::format(
+            std::fixed, std::setprecision(2),
+            events.wakeups ? static_cast<double>(events.completions) /
+                                 static_cast<double>(events.wakeups)
+                           : 0.0),
+        events.max_completions_per_wakeup));
+    const LatencyHistogram &ingress_latency = dongle.ingress_latency();
+    ingress_label.set_text(Glib::ustring::compose(
+        u8"Posted commands: depth %1 (peak %2), %3 dropped, latency µs "
+        u8"%4/%5/%6",
+        dongle.ingress_depth(), dongle.ingress_peak_depth(),
+        dongle.ingress_dropped(), ingress_latency.percentile(0.5),
+        ingress_latency.percentile(0.9), ingress_latency.percentile(0.99)));
+    const MRFAirtimeScheduler &airtime = dongle.airtime();
+    airtime_label.set_text(Glib::ustring::compose(
+        u8"Airtime ms: drive %1, camera %2, message %3; messages queued %4 "
+        u8"(peak %5), %6 in flight, %7 unreliable coalesced, %8 frames saved "
+        u8"by batching; %9 transmit queue full backoffs",
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            airtime.airtime_used(MRFAirtimeScheduler::Class::DRIVE))
+            .count(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            airtime.airtime_used(MRFAirtimeScheduler::Class::CAMERA))
+            .count(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            airtime.airtime_used(MRFAirtimeScheduler::Class::MESSAGE))
+            .count(),
+        airtime.queued(MRFAirtimeScheduler::Class::MESSAGE),
+        airtime.peak_queued(MRFAirtimeScheduler::Class::MESSAGE),
+        airtime.in_flight(MRFAirtimeScheduler::Class::MESSAGE),
+        dongle.unreliable_coalesced(), dongle.message_frames_saved(),
+        airtime.backoffs()));
+    {
+        const MRFRetryPolicy &policy = dongle.retry_policy();
+        Glib::ustring tries;
+        uint64_t delivered = 0, not_acknowledged = 0, no_clear_channel = 0;
+        for (unsigned int i = 0; i < MRFRetryPolicy::NUM_ROBOTS; ++i)
+        {
+            const MRFRetryPolicy::Report &report = policy.report(i);
+            tries.append(Glib::ustring::compose(u8" %1", report.tries));
+            delivered += report.delivered;
+            not_acknowledged += report.not_acknowledged;
+            no_clear_channel += report.no_clear_channel;
+        }
+        retry_label.set_text(Glib::ustring::compose(
+            u8"Message tries per robot:%1; %2 delivered, %3 not acknowledged, "
+            u8"%4 no clear channel",
+            tries, delivered, not_acknowledged, no_clear_channel));
+    }
+    return true;
+}
+
+void USBStatsPanel::reset()
+{
+    dongle.reset_usb_statistics();
+    refresh();
+}
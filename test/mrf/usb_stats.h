@@ -0,0 +1,45 @@
+#ifndef TEST_MRF_USB_STATS_H
+#define TEST_MRF_USB_STATS_H
+
+#include <gtkmm/button.h>
+#include <gtkmm/label.h>
+#include <gtkmm/table.h>
+#include <sigc++/connection.h>
+#include "mrf/dongle.h"
+
+/**
+ * \brief A panel that shows per-endpoint USB transfer statistics for the
+ * dongle.
+ */
+class USBStatsPanel final : public Gtk::Table
+{
+   public:
+    /**
+     * \brief Constructs a new USBStatsPanel.
+     *
+     * \param[in] dongle the dongle whose statistics should be displayed
+     */
+    explicit USBStatsPanel(MRFDongle &dongle);
+
+    /**
+     * \brief Destroys a USBStatsPanel.
+     */
+    ~USBStatsPanel();
+
+   private:
+    static const unsigned int NUM_ENDPOINTS = 7;
+    static const unsigned int NUM_COLUMNS   = 8;
+
+    MRFDongle &dongle;
+    Gtk::Label headings[NUM_COLUMNS];
+    Gtk::Label cells[NUM_ENDPOINTS][NUM_COLUMNS];
+    Gtk::Label pools_label, events_label, ingress_label, airtime_label,
+        retry_label;
+    Gtk::Button reset_button;
+    sigc::connection refresh_connection;
+
+    bool refresh();
+    void reset();
+};
+
+#endif
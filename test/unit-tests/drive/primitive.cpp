@@ -0,0 +1,14 @@
+#include "drive/primitive.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+TEST(LLPrimitiveTest, short_parameter_lists_are_zero_filled)
+{
+    Drive::LLPrimitive p = Drive::move_catch(1.0, 2000.0, 0.05);
+    EXPECT_EQ(1.0, p.params[0]);
+    EXPECT_EQ(2000.0, p.params[1]);
+    EXPECT_EQ(0.05, p.params[2]);
+    EXPECT_EQ(0.0, p.params[3]);
+}
+}
@@ -0,0 +1,108 @@
+#include "drive/telemetry.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+using Drive::TelemetryHistory;
+using Field = TelemetryHistory::Field;
+
+TelemetryHistory::Values battery(float v)
+{
+    TelemetryHistory::Values values = TelemetryHistory::empty_values();
+    values[static_cast<std::size_t>(Field::BATTERY_VOLTAGE)] = v;
+    return values;
+}
+
+TEST(TelemetryHistoryTest, test_empty)
+{
+    std::unique_ptr<TelemetryHistory> h(new TelemetryHistory);
+    EXPECT_EQ(0U, h->size());
+    TelemetryHistory::Aggregate agg =
+        h->aggregate(Field::BATTERY_VOLTAGE, std::chrono::seconds(10));
+    EXPECT_EQ(0U, agg.count);
+    EXPECT_TRUE(std::isnan(agg.mean));
+}
+
+TEST(TelemetryHistoryTest, test_append_and_index)
+{
+    std::unique_ptr<TelemetryHistory> h(new TelemetryHistory);
+    TelemetryHistory::Clock::time_point t0 = TelemetryHistory::Clock::now();
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        h->append(t0 + std::chrono::milliseconds(i), battery(14.0f + i));
+    }
+    EXPECT_EQ(5U, h->size());
+    EXPECT_EQ(t0, h->stamp(0));
+    EXPECT_FLOAT_EQ(14.0f, h->value(Field::BATTERY_VOLTAGE, 0));
+    EXPECT_FLOAT_EQ(18.0f, h->value(Field::BATTERY_VOLTAGE, 4));
+    EXPECT_TRUE(std::isnan(h->value(Field::LINK_QUALITY, 2)));
+}
+
+TEST(TelemetryHistoryTest, test_wraparound)
+{
+    std::unique_ptr<TelemetryHistory> h(new TelemetryHistory);
+    TelemetryHistory::Clock::time_point t0 = TelemetryHistory::Clock::now();
+    const std::size_t total = TelemetryHistory::CAPACITY + 10;
+    for (std::size_t i = 0; i < total; ++i)
+    {
+        h->append(
+            t0 + std::chrono::milliseconds(i),
+            battery(static_cast<float>(i)));
+    }
+    EXPECT_EQ(TelemetryHistory::CAPACITY, h->size());
+    EXPECT_FLOAT_EQ(10.0f, h->value(Field::BATTERY_VOLTAGE, 0));
+    EXPECT_FLOAT_EQ(
+        static_cast<float>(total - 1),
+        h->value(Field::BATTERY_VOLTAGE, TelemetryHistory::CAPACITY - 1));
+    EXPECT_EQ(t0 + std::chrono::milliseconds(10), h->stamp(0));
+
+    h->clear();
+    EXPECT_EQ(0U, h->size());
+}
+
+TEST(TelemetryHistoryTest, test_aggregate_window)
+{
+    std::unique_ptr<TelemetryHistory> h(new TelemetryHistory);
+    TelemetryHistory::Clock::time_point t0 = TelemetryHistory::Clock::now();
+    const float readings[] = {15.0f, 12.0f, 13.0f, 16.0f, 14.0f};
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        h->append(t0 + std::chrono::seconds(i), battery(readings[i]));
+    }
+    TelemetryHistory::Clock::time_point now = t0 + std::chrono::seconds(4);
+
+    TelemetryHistory::Aggregate all = h->aggregate(
+        Field::BATTERY_VOLTAGE, std::chrono::seconds(100), now);
+    EXPECT_EQ(5U, all.count);
+    EXPECT_DOUBLE_EQ(12.0, all.min);
+    EXPECT_DOUBLE_EQ(16.0, all.max);
+    EXPECT_DOUBLE_EQ(14.0, all.mean);
+    EXPECT_DOUBLE_EQ(14.0, all.last);
+
+    // The last two seconds hold the final three records.
+    TelemetryHistory::Aggregate recent =
+        h->aggregate(Field::BATTERY_VOLTAGE, std::chrono::seconds(2), now);
+    EXPECT_EQ(3U, recent.count);
+    EXPECT_DOUBLE_EQ(13.0, recent.min);
+    EXPECT_DOUBLE_EQ(16.0, recent.max);
+    EXPECT_DOUBLE_EQ(43.0 / 3.0, recent.mean);
+    EXPECT_DOUBLE_EQ(14.0, recent.last);
+}
+
+TEST(TelemetryHistoryTest, test_aggregate_skips_absent)
+{
+    std::unique_ptr<TelemetryHistory> h(new TelemetryHistory);
+    TelemetryHistory::Clock::time_point t0 = TelemetryHistory::Clock::now();
+    TelemetryHistory::Values with_lps = battery(14.0f);
+    with_lps[static_cast<std::size_t>(Field::LPS_0)] = 1.5f;
+    h->append(t0, with_lps);
+    h->append(t0 + std::chrono::milliseconds(1), battery(14.0f));
+    TelemetryHistory::Aggregate lps = h->aggregate(
+        Field::LPS_0, std::chrono::seconds(1),
+        t0 + std::chrono::milliseconds(1));
+    EXPECT_EQ(1U, lps.count);
+    EXPECT_DOUBLE_EQ(1.5, lps.last);
+}
+}
@@ -0,0 +1,145 @@
+#include "geom/angle_sweep.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+const Seg GOAL(Point(10, 10), Point(-10, 10));
+
+std::vector<Point> two_obstacles()
+{
+    std::vector<Point> obs;
+    obs.push_back(Point(-9, 10));
+    obs.push_back(Point(9, 10));
+    return obs;
+}
+
+std::vector<Point> three_obstacles()
+{
+    std::vector<Point> obs;
+    obs.push_back(Point(-4, 6));
+    obs.push_back(Point(6, 8));
+    obs.push_back(Point(4, 10));
+    return obs;
+}
+
+TEST(GeomAngleSweepTest, best_matches_known_values)
+{
+    AngleSweep sweep;
+    sweep.set_source(Point(0, 0), two_obstacles(), 1.0);
+    AngleSweep::Window best = sweep.best(GOAL);
+    EXPECT_TRUE((best.target.norm() - Point(0, 1)).len() < 0.0001);
+    EXPECT_NEAR(75.449, best.width.to_degrees(), 1e-4);
+
+    sweep.set_source(Point(0, 0), three_obstacles(), 1.0);
+    best = sweep.best(GOAL);
+    EXPECT_TRUE(
+        (best.target.norm() - Point(-0.0805897, 0.996747)).len() < 0.0001);
+    EXPECT_NEAR(42.1928, best.width.to_degrees(), 1e-4);
+}
+
+TEST(GeomAngleSweepTest, windows_and_coverage)
+{
+    AngleSweep sweep;
+    sweep.set_source(Point(0, 0), two_obstacles(), 1.0);
+    std::vector<AngleSweep::Window> windows = sweep.windows(GOAL);
+    ASSERT_EQ(1U, windows.size());
+    EXPECT_NEAR(75.449, windows[0].width.to_degrees(), 1e-4);
+    EXPECT_NEAR(1.0 - 75.449 / 90.0, sweep.coverage(GOAL), 1e-6);
+
+    // The windows are in counterclockwise order, do not overlap, add up to
+    // the uncovered angle and include the best one.
+    sweep.set_source(Point(0, 0), three_obstacles(), 1.0);
+    windows = sweep.windows(GOAL);
+    ASSERT_LE(2U, windows.size());
+    Angle total = Angle::zero(), widest = Angle::zero();
+    for (std::size_t i = 0; i != windows.size(); ++i)
+    {
+        EXPECT_LT(Angle::zero(), windows[i].width);
+        if (i != 0)
+        {
+            EXPECT_GT(windows[i - 1].target.x, windows[i].target.x);
+        }
+        total += windows[i].width;
+        widest = std::max(widest, windows[i].width);
+    }
+    EXPECT_NEAR(1.0 - total.to_degrees() / 90.0, sweep.coverage(GOAL), 1e-9);
+    EXPECT_EQ(sweep.best(GOAL).width, widest);
+}
+
+TEST(GeomAngleSweepTest, unobstructed_and_behind)
+{
+    // Obstacles behind the source or beside the target do not block it.
+    std::vector<Point> obs;
+    obs.push_back(Point(0, -3));
+    obs.push_back(Point(-12, 10));
+    AngleSweep sweep;
+    sweep.set_source(Point(0, 0), obs, 1.0);
+    std::vector<AngleSweep::Window> windows = sweep.windows(GOAL);
+    ASSERT_EQ(1U, windows.size());
+    EXPECT_NEAR(90.0, windows[0].width.to_degrees(), 1e-9);
+    EXPECT_TRUE((windows[0].target - Point(0, 10)).len() < 1e-9);
+    EXPECT_NEAR(0.0, sweep.coverage(GOAL), 1e-9);
+}
+
+TEST(GeomAngleSweepTest, several_targets)
+{
+    std::vector<Seg> targets;
+    targets.push_back(GOAL);
+    targets.push_back(Seg(Point(-10, -10), Point(10, -10)));
+    targets.push_back(Seg(Point(3, 1), Point(3, 5)));
+    std::vector<Point> obs = three_obstacles();
+    obs.push_back(Point(1, -8));
+    obs.push_back(Point(3, 3));
+
+    AngleSweep sweep;
+    sweep.set_source(Point(0, 0), obs, 0.5);
+    std::vector<AngleSweep::Window> out;
+    sweep.best(targets, out);
+    ASSERT_EQ(targets.size(), out.size());
+
+    // Each answer is the same as from an engine that saw only that target.
+    for (std::size_t i = 0; i != targets.size(); ++i)
+    {
+        AngleSweep single;
+        single.set_source(Point(0, 0), obs, 0.5);
+        AngleSweep::Window expected = single.best(targets[i]);
+        EXPECT_TRUE((expected.target - out[i].target).len() < 1e-9);
+        EXPECT_EQ(expected.width, out[i].width);
+        EXPECT_LT(Angle::zero(), out[i].width);
+    }
+    EXPECT_LT(0.0, sweep.coverage(targets[2]));
+}
+
+TEST(GeomAngleSweepTest, degenerate)
+{
+    AngleSweep sweep;
+
+    // Source inside an obstacle.
+    sweep.set_source(Point(-9, 9.5), two_obstacles(), 1.0);
+    EXPECT_TRUE(sweep.windows(GOAL).empty());
+    EXPECT_EQ(1.0, sweep.coverage(GOAL));
+    AngleSweep::Window best = sweep.best(GOAL);
+    EXPECT_EQ(Angle::zero(), best.width);
+    EXPECT_TRUE((best.target - Point(0, 10)).len() < 1e-9);
+
+    // Source on the target's line.
+    sweep.set_source(Point(20, 10), std::vector<Point>(), 1.0);
+    EXPECT_TRUE(sweep.windows(GOAL).empty());
+    EXPECT_EQ(Angle::zero(), sweep.best(GOAL).width);
+
+    // Fully blocked.
+    std::vector<Point> wall;
+    for (int x = -10; x <= 10; ++x)
+    {
+        wall.push_back(Point(x, 5));
+    }
+    sweep.set_source(Point(0, 0), wall, 0.6);
+    EXPECT_TRUE(sweep.windows(GOAL).empty());
+    EXPECT_EQ(1.0, sweep.coverage(GOAL));
+}
+}
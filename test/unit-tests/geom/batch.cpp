@@ -0,0 +1,168 @@
+#include "geom/batch.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+// Sizes that leave every possible remainder after whole vectors.
+const std::size_t SIZES[] = {0, 1, 2, 3, 4, 5, 7, 12, 37, 1000};
+
+PointSet random_points(std::mt19937 &rng, std::size_t n)
+{
+    std::uniform_real_distribution<double> coord(-5.0, 5.0);
+    PointSet points;
+    points.reserve(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        points.push_back(Vector2(coord(rng), coord(rng)));
+    }
+    return points;
+}
+
+TEST(GeomBatchTest, distsq_matches_scalar)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(-5.0, 5.0);
+    for (std::size_t n : SIZES)
+    {
+        PointSet points = random_points(rng, n);
+        Seg seg(
+            Vector2(coord(rng), coord(rng)), Vector2(coord(rng), coord(rng)));
+        std::unique_ptr<double[]> sq(new double[n + 1]), d(new double[n + 1]);
+        distsq(seg, points, sq.get());
+        dist(seg, points, d.get());
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            EXPECT_NEAR(distsq(points[i], seg), sq[i], 1e-9);
+            EXPECT_NEAR(dist(points[i], seg), d[i], 1e-9);
+        }
+    }
+}
+
+TEST(GeomBatchTest, distsq_degenerate_segment)
+{
+    std::mt19937 rng(2);
+    PointSet points = random_points(rng, 9);
+    Seg seg(Vector2(1, 2), Vector2(1, 2));
+    double d[9];
+    dist(seg, points, d);
+    for (std::size_t i = 0; i != points.size(); ++i)
+    {
+        EXPECT_NEAR((points[i] - seg.start).len(), d[i], 1e-9);
+    }
+}
+
+TEST(GeomBatchTest, intersects_matches_scalar)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coord(-5.0, 5.0),
+        radius(0.05, 3.0);
+    for (std::size_t n : SIZES)
+    {
+        CircleSet circles;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            circles.push_back(
+                Circle(Vector2(coord(rng), coord(rng)), radius(rng)));
+        }
+        Seg seg(
+            Vector2(coord(rng), coord(rng)), Vector2(coord(rng), coord(rng)));
+        std::unique_ptr<bool[]> out(new bool[n + 1]);
+        std::size_t count = intersects(seg, circles, out.get()), expected = 0;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            bool scalar = intersects(seg, circles[i]);
+            EXPECT_EQ(scalar, out[i]) << "circle " << i << " of " << n;
+            expected += scalar;
+        }
+        EXPECT_EQ(expected, count);
+    }
+}
+
+TEST(GeomBatchTest, intersects_cases)
+{
+    CircleSet circles;
+    circles.push_back(Circle(Vector2(0, 1), 0.5));   // Crossed.
+    circles.push_back(Circle(Vector2(0, 0), 10.0));  // Segment inside.
+    circles.push_back(Circle(Vector2(0, 5), 0.5));   // Missed.
+    circles.push_back(Circle(Vector2(2, 0), 0.5));   // End inside.
+    Seg seg(Vector2(-2, 1), Vector2(2, 0));
+    bool out[4];
+    EXPECT_EQ(2U, intersects(seg, circles, out));
+    EXPECT_TRUE(out[0]);
+    EXPECT_FALSE(out[1]);
+    EXPECT_FALSE(out[2]);
+    EXPECT_TRUE(out[3]);
+}
+
+TEST(GeomBatchTest, contains_matches_scalar)
+{
+    std::mt19937 rng(4);
+    Rect rect(Point(-1.5, -2.0), Point(3.0, 1.0));
+    for (std::size_t n : SIZES)
+    {
+        PointSet points = random_points(rng, n);
+        std::unique_ptr<bool[]> out(new bool[n + 1]);
+        std::size_t count = contains(rect, points, out.get()), expected = 0;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            bool scalar = contains(rect, points[i]);
+            EXPECT_EQ(scalar, out[i]);
+            expected += scalar;
+        }
+        EXPECT_EQ(expected, count);
+    }
+
+    // Edges and corners are inside.
+    PointSet edges;
+    edges.push_back(Vector2(-1.5, -2.0));
+    edges.push_back(Vector2(3.0, 1.0));
+    edges.push_back(Vector2(0.0, 1.0));
+    edges.push_back(Vector2(3.0 + 1e-12, 0.0));
+    bool out[4];
+    EXPECT_EQ(3U, contains(rect, edges, out));
+    EXPECT_FALSE(out[3]);
+}
+
+TEST(GeomBatchTest, fast_trig_matches_scalar)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> angle(-10.0, 10.0), unit(-1.0, 1.0);
+    for (std::size_t n : SIZES)
+    {
+        std::vector<double> a(n), s(n), out(n + 1);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            a[i] = angle(rng);
+            s[i] = unit(rng);
+        }
+        PointSet points = random_points(rng, n);
+
+        fast_sin(a.data(), n, out.data());
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            EXPECT_EQ(Angle::of_radians(a[i]).fast_sin(), out[i]);
+        }
+        fast_cos(a.data(), n, out.data());
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            EXPECT_EQ(Angle::of_radians(a[i]).fast_cos(), out[i]);
+        }
+        fast_asin(s.data(), n, out.data());
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            EXPECT_EQ(Angle::fast_asin(s[i]).to_radians(), out[i]);
+        }
+        fast_orientation(points, out.data());
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            EXPECT_EQ(points[i].fast_orientation().to_radians(), out[i]);
+        }
+    }
+}
+}
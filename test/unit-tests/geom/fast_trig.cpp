@@ -0,0 +1,98 @@
+#include "geom/fast_trig.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "geom/angle.h"
+#include "geom/point.h"
+
+namespace
+{
+// The bounds documented in geom/fast_trig.h.
+const double DOUBLE_SIN_ERROR   = 2e-11;
+const double DOUBLE_ATAN2_ERROR = 3e-8;
+const double DOUBLE_ASIN_ERROR  = 2e-8;
+const double FLOAT_ERROR        = 3e-7;
+
+TEST(FastTrigTest, sin_cos_match_libm)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> angle(-1e4, 1e4);
+    for (int i = 0; i != 100000; ++i)
+    {
+        const Angle a = Angle::of_radians(angle(rng));
+        EXPECT_NEAR(a.sin(), a.fast_sin(), DOUBLE_SIN_ERROR);
+        EXPECT_NEAR(a.cos(), a.fast_cos(), DOUBLE_SIN_ERROR);
+
+        const BasicAngle<float> f(a);
+        const double r = f.to_radians();
+        EXPECT_NEAR(std::sin(r), f.fast_sin(), FLOAT_ERROR);
+        EXPECT_NEAR(std::cos(r), f.fast_cos(), FLOAT_ERROR);
+    }
+
+    // Quadrant boundaries and large arguments.
+    for (int k = -8; k <= 8; ++k)
+    {
+        const Angle a = Angle::of_radians(k * M_PI / 4);
+        EXPECT_NEAR(a.sin(), a.fast_sin(), DOUBLE_SIN_ERROR);
+        EXPECT_NEAR(a.cos(), a.fast_cos(), DOUBLE_SIN_ERROR);
+    }
+    const Angle big = Angle::of_radians(-9.87654321e7);
+    EXPECT_NEAR(big.sin(), big.fast_sin(), DOUBLE_SIN_ERROR);
+    EXPECT_NEAR(big.cos(), big.fast_cos(), DOUBLE_SIN_ERROR);
+}
+
+TEST(FastTrigTest, asin_matches_libm)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    for (int i = 0; i != 100000; ++i)
+    {
+        const double x = value(rng);
+        EXPECT_NEAR(
+            Angle::asin(x).to_radians(), Angle::fast_asin(x).to_radians(),
+            DOUBLE_ASIN_ERROR);
+        const float f = static_cast<float>(x);
+        EXPECT_NEAR(
+            std::asin(static_cast<double>(f)),
+            BasicAngle<float>::fast_asin(f).to_radians(), FLOAT_ERROR);
+    }
+    for (double x : {-1.0, -0.5, 0.0, 0.5, 1.0})
+    {
+        EXPECT_NEAR(
+            std::asin(x), Angle::fast_asin(x).to_radians(), DOUBLE_ASIN_ERROR);
+    }
+    EXPECT_TRUE(std::isnan(Angle::fast_asin(1.5).to_radians()));
+}
+
+TEST(FastTrigTest, orientation_matches_libm)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    for (int i = 0; i != 100000; ++i)
+    {
+        const Point p(coord(rng), coord(rng));
+        EXPECT_NEAR(
+            p.orientation().to_radians(), p.fast_orientation().to_radians(),
+            DOUBLE_ATAN2_ERROR);
+        const BasicPoint<float> f(p);
+        EXPECT_NEAR(
+            std::atan2(static_cast<double>(f.y), static_cast<double>(f.x)),
+            f.fast_orientation().to_radians(), FLOAT_ERROR);
+    }
+
+    // Axes, diagonals and the origin.
+    for (int k = -3; k <= 4; ++k)
+    {
+        const Point p = Point::of_angle(Angle::of_radians(k * M_PI / 4)) * 3.0;
+        EXPECT_NEAR(
+            std::atan2(p.y, p.x), p.fast_orientation().to_radians(),
+            DOUBLE_ATAN2_ERROR);
+    }
+    EXPECT_EQ(0.0, Point().fast_orientation().to_radians());
+    EXPECT_NEAR(
+        M_PI, Angle::fast_atan2(0.0, -2.0).to_radians(), DOUBLE_ATAN2_ERROR);
+    EXPECT_NEAR(
+        -M_PI / 2, Angle::fast_atan2(-1e-300, 0.0).to_radians(),
+        DOUBLE_ATAN2_ERROR);
+}
+}
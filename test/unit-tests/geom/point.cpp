@@ -0,0 +1,103 @@
+#include "geom/point.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "geom/util.h"
+
+namespace
+{
+typedef BasicPoint<float> PointF;
+typedef BasicAngle<float> AngleF;
+
+// Field coordinates are a few metres, so single precision should agree with
+// double to within a few micrometres.
+const double TOLERANCE = 1e-5;
+
+TEST(PointTest, float_matches_double)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-5.0, 5.0), turn(-M_PI, M_PI);
+    for (unsigned int i = 0; i != 1000; ++i)
+    {
+        const Point p(coord(rng), coord(rng)), q(coord(rng), coord(rng));
+        const Angle rot = Angle::of_radians(turn(rng));
+        const PointF pf(p), qf(q);
+        const AngleF rotf(rot);
+
+        EXPECT_NEAR(p.len(), pf.len(), TOLERANCE);
+        EXPECT_NEAR(p.dot(q), pf.dot(qf), 10 * TOLERANCE);
+        EXPECT_NEAR(p.cross(q), pf.cross(qf), 10 * TOLERANCE);
+        EXPECT_TRUE(p.rotate(rot).close(Point(pf.rotate(rotf)), TOLERANCE));
+        EXPECT_TRUE(p.norm().close(Point(pf.norm()), TOLERANCE));
+        EXPECT_NEAR(
+            p.orientation().to_radians(), pf.orientation().to_radians(),
+            TOLERANCE);
+        EXPECT_NEAR(
+            rot.angle_diff(p.orientation()).to_radians(),
+            rotf.angle_diff(pf.orientation()).to_radians(), TOLERANCE);
+    }
+}
+
+TEST(PointTest, geom_util_float_matches_double)
+{
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<double> coord(-5.0, 5.0);
+    for (unsigned int i = 0; i != 1000; ++i)
+    {
+        const Point a(coord(rng), coord(rng)), b(coord(rng), coord(rng)),
+            c(coord(rng), coord(rng)), d(coord(rng), coord(rng));
+        const PointF af(a), bf(b), cf(c), df(d);
+
+        // Directions taken from short segments lose most of their precision.
+        if (Geom::dist(a, b) < 0.5 || Geom::dist(c, d) < 0.5)
+        {
+            continue;
+        }
+        EXPECT_NEAR(Geom::dist(a, b), Geom::dist(af, bf), TOLERANCE);
+        EXPECT_NEAR(
+            Geom::distsq(a, b), Geom::distsq(af, bf), 100 * TOLERANCE);
+        EXPECT_TRUE(closest_lineseg_point(a, b, c)
+                        .close(Point(closest_lineseg_point(af, bf, cf)),
+                               TOLERANCE));
+        EXPECT_NEAR(
+            offset_to_line(a, b, c), offset_to_line(af, bf, cf), TOLERANCE);
+        EXPECT_NEAR(
+            offset_along_line(a, b, c), offset_along_line(af, bf, cf),
+            TOLERANCE);
+        const double t = closest_point_time(a, b, c, d);
+        EXPECT_NEAR(
+            t, closest_point_time(af, bf, cf, df),
+            TOLERANCE * std::max(1.0, t));
+
+        // Only lines that cross at a reasonable angle have a well-conditioned
+        // intersection.
+        if (std::fabs((b - a).norm().cross((d - c).norm())) > 0.2)
+        {
+            Point x = line_intersect(a, b, c, d);
+            if (x.len() < 50.0)
+            {
+                EXPECT_TRUE(x.close(
+                    Point(line_intersect(af, bf, cf, df)), 100 * TOLERANCE));
+            }
+        }
+    }
+}
+
+TEST(PointTest, precision_conversion)
+{
+    const Point p(1.0 / 3.0, -2.0 / 3.0);
+    const PointF pf(p);
+    EXPECT_FLOAT_EQ(1.0f / 3.0f, pf.x);
+    EXPECT_FLOAT_EQ(-2.0f / 3.0f, pf.y);
+    EXPECT_TRUE(p.close(Point(pf), 1e-7));
+    EXPECT_EQ(Point(pf), Point(PointF(Point(pf))));
+
+    EXPECT_FLOAT_EQ(90.0f, AngleF::quarter().to_degrees());
+    EXPECT_FLOAT_EQ(
+        static_cast<float>(M_PI / 6),
+        AngleF(Angle::of_degrees(30)).to_radians());
+    EXPECT_FLOAT_EQ(
+        -90.0f, AngleF::of_degrees(270.0f).angle_mod().to_degrees());
+}
+}
@@ -0,0 +1,145 @@
+#include "geom/spatial_index.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "geom/util.h"
+
+using namespace Geom;
+
+namespace
+{
+const Rect FIELD(Point(-4.7, -3.2), Point(4.7, 3.2));
+
+// Points spread a little past the field so some land in the edge cells.
+std::vector<Point> random_points(std::mt19937 &rng, std::size_t n)
+{
+    std::uniform_real_distribution<double> x(-6.0, 6.0), y(-4.0, 4.0);
+    std::vector<Point> points;
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        points.push_back(Point(x(rng), y(rng)));
+    }
+    return points;
+}
+
+TEST(GeomSpatialIndexTest, within_radius_matches_scan)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> x(-6.0, 6.0), y(-4.0, 4.0),
+        radius(0.0, 3.0);
+    SpatialIndex index(FIELD, 0.5);
+    std::vector<std::size_t> out;
+    for (std::size_t n : {0, 1, 12, 24, 100})
+    {
+        std::vector<Point> points = random_points(rng, n);
+        index.build(points);
+        EXPECT_EQ(n, index.size());
+        for (unsigned int q = 0; q != 200; ++q)
+        {
+            Point centre(x(rng), y(rng));
+            double r = radius(rng);
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i != points.size(); ++i)
+            {
+                if (distsq(points[i], centre) <= r * r)
+                {
+                    expected.push_back(i);
+                }
+            }
+            index.within(centre, r, out);
+            EXPECT_EQ(expected, out);
+        }
+    }
+}
+
+TEST(GeomSpatialIndexTest, within_segment_matches_scan)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> x(-6.0, 6.0), y(-4.0, 4.0),
+        radius(0.0, 1.0);
+    SpatialIndex index(FIELD, 0.4);
+    std::vector<std::size_t> out;
+    for (std::size_t n : {0, 1, 12, 24, 100})
+    {
+        std::vector<Point> points = random_points(rng, n);
+        index.build(points);
+        for (unsigned int q = 0; q != 400; ++q)
+        {
+            Point a(x(rng), y(rng)), b(x(rng), y(rng));
+            // Also cover horizontal, vertical and degenerate paths.
+            switch (q % 4)
+            {
+                case 1:
+                    b.y = a.y;
+                    break;
+                case 2:
+                    b.x = a.x;
+                    break;
+                case 3:
+                    b = a;
+                    break;
+            }
+            Seg path(a, b);
+            double r = radius(rng);
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i != points.size(); ++i)
+            {
+                if (distsq(points[i], path) <= r * r)
+                {
+                    expected.push_back(i);
+                }
+            }
+            index.within(path, r, out);
+            EXPECT_EQ(expected, out);
+        }
+    }
+}
+
+TEST(GeomSpatialIndexTest, nearest_matches_scan)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> x(-8.0, 8.0), y(-6.0, 6.0);
+    SpatialIndex index(FIELD, 0.3);
+    for (std::size_t n : {1, 2, 12, 24, 100})
+    {
+        std::vector<Point> points = random_points(rng, n);
+        index.build(points);
+        for (unsigned int q = 0; q != 200; ++q)
+        {
+            Point p(x(rng), y(rng));
+            std::size_t expected = 0;
+            for (std::size_t i = 1; i != points.size(); ++i)
+            {
+                if (distsq(points[i], p) < distsq(points[expected], p))
+                {
+                    expected = i;
+                }
+            }
+            EXPECT_EQ(expected, index.nearest(p));
+        }
+    }
+}
+
+TEST(GeomSpatialIndexTest, nearest_ties_and_empty)
+{
+    SpatialIndex index(FIELD, 0.5);
+    index.build(std::vector<Point>());
+    EXPECT_EQ(0U, index.nearest(Point(0, 0)));
+
+    std::vector<Point> points;
+    points.push_back(Point(2, 1));
+    points.push_back(Point(-1, 0));
+    points.push_back(Point(1, 0));
+    index.build(points);
+    EXPECT_EQ(1U, index.nearest(Point(0, 0)));
+    EXPECT_EQ(0U, index.nearest(Point(3, 2)));
+
+    // Rebuilding replaces the old points.
+    points.resize(1);
+    index.build(points);
+    EXPECT_EQ(0U, index.nearest(Point(-1, 0)));
+    std::vector<std::size_t> out;
+    index.within(Point(0, 0), 10.0, out);
+    EXPECT_EQ(std::vector<std::size_t>(1, 0), out);
+}
+}
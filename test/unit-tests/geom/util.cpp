@@ -239,6 +239,28 @@ TEST(GeomUtilTest, test_dist_matching)
     EXPECT_TRUE(match[1] == 2);
     EXPECT_TRUE(match[2] == 1);
     EXPECT_TRUE(match[3] == 3);
+
+    // A matching that is not its own inverse, and a set small enough that it
+    // once took a different path.
+    v1.clear();
+    v2.clear();
+    v1.push_back(Point(0, 0));
+    v1.push_back(Point(5, 0));
+    v1.push_back(Point(10, 0));
+    v2.push_back(Point(10, 1));
+    v2.push_back(Point(0, 1));
+    v2.push_back(Point(5, 1));
+
+    match = dist_matching(v1, v2);
+
+    EXPECT_TRUE(match[0] == 1);
+    EXPECT_TRUE(match[1] == 2);
+    EXPECT_TRUE(match[2] == 0);
+
+    v1.resize(1);
+    v2.resize(1);
+    match = dist_matching(v1, v2);
+    EXPECT_TRUE(match.size() == 1 && match[0] == 0);
 }
 
 TEST(GeomUtilTest, test_angle_sweep_circles)
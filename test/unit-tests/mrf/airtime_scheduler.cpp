@@ -0,0 +1,102 @@
+#include "mrf/airtime_scheduler.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace
+{
+typedef MRFAirtimeScheduler::Clock Clock;
+typedef MRFAirtimeScheduler::Class Class;
+
+TEST(AirtimeSchedulerTest, test_airtime)
+{
+    MRFAirtimeScheduler s(250);
+    EXPECT_EQ(
+        std::chrono::microseconds(32 * (64 + 17)),
+        std::chrono::duration_cast<std::chrono::microseconds>(s.airtime(64)));
+    s.set_bit_rate(625);
+    EXPECT_EQ(
+        std::chrono::microseconds(64 + 17) * 64 / 5,
+        std::chrono::duration_cast<std::chrono::microseconds>(s.airtime(64)));
+}
+
+TEST(AirtimeSchedulerTest, test_drive_and_camera_starve_messages)
+{
+    Clock::time_point t = Clock::now();
+    MRFAirtimeScheduler s(250, 0.5, std::chrono::milliseconds(10));
+    EXPECT_TRUE(s.admit_message(20, t));
+
+    // A burst of drive and camera packets uses up the bucket.
+    for (unsigned int i = 0; i != 4; ++i)
+    {
+        s.submitted(Class::DRIVE, 64, t);
+        s.submitted(Class::CAMERA, 55, t);
+    }
+    EXPECT_EQ(4U, s.in_flight(Class::DRIVE));
+    EXPECT_EQ(4U, s.in_flight(Class::CAMERA));
+    EXPECT_FALSE(s.admit_message(20, t));
+
+    // The bucket refills at half of wall time.
+    Clock::duration delay = s.message_delay(20, t);
+    EXPECT_GT(delay, Clock::duration::zero());
+    EXPECT_LE(delay, std::chrono::milliseconds(40));
+    EXPECT_FALSE(s.admit_message(20, t + delay / 2));
+    EXPECT_TRUE(s.admit_message(20, t + delay + std::chrono::microseconds(1)));
+}
+
+TEST(AirtimeSchedulerTest, test_message_in_flight_limit)
+{
+    Clock::time_point t = Clock::now();
+    MRFAirtimeScheduler s(250, 1.0, std::chrono::seconds(1));
+    for (unsigned int i = 0; i != MRFAirtimeScheduler::MAX_MESSAGES_IN_FLIGHT;
+         ++i)
+    {
+        ASSERT_TRUE(s.admit_message(10, t));
+        s.submitted(Class::MESSAGE, 10, t);
+    }
+    EXPECT_FALSE(s.admit_message(10, t));
+    EXPECT_EQ(Clock::duration::max(), s.message_delay(10, t));
+    s.completed(Class::MESSAGE);
+    EXPECT_TRUE(s.admit_message(10, t));
+}
+
+TEST(AirtimeSchedulerTest, test_backoff)
+{
+    Clock::time_point t = Clock::now();
+    MRFAirtimeScheduler s;
+    s.set_transmit_queue_full(true, t);
+    EXPECT_TRUE(s.backing_off(t));
+    EXPECT_FALSE(s.admit_message(10, t));
+    EXPECT_EQ(Clock::duration::max(), s.message_delay(10, t));
+
+    // After clearing, messages wait out the minimum backoff.
+    s.set_transmit_queue_full(false, t);
+    EXPECT_EQ(MRFAirtimeScheduler::MIN_BACKOFF, s.message_delay(10, t));
+    EXPECT_FALSE(s.admit_message(10, t));
+    t += MRFAirtimeScheduler::MIN_BACKOFF;
+    EXPECT_TRUE(s.admit_message(10, t));
+
+    // Filling again soon after doubles the backoff.
+    s.set_transmit_queue_full(true, t);
+    s.set_transmit_queue_full(false, t);
+    EXPECT_EQ(2 * MRFAirtimeScheduler::MIN_BACKOFF, s.message_delay(10, t));
+
+    // A long quiet spell resets it.
+    t += std::chrono::seconds(1);
+    s.set_transmit_queue_full(true, t);
+    s.set_transmit_queue_full(false, t);
+    EXPECT_EQ(MRFAirtimeScheduler::MIN_BACKOFF, s.message_delay(10, t));
+    EXPECT_EQ(3U, s.backoffs());
+}
+
+TEST(AirtimeSchedulerTest, test_occupancy)
+{
+    MRFAirtimeScheduler s;
+    s.set_queued(Class::MESSAGE, 3);
+    s.set_queued(Class::MESSAGE, 1);
+    EXPECT_EQ(1U, s.queued(Class::MESSAGE));
+    EXPECT_EQ(3U, s.peak_queued(Class::MESSAGE));
+    EXPECT_EQ(0U, s.queued(Class::DRIVE));
+    s.reset_statistics();
+    EXPECT_EQ(1U, s.peak_queued(Class::MESSAGE));
+}
+}
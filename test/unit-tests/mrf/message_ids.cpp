@@ -0,0 +1,170 @@
+#include "mrf/message_ids.h"
+#include <glibmm/main.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "util/async_combinators.h"
+
+namespace
+{
+/**
+ * \brief A reliable message that holds its ID the way
+ * MRFDongle::SendReliableMessageOperation does, completed by hand.
+ */
+class FakeMessage final : public AsyncOperation<void>
+{
+   public:
+    explicit FakeMessage(MRFMessageIDPool &pool)
+        : pool(pool), id(pool.alloc()), reported(false)
+    {
+    }
+
+    ~FakeMessage()
+    {
+        if (!reported)
+        {
+            pool.abandon(id);
+        }
+    }
+
+    void deliver()
+    {
+        reported = true;
+        pool.free(id);
+        signal_done.emit(*this);
+    }
+
+    void result() const override
+    {
+    }
+
+    MRFMessageIDPool &pool;
+    const uint8_t id;
+
+   private:
+    bool reported;
+};
+
+TEST(MessageIDPoolTest, test_alloc_and_free)
+{
+    MRFMessageIDPool pool;
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+    std::vector<bool> seen(MRFMessageIDPool::SIZE, false);
+    for (std::size_t i = 0; i != MRFMessageIDPool::SIZE; ++i)
+    {
+        uint8_t id = pool.alloc();
+        EXPECT_FALSE(seen[id]);
+        seen[id] = true;
+    }
+    EXPECT_EQ(0U, pool.available());
+    EXPECT_THROW(pool.alloc(), std::runtime_error);
+    pool.free(17);
+    EXPECT_EQ(17U, pool.alloc());
+}
+
+TEST(MessageIDPoolTest, test_report_for_live_id_is_ignored)
+{
+    MRFMessageIDPool pool;
+    uint8_t id = pool.alloc();
+    pool.report(id);
+    EXPECT_EQ(MRFMessageIDPool::SIZE - 1, pool.available());
+    pool.free(id);
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+}
+
+TEST(MessageIDPoolTest, test_timeout_then_late_report)
+{
+    MRFMessageIDPool pool;
+    FakeMessage *message = new FakeMessage(pool);
+    const uint8_t id     = message->id;
+    auto op              = Async::with_timeout(
+        std::unique_ptr<FakeMessage>(message), std::chrono::milliseconds(1));
+    bool done = false;
+    op->signal_done.connect([&done](AsyncOperation<void> &) { done = true; });
+    while (!done)
+    {
+        Glib::MainContext::get_default()->iteration(true);
+    }
+    EXPECT_THROW(op->result(), Async::TimeoutError);
+    op.reset();
+
+    // The message is gone but its report may still come, so the ID is held.
+    EXPECT_EQ(MRFMessageIDPool::SIZE - 1, pool.available());
+    EXPECT_EQ(1U, pool.abandoned());
+
+    pool.report(id);
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+    EXPECT_EQ(0U, pool.abandoned());
+}
+
+TEST(MessageIDPoolTest, test_abandoned_id_ages_out)
+{
+    // A message cancelled before reaching the dongle never gets a report.
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    MRFMessageIDPool pool;
+    uint8_t id = pool.alloc(start);
+    pool.abandon(id, start);
+    EXPECT_EQ(1U, pool.abandoned());
+
+    // The ID is held until the timeout passes.
+    std::chrono::steady_clock::time_point now =
+        start + MRFMessageIDPool::ABANDON_TIMEOUT -
+        std::chrono::milliseconds(1);
+    pool.free(pool.alloc(now));
+    EXPECT_EQ(1U, pool.abandoned());
+    EXPECT_EQ(MRFMessageIDPool::SIZE - 1, pool.available());
+
+    now = start + MRFMessageIDPool::ABANDON_TIMEOUT;
+    pool.free(pool.alloc(now));
+    EXPECT_EQ(0U, pool.abandoned());
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+}
+
+TEST(MessageIDPoolTest, test_reported_id_does_not_age_out_twice)
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    MRFMessageIDPool pool;
+    uint8_t id = pool.alloc(start);
+    pool.abandon(id, start);
+    pool.report(id);
+
+    // Reuse every ID so the reported one is allocated again.
+    std::vector<uint8_t> ids;
+    for (std::size_t i = 0; i != MRFMessageIDPool::SIZE; ++i)
+    {
+        ids.push_back(pool.alloc(start));
+    }
+    EXPECT_EQ(id, ids.back());
+    EXPECT_EQ(0U, pool.available());
+
+    // The stale timeout must not hand out the ID while it is in use.
+    EXPECT_THROW(
+        pool.alloc(start + 2 * MRFMessageIDPool::ABANDON_TIMEOUT),
+        std::runtime_error);
+}
+
+TEST(MessageIDPoolTest, test_timeouts_do_not_exhaust_ids)
+{
+    // Time out more messages than there are IDs, each report arriving late.
+    MRFMessageIDPool pool;
+    for (std::size_t i = 0; i != 2 * MRFMessageIDPool::SIZE; ++i)
+    {
+        uint8_t id;
+        {
+            std::unique_ptr<FakeMessage> message(new FakeMessage(pool));
+            id = message->id;
+        }
+        pool.report(id);
+    }
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+
+    // A delivered message frees its ID straight away.
+    FakeMessage message(pool);
+    message.deliver();
+    EXPECT_EQ(MRFMessageIDPool::SIZE, pool.available());
+}
+}
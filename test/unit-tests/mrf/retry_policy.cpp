@@ -0,0 +1,73 @@
+#include "mrf/retry_policy.h"
+#include <gtest/gtest.h>
+#include "mrf/constants.h"
+
+namespace
+{
+TEST(RetryPolicyTest, test_unheard_robot_gets_max_tries)
+{
+    MRFRetryPolicy p;
+    for (unsigned int i = 0; i != MRFRetryPolicy::NUM_ROBOTS; ++i)
+    {
+        EXPECT_EQ(MRFRetryPolicy::MAX_TRIES, p.tries(i));
+    }
+    p.record_delivery(3, MRF::MDR_STATUS_OK);
+    EXPECT_EQ(MRFRetryPolicy::MAX_TRIES, p.tries(3));
+    EXPECT_EQ(1U, p.report(3).delivered);
+}
+
+TEST(RetryPolicyTest, test_clean_link_uses_few_tries)
+{
+    MRFRetryPolicy p;
+    for (unsigned int i = 0; i != 50; ++i)
+    {
+        p.record_link(0, 250, 200);
+    }
+    EXPECT_EQ(MRFRetryPolicy::MIN_TRIES, p.tries(0));
+    EXPECT_EQ(MRFRetryPolicy::MAX_TRIES, p.tries(1));
+}
+
+TEST(RetryPolicyTest, test_poor_link_uses_more_tries)
+{
+    MRFRetryPolicy p;
+    p.record_link(0, 250, 200);
+    p.record_link(1, 130, 200);
+    p.record_link(2, 250, 15);
+    EXPECT_LT(p.tries(0), p.tries(1));
+    EXPECT_LT(p.tries(1), MRFRetryPolicy::MAX_TRIES);
+    EXPECT_EQ(MRFRetryPolicy::MAX_TRIES, p.tries(2));
+}
+
+TEST(RetryPolicyTest, test_unacknowledged_messages_raise_tries)
+{
+    MRFRetryPolicy p;
+    p.record_link(0, 250, 200);
+    unsigned int clean = p.tries(0);
+    for (unsigned int i = 0; i != 5; ++i)
+    {
+        p.record_delivery(0, MRF::MDR_STATUS_NOT_ACKNOWLEDGED);
+    }
+    EXPECT_GT(p.tries(0), clean);
+    EXPECT_EQ(5U, p.report(0).not_acknowledged);
+
+    // Successes decay the failure rate back down.
+    for (unsigned int i = 0; i != 50; ++i)
+    {
+        p.record_delivery(0, MRF::MDR_STATUS_OK);
+    }
+    EXPECT_EQ(clean, p.tries(0));
+}
+
+TEST(RetryPolicyTest, test_no_clear_channel_does_not_raise_tries)
+{
+    MRFRetryPolicy p;
+    p.record_link(0, 250, 200);
+    unsigned int clean = p.tries(0);
+    for (unsigned int i = 0; i != 10; ++i)
+    {
+        p.record_delivery(0, MRF::MDR_STATUS_NO_CLEAR_CHANNEL);
+    }
+    EXPECT_EQ(clean, p.tries(0));
+    EXPECT_EQ(10U, p.report(0).no_clear_channel);
+}
+}
@@ -0,0 +1,201 @@
+#include "util/assignment.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+/**
+ * \brief Finds the best matching by trying every one: the most pairs within
+ * the gate, then the least cost.
+ */
+std::pair<std::size_t, double> brute_force(
+    const std::vector<std::vector<double>> &costs, std::size_t cols,
+    double gate)
+{
+    const std::size_t rows = costs.size(), n = std::max(rows, cols);
+    std::vector<std::size_t> perm(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        perm[i] = i;
+    }
+    std::pair<std::size_t, double> best(0, 0.0);
+    bool first = true;
+    do
+    {
+        std::size_t pairs = 0;
+        double total      = 0.0;
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            if (perm[i] < cols && costs[i][perm[i]] <= gate)
+            {
+                ++pairs;
+                total += costs[i][perm[i]];
+            }
+        }
+        if (first || pairs > best.first ||
+            (pairs == best.first && total < best.second))
+        {
+            best  = std::make_pair(pairs, total);
+            first = false;
+        }
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return best;
+}
+
+void check_consistent(const Assignment &a, double gate)
+{
+    for (std::size_t i = 0; i != a.rows(); ++i)
+    {
+        std::size_t j = a.row_match(i);
+        if (j != Assignment::UNASSIGNED)
+        {
+            EXPECT_EQ(i, a.col_match(j));
+        }
+    }
+    for (std::size_t j = 0; j != a.cols(); ++j)
+    {
+        std::size_t i = a.col_match(j);
+        if (i != Assignment::UNASSIGNED)
+        {
+            EXPECT_EQ(j, a.row_match(i));
+            EXPECT_LE(a.cost(i, j), gate);
+        }
+    }
+}
+
+std::size_t count_pairs(const Assignment &a)
+{
+    std::size_t pairs = 0;
+    for (std::size_t i = 0; i != a.rows(); ++i)
+    {
+        pairs += a.row_match(i) != Assignment::UNASSIGNED;
+    }
+    return pairs;
+}
+
+TEST(AssignmentTest, matches_brute_force)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> cost(-2.0, 10.0);
+    std::uniform_int_distribution<std::size_t> dim(0, 6);
+    const double gates[] = {1e9, 6.0, 2.0};
+    Assignment a;
+    for (unsigned int trial = 0; trial != 300; ++trial)
+    {
+        const std::size_t rows = dim(rng), cols = dim(rng);
+        const double gate      = gates[trial % 3];
+        std::vector<std::vector<double>> costs(
+            rows, std::vector<double>(cols));
+        a.resize(rows, cols);
+        a.set_gate(gate);
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            for (std::size_t j = 0; j != cols; ++j)
+            {
+                costs[i][j] = a.cost(i, j) = cost(rng);
+            }
+        }
+        // Every other trial starts from the previous trial's unrelated
+        // solution, which must not change the answer.
+        if (trial % 2)
+        {
+            a.reset();
+        }
+        a.solve();
+        std::pair<std::size_t, double> expected =
+            brute_force(costs, cols, gate);
+        EXPECT_EQ(expected.first, count_pairs(a));
+        EXPECT_NEAR(expected.second, a.total_cost(), 1e-9);
+        check_consistent(a, gate);
+    }
+}
+
+TEST(AssignmentTest, warm_start_tracks_motion)
+{
+    // Tracks move a little each frame and detections arrive shuffled, with
+    // some missing and some spurious.
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> coord(-4.0, 4.0),
+        jitter(-0.02, 0.02);
+    const std::size_t TRACKS = 12;
+    std::vector<double> tx(TRACKS), ty(TRACKS);
+    for (std::size_t j = 0; j != TRACKS; ++j)
+    {
+        tx[j] = coord(rng);
+        ty[j] = coord(rng);
+    }
+    Assignment warm, cold;
+    std::size_t searches = 0;
+    for (unsigned int frame = 0; frame != 100; ++frame)
+    {
+        std::vector<std::pair<double, double>> detections;
+        for (std::size_t j = 0; j != TRACKS; ++j)
+        {
+            tx[j] += jitter(rng);
+            ty[j] += jitter(rng);
+            if ((frame + j) % 17 != 0)
+            {
+                detections.push_back(std::make_pair(tx[j], ty[j]));
+            }
+        }
+        if (frame % 5 == 0)
+        {
+            detections.push_back(std::make_pair(coord(rng), coord(rng)));
+        }
+        std::shuffle(detections.begin(), detections.end(), rng);
+
+        for (Assignment *a : {&warm, &cold})
+        {
+            a->resize(detections.size(), TRACKS);
+            a->set_gate(0.5);
+            for (std::size_t i = 0; i != detections.size(); ++i)
+            {
+                for (std::size_t j = 0; j != TRACKS; ++j)
+                {
+                    double dx = detections[i].first - tx[j],
+                           dy = detections[i].second - ty[j];
+                    a->cost(i, j) = std::sqrt(dx * dx + dy * dy);
+                }
+            }
+        }
+        cold.reset();
+        cold.solve();
+        warm.solve();
+        EXPECT_EQ(count_pairs(cold), count_pairs(warm));
+        EXPECT_NEAR(cold.total_cost(), warm.total_cost(), 1e-9);
+        check_consistent(warm, 0.5);
+        if (frame != 0)
+        {
+            searches += warm.augmentations();
+        }
+    }
+    // Shuffled rows still find their columns from the duals alone, so few
+    // searches are needed beyond those for spurious or missing detections.
+    EXPECT_LT(searches, 100U * TRACKS / 4);
+}
+
+TEST(AssignmentTest, unchanged_costs_need_no_search)
+{
+    Assignment a;
+    a.resize(3, 3);
+    const double costs[3][3] = {{4, 1, 3}, {2, 0, 5}, {3, 2, 2}};
+    for (std::size_t i = 0; i != 3; ++i)
+    {
+        for (std::size_t j = 0; j != 3; ++j)
+        {
+            a.cost(i, j) = costs[i][j];
+        }
+    }
+    a.solve();
+    EXPECT_EQ(5.0, a.total_cost());
+    EXPECT_EQ(1U, a.row_match(0));
+    EXPECT_EQ(0U, a.row_match(1));
+    EXPECT_EQ(2U, a.row_match(2));
+    a.solve();
+    EXPECT_EQ(0U, a.augmentations());
+    EXPECT_EQ(5.0, a.total_cost());
+}
+}
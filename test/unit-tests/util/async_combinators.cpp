@@ -0,0 +1,179 @@
+#include "util/async_combinators.h"
+#include <glibmm/main.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/**
+ * \brief An operation completed by hand.
+ */
+class ManualOperation final : public AsyncOperation<int>
+{
+   public:
+    explicit ManualOperation() : value(0), failed(false)
+    {
+    }
+
+    void succeed(int v)
+    {
+        value = v;
+        signal_done.emit(*this);
+    }
+
+    void fail()
+    {
+        failed = true;
+        signal_done.emit(*this);
+    }
+
+    int result() const override
+    {
+        if (failed)
+        {
+            throw std::runtime_error("Manual failure");
+        }
+        return value;
+    }
+
+   private:
+    int value;
+    bool failed;
+};
+
+struct Counter final
+{
+    unsigned int count = 0;
+
+    void operator()(AsyncOperation<void> &)
+    {
+        ++count;
+    }
+};
+
+TEST(AsyncCombinatorsTest, test_then_maps_value)
+{
+    ManualOperation *first = new ManualOperation;
+    auto op = Async::then(
+        std::unique_ptr<ManualOperation>(first), [](int v) { return v * 2; });
+    unsigned int done = 0;
+    op->signal_done.connect([&done](AsyncOperation<int> &) { ++done; });
+    first->succeed(21);
+    EXPECT_EQ(1U, done);
+    EXPECT_EQ(42, op->result());
+}
+
+TEST(AsyncCombinatorsTest, test_then_propagates_failure)
+{
+    ManualOperation *first = new ManualOperation;
+    bool called            = false;
+    auto op                = Async::then(
+        std::unique_ptr<ManualOperation>(first), [&called](int) {
+            called = true;
+        });
+    first->fail();
+    EXPECT_FALSE(called);
+    EXPECT_THROW(op->result(), std::runtime_error);
+    EXPECT_FALSE(op->succeeded());
+}
+
+TEST(AsyncCombinatorsTest, test_then_chains_operation)
+{
+    ManualOperation *first = new ManualOperation, *second = nullptr;
+    auto op                = Async::then(
+        std::unique_ptr<ManualOperation>(first), [&second](int v) {
+            EXPECT_EQ(3, v);
+            second = new ManualOperation;
+            return std::unique_ptr<ManualOperation>(second);
+        });
+    unsigned int done = 0;
+    op->signal_done.connect([&done](AsyncOperation<int> &) { ++done; });
+    first->succeed(3);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0U, done);
+    second->succeed(7);
+    EXPECT_EQ(1U, done);
+    EXPECT_EQ(7, op->result());
+}
+
+TEST(AsyncCombinatorsTest, test_when_all)
+{
+    std::vector<ManualOperation *> raw;
+    std::vector<std::unique_ptr<AsyncOperation<int>>> ops;
+    for (unsigned int i = 0; i != 3; ++i)
+    {
+        raw.push_back(new ManualOperation);
+        ops.emplace_back(raw.back());
+    }
+    auto op = Async::when_all(std::move(ops));
+    Counter done;
+    op->signal_done.connect(std::ref(done));
+    raw[2]->succeed(2);
+    raw[0]->fail();
+    EXPECT_EQ(0U, done.count);
+    raw[1]->succeed(1);
+    EXPECT_EQ(1U, done.count);
+    EXPECT_THROW(op->result(), std::runtime_error);
+    EXPECT_EQ(2, op->operation(2).result());
+}
+
+TEST(AsyncCombinatorsTest, test_then_after_void)
+{
+    ManualOperation *first = new ManualOperation;
+    std::vector<std::unique_ptr<AsyncOperation<int>>> ops;
+    ops.emplace_back(first);
+    auto op = Async::then(Async::when_all(std::move(ops)), []() { return 4; });
+    first->succeed(0);
+    EXPECT_EQ(4, op->result());
+}
+
+TEST(AsyncCombinatorsTest, test_when_any)
+{
+    std::vector<ManualOperation *> raw;
+    std::vector<std::unique_ptr<AsyncOperation<int>>> ops;
+    for (unsigned int i = 0; i != 3; ++i)
+    {
+        raw.push_back(new ManualOperation);
+        ops.emplace_back(raw.back());
+    }
+    auto op           = Async::when_any(std::move(ops));
+    unsigned int done = 0;
+    op->signal_done.connect(
+        [&done](AsyncOperation<std::size_t> &) { ++done; });
+    raw[1]->succeed(5);
+    raw[0]->succeed(6);
+    EXPECT_EQ(1U, done);
+    EXPECT_EQ(1U, op->result());
+    EXPECT_EQ(5, op->operation(op->result()).result());
+}
+
+TEST(AsyncCombinatorsTest, test_with_timeout_completes)
+{
+    ManualOperation *first = new ManualOperation;
+    auto op                = Async::with_timeout(
+        std::unique_ptr<ManualOperation>(first),
+        std::chrono::milliseconds(1000));
+    first->succeed(9);
+    EXPECT_EQ(9, op->result());
+}
+
+TEST(AsyncCombinatorsTest, test_with_timeout_expires)
+{
+    auto op = Async::with_timeout(
+        std::unique_ptr<ManualOperation>(new ManualOperation),
+        std::chrono::milliseconds(1));
+    unsigned int done = 0;
+    op->signal_done.connect([&done](AsyncOperation<int> &) { ++done; });
+    while (!done)
+    {
+        Glib::MainContext::get_default()->iteration(true);
+    }
+    EXPECT_EQ(1U, done);
+    EXPECT_THROW(op->result(), Async::TimeoutError);
+}
+}
@@ -0,0 +1,108 @@
+#include "util/hungarian.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+/**
+ * \brief Finds the largest total weight of a matching by trying every one.
+ */
+double brute_force(const Hungarian &h)
+{
+    const std::size_t n = h.size();
+    std::vector<std::size_t> perm(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        perm[i] = i;
+    }
+    double best = -std::numeric_limits<double>::infinity();
+    do
+    {
+        double total = 0.0;
+        for (std::size_t i = 0; i != h.rows(); ++i)
+        {
+            if (perm[i] < h.cols())
+            {
+                total += h.weight(i, perm[i]);
+            }
+        }
+        best = std::max(best, total);
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return best;
+}
+
+/**
+ * \brief Checks that the matching is consistent and covers the smaller set,
+ * and returns its total weight.
+ */
+double check_matching(const Hungarian &h)
+{
+    double total      = 0.0;
+    std::size_t pairs  = 0;
+    for (std::size_t x = 0; x != h.rows(); ++x)
+    {
+        std::size_t y = h.matchX(x);
+        if (y != Hungarian::NONE)
+        {
+            EXPECT_EQ(x, h.matchY(y));
+            total += h.weight(x, y);
+            ++pairs;
+        }
+    }
+    for (std::size_t y = 0; y != h.cols(); ++y)
+    {
+        std::size_t x = h.matchY(y);
+        if (x != Hungarian::NONE)
+        {
+            EXPECT_EQ(y, h.matchX(x));
+        }
+    }
+    EXPECT_EQ(std::min(h.rows(), h.cols()), pairs);
+    return total;
+}
+
+TEST(HungarianTest, matches_brute_force)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> weight(-5.0, 5.0);
+    std::uniform_int_distribution<int> small(-2, 2);
+    std::uniform_int_distribution<std::size_t> dim(0, 7);
+    Hungarian h(0);
+    for (unsigned int trial = 0; trial != 400; ++trial)
+    {
+        h.resize(dim(rng), dim(rng));
+        for (std::size_t x = 0; x != h.rows(); ++x)
+        {
+            for (std::size_t y = 0; y != h.cols(); ++y)
+            {
+                // Every other trial uses a few integers, which makes many
+                // ties for the reductions to cycle over.
+                h.weight(x, y) = trial % 2 ? weight(rng) : small(rng);
+            }
+        }
+        h.execute();
+        EXPECT_NEAR(brute_force(h), check_matching(h), 1e-9);
+    }
+}
+
+TEST(HungarianTest, rectangular_leaves_unmatched)
+{
+    Hungarian h(2, 3);
+    const double weights[2][3] = {{1, 5, 2}, {4, 6, 0}};
+    for (std::size_t x = 0; x != 2; ++x)
+    {
+        for (std::size_t y = 0; y != 3; ++y)
+        {
+            h.weight(x, y) = weights[x][y];
+        }
+    }
+    h.execute();
+    EXPECT_EQ(1U, h.matchX(0));
+    EXPECT_EQ(0U, h.matchX(1));
+    EXPECT_EQ(Hungarian::NONE, h.matchY(2));
+    EXPECT_EQ(3U, h.size());
+}
+}
@@ -0,0 +1,86 @@
+#include "util/latency_histogram.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+TEST(LatencyHistogramTest, test_empty)
+{
+    LatencyHistogram h;
+    EXPECT_EQ(0U, h.count());
+    EXPECT_EQ(0U, h.min());
+    EXPECT_EQ(0U, h.max());
+    EXPECT_EQ(0.0, h.mean());
+    EXPECT_EQ(0U, h.percentile(0.5));
+}
+
+TEST(LatencyHistogramTest, test_small_values_exact)
+{
+    LatencyHistogram h;
+    h.record_micros(0);
+    h.record_micros(1);
+    h.record_micros(2);
+    h.record_micros(3);
+    EXPECT_EQ(4U, h.count());
+    EXPECT_EQ(0U, h.min());
+    EXPECT_EQ(3U, h.max());
+    EXPECT_DOUBLE_EQ(1.5, h.mean());
+    EXPECT_EQ(0U, h.percentile(0.25));
+    EXPECT_EQ(1U, h.percentile(0.5));
+    EXPECT_EQ(3U, h.percentile(1.0));
+}
+
+TEST(LatencyHistogramTest, test_percentile_error_bound)
+{
+    LatencyHistogram h;
+    for (uint64_t i = 1; i <= 100000; ++i)
+    {
+        h.record_micros(i);
+    }
+    EXPECT_EQ(100000U, h.count());
+    EXPECT_EQ(1U, h.min());
+    EXPECT_EQ(100000U, h.max());
+    const double fractions[] = {0.1, 0.5, 0.9, 0.99, 0.999};
+    for (double f : fractions)
+    {
+        double expected = f * 100000.0;
+        double actual   = static_cast<double>(h.percentile(f));
+        EXPECT_NEAR(expected, actual, expected * 0.25);
+    }
+}
+
+TEST(LatencyHistogramTest, test_percentile_clamped_to_samples)
+{
+    LatencyHistogram h;
+    h.record_micros(1000);
+    EXPECT_EQ(1000U, h.percentile(0.0));
+    EXPECT_EQ(1000U, h.percentile(0.5));
+    EXPECT_EQ(1000U, h.percentile(1.0));
+}
+
+TEST(LatencyHistogramTest, test_duration)
+{
+    LatencyHistogram h;
+    h.record(std::chrono::milliseconds(5));
+    h.record(std::chrono::nanoseconds(-5));
+    EXPECT_EQ(0U, h.min());
+    EXPECT_EQ(5000U, h.max());
+}
+
+TEST(LatencyHistogramTest, test_reset)
+{
+    LatencyHistogram h;
+    h.record_micros(12345);
+    h.reset();
+    EXPECT_EQ(0U, h.count());
+    EXPECT_EQ(0U, h.max());
+    EXPECT_EQ(0U, h.percentile(0.9));
+}
+
+TEST(LatencyHistogramTest, test_huge_values)
+{
+    LatencyHistogram h;
+    h.record_micros(UINT64_MAX);
+    EXPECT_EQ(UINT64_MAX, h.max());
+    EXPECT_EQ(UINT64_MAX, h.percentile(0.5));
+}
+}
@@ -0,0 +1,119 @@
+#include "util/mpsc_queue.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+TEST(MPSCQueueTest, test_empty)
+{
+    MPSCQueue<int, 4> q;
+    int value = 0;
+    EXPECT_EQ(0U, q.size());
+    EXPECT_FALSE(q.pop(value));
+}
+
+TEST(MPSCQueueTest, test_fifo_order)
+{
+    MPSCQueue<int, 8> q;
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_TRUE(q.push(i));
+    }
+    EXPECT_EQ(5U, q.size());
+    for (int i = 0; i < 5; ++i)
+    {
+        int value = -1;
+        EXPECT_TRUE(q.pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_EQ(0U, q.size());
+}
+
+TEST(MPSCQueueTest, test_full)
+{
+    MPSCQueue<int, 4> q;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(q.push(i));
+    }
+    EXPECT_FALSE(q.push(4));
+    int value;
+    EXPECT_TRUE(q.pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(q.push(4));
+    EXPECT_FALSE(q.push(5));
+}
+
+TEST(MPSCQueueTest, test_wraparound)
+{
+    MPSCQueue<int, 4> q;
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(q.push(i));
+        EXPECT_TRUE(q.push(i + 1000));
+        int value;
+        EXPECT_TRUE(q.pop(value));
+        EXPECT_EQ(i, value);
+        EXPECT_TRUE(q.pop(value));
+        EXPECT_EQ(i + 1000, value);
+    }
+}
+
+TEST(MPSCQueueTest, test_move_only)
+{
+    MPSCQueue<std::unique_ptr<int>, 2> q;
+    EXPECT_TRUE(q.push(std::unique_ptr<int>(new int(42))));
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(q.pop(value));
+    ASSERT_TRUE(value.get());
+    EXPECT_EQ(42, *value);
+}
+
+TEST(MPSCQueueTest, test_multiple_producers)
+{
+    const unsigned int PRODUCERS    = 4;
+    const unsigned int PER_PRODUCER = 20000;
+    MPSCQueue<unsigned int, 64> q;
+    std::vector<std::thread> threads;
+    for (unsigned int p = 0; p < PRODUCERS; ++p)
+    {
+        threads.emplace_back([&q, p, PER_PRODUCER]() {
+            for (unsigned int i = 0; i < PER_PRODUCER; ++i)
+            {
+                while (!q.push(p * PER_PRODUCER + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer’s elements must come out in the order it pushed them.
+    std::vector<unsigned int> next(PRODUCERS, 0);
+    unsigned int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER)
+    {
+        unsigned int value;
+        if (q.pop(value))
+        {
+            unsigned int p = value / PER_PRODUCER;
+            ASSERT_LT(p, PRODUCERS);
+            ASSERT_EQ(next[p], value % PER_PRODUCER);
+            ++next[p];
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+    unsigned int value;
+    EXPECT_FALSE(q.pop(value));
+}
+}
@@ -0,0 +1,169 @@
+#include "util/property.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace
+{
+struct Counter final
+{
+    unsigned int count = 0;
+
+    void operator()()
+    {
+        ++count;
+    }
+};
+
+TEST(PropertyTest, test_immediate_notification)
+{
+    Property<int> p(0);
+    unsigned int changing = 0, changed = 0;
+    p.signal_changing().connect([&changing]() { ++changing; });
+    p.signal_changed().connect([&changed]() { ++changed; });
+    p = 1;
+    p = 2;
+    p = 2;
+    EXPECT_EQ(2U, changing);
+    EXPECT_EQ(2U, changed);
+    EXPECT_FALSE(PropertyTransaction::active());
+}
+
+TEST(PropertyTest, test_transaction_coalesces)
+{
+    Property<int> p(0);
+    unsigned int changing = 0, changed = 0;
+    int seen = -1;
+    p.signal_changing().connect([&changing]() { ++changing; });
+    p.signal_changed().connect([&changed, &seen, &p]() {
+        ++changed;
+        seen = p;
+    });
+    {
+        PropertyTransaction t;
+        EXPECT_TRUE(PropertyTransaction::active());
+        p = 1;
+        p = 2;
+        p = 3;
+        EXPECT_EQ(1U, changing);
+        EXPECT_EQ(0U, changed);
+    }
+    EXPECT_EQ(1U, changing);
+    EXPECT_EQ(1U, changed);
+    EXPECT_EQ(3, seen);
+    EXPECT_FALSE(PropertyTransaction::active());
+}
+
+TEST(PropertyTest, test_transaction_without_change)
+{
+    Property<int> p(5);
+    Counter changed;
+    p.signal_changed().connect(std::ref(changed));
+    {
+        PropertyTransaction t;
+        p = 5;
+    }
+    EXPECT_EQ(0U, changed.count);
+}
+
+TEST(PropertyTest, test_nested_transactions)
+{
+    Property<int> p(0);
+    Counter changed;
+    p.signal_changed().connect(std::ref(changed));
+    {
+        PropertyTransaction outer;
+        {
+            PropertyTransaction inner;
+            p = 1;
+        }
+        EXPECT_EQ(0U, changed.count);
+        p = 2;
+    }
+    EXPECT_EQ(1U, changed.count);
+}
+
+TEST(PropertyTest, test_explicit_commit)
+{
+    Property<int> p(0);
+    Counter changed;
+    p.signal_changed().connect(std::ref(changed));
+    PropertyTransaction t;
+    p = 1;
+    t.commit();
+    EXPECT_EQ(1U, changed.count);
+    EXPECT_FALSE(PropertyTransaction::active());
+    p = 2;
+    EXPECT_EQ(2U, changed.count);
+    t.commit();
+    EXPECT_EQ(2U, changed.count);
+}
+
+TEST(PropertyTest, test_group)
+{
+    Property<int> a(0);
+    Property<double> b(0.0);
+    PropertyGroup group;
+    group.add(a);
+    group.add(b);
+    unsigned int group_changed = 0;
+    bool members_notified_first = false;
+    Counter a_changed;
+    a.signal_changed().connect(std::ref(a_changed));
+    group.signal_changed().connect(
+        [&group_changed, &members_notified_first, &a_changed]() {
+            ++group_changed;
+            members_notified_first = a_changed.count == 1;
+        });
+
+    a = 1;
+    EXPECT_EQ(1U, group_changed);
+    b = 1.0;
+    EXPECT_EQ(2U, group_changed);
+
+    a_changed.count = 0;
+    {
+        PropertyTransaction t;
+        a = 2;
+        b = 2.0;
+        a = 3;
+        EXPECT_EQ(2U, group_changed);
+    }
+    EXPECT_EQ(3U, group_changed);
+    EXPECT_TRUE(members_notified_first);
+}
+
+TEST(PropertyTest, test_change_during_commit)
+{
+    Property<int> a(0), b(0);
+    Counter b_changed;
+    b.signal_changed().connect(std::ref(b_changed));
+    a.signal_changed().connect([&a, &b]() { b = a * 10; });
+    {
+        PropertyTransaction t;
+        a = 1;
+    }
+    EXPECT_EQ(10, b.get());
+    EXPECT_EQ(1U, b_changed.count);
+}
+
+TEST(PropertyTest, test_handler_exception)
+{
+    Property<int> a(0), b(0);
+    Counter b_changed;
+    a.signal_changed().connect([]() { throw std::runtime_error("test"); });
+    b.signal_changed().connect(std::ref(b_changed));
+    EXPECT_THROW(
+        {
+            PropertyTransaction t;
+            a = 1;
+            b = 1;
+            t.commit();
+        },
+        std::runtime_error);
+    EXPECT_FALSE(PropertyTransaction::active());
+
+    // The failed commit must not leave either property stuck pending.
+    b = 2;
+    EXPECT_EQ(1U, b_changed.count);
+}
+}
@@ -0,0 +1,67 @@
+#include "util/seqlock.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+struct Wide final
+{
+    uint64_t words[16];
+};
+
+TEST(SeqlockTest, test_initial_value)
+{
+    Seqlock<int> s;
+    EXPECT_EQ(0, s.load());
+    EXPECT_EQ(0U, s.generation());
+}
+
+TEST(SeqlockTest, test_store_and_load)
+{
+    Seqlock<int> s;
+    s.store(42);
+    EXPECT_EQ(42, s.load());
+    EXPECT_EQ(1U, s.generation());
+    s.store(43);
+    int v = 0;
+    EXPECT_TRUE(s.try_load(v));
+    EXPECT_EQ(43, v);
+    EXPECT_EQ(2U, s.generation());
+}
+
+TEST(SeqlockTest, test_no_torn_reads)
+{
+    // Every word of each written value is the same, so a torn read would show
+    // up as a value with mismatched words.
+    Seqlock<Wide> s;
+    std::atomic<bool> done(false);
+    std::thread writer([&s, &done]() {
+        Wide w;
+        for (uint64_t i = 1; i <= 200000; ++i)
+        {
+            for (uint64_t &word : w.words)
+            {
+                word = i;
+            }
+            s.store(w);
+        }
+        done.store(true);
+    });
+
+    uint64_t last = 0;
+    while (!done.load())
+    {
+        Wide w = s.load();
+        for (uint64_t word : w.words)
+        {
+            ASSERT_EQ(w.words[0], word);
+        }
+        ASSERT_GE(w.words[0], last);
+        last = w.words[0];
+    }
+    writer.join();
+    EXPECT_EQ(200000U, s.load().words[0]);
+    EXPECT_EQ(200000U, s.generation());
+}
+}
@@ -0,0 +1,45 @@
+#include "util/sockaddrs.h"
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+std::string temp_path(const char *name)
+{
+    const char *dir = std::getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/" + name + "." +
+           std::to_string(getpid());
+}
+
+TEST(SockaddrsTest, test_replaces_stale_socket)
+{
+    const std::string path = temp_path("sockaddrs-stale");
+    std::string unlink_path;
+    {
+        FileDescriptor first = create_local_datagram_socket(path, unlink_path);
+    }
+    FileDescriptor second = create_local_datagram_socket(path, unlink_path);
+    EXPECT_EQ(path, unlink_path);
+    unlink(path.c_str());
+}
+
+TEST(SockaddrsTest, test_keeps_regular_file)
+{
+    const std::string path = temp_path("sockaddrs-file");
+    std::ofstream(path) << "not a socket";
+    std::string unlink_path;
+    EXPECT_THROW(
+        create_local_datagram_socket(path, unlink_path),
+        std::invalid_argument);
+    struct stat st;
+    ASSERT_EQ(0, lstat(path.c_str(), &st));
+    EXPECT_TRUE(S_ISREG(st.st_mode));
+    EXPECT_TRUE(unlink_path.empty());
+    unlink(path.c_str());
+}
+}
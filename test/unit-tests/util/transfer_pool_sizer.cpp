@@ -0,0 +1,81 @@
+#include "util/transfer_pool_sizer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+
+namespace
+{
+typedef USB::TransferPoolSizer::TimePoint TimePoint;
+
+const TimePoint START = TimePoint() + std::chrono::hours(1);
+
+TEST(TransferPoolSizerTest, test_initial_depth)
+{
+    USB::TransferPoolSizer sizer(4, 32, 128, START);
+    EXPECT_EQ(32U, sizer.depth());
+    EXPECT_EQ(0U, sizer.starvations());
+}
+
+TEST(TransferPoolSizerTest, test_burst_grows)
+{
+    USB::TransferPoolSizer sizer(4, 32, 128, START);
+    TimePoint now = START;
+
+    // A burst of 200 packets arrives faster than the host can get back to the
+    // kernel, so each wakeup reaps every transfer the pool had submitted.
+    unsigned int remaining = 200;
+    while (remaining)
+    {
+        unsigned int reaped = std::min(remaining, sizer.depth());
+        remaining -= reaped;
+        now += std::chrono::milliseconds(1);
+        sizer.wakeup_done(reaped, now);
+    }
+    EXPECT_EQ(128U, sizer.depth());
+    EXPECT_EQ(2U, sizer.starvations());
+}
+
+TEST(TransferPoolSizerTest, test_steady_traffic_holds)
+{
+    USB::TransferPoolSizer sizer(4, 32, 128, START);
+    TimePoint now = START;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        now += std::chrono::milliseconds(10);
+        EXPECT_EQ(32U, sizer.wakeup_done(16, now));
+    }
+    EXPECT_EQ(0U, sizer.starvations());
+}
+
+TEST(TransferPoolSizerTest, test_idle_shrinks_after_holdoff)
+{
+    USB::TransferPoolSizer sizer(4, 32, 128, START);
+    EXPECT_EQ(64U, sizer.wakeup_done(32, START));
+
+    // Nothing shrinks during the holdoff.
+    TimePoint now = START + USB::TransferPoolSizer::SHRINK_HOLDOFF -
+                    std::chrono::milliseconds(1);
+    EXPECT_EQ(64U, sizer.wakeup_done(1, now));
+
+    // Afterwards, one transfer per interval.
+    now = START + USB::TransferPoolSizer::SHRINK_HOLDOFF;
+    EXPECT_EQ(63U, sizer.wakeup_done(1, now));
+    EXPECT_EQ(63U, sizer.wakeup_done(1, now));
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        now += USB::TransferPoolSizer::SHRINK_INTERVAL;
+        sizer.wakeup_done(0, now);
+    }
+    EXPECT_EQ(4U, sizer.depth());
+}
+
+TEST(TransferPoolSizerTest, test_starvation_resets_holdoff)
+{
+    USB::TransferPoolSizer sizer(4, 8, 128, START);
+    TimePoint now = START + USB::TransferPoolSizer::SHRINK_HOLDOFF;
+    EXPECT_EQ(7U, sizer.wakeup_done(0, now));
+    now += USB::TransferPoolSizer::SHRINK_INTERVAL;
+    EXPECT_EQ(14U, sizer.wakeup_done(7, now));
+    now += USB::TransferPoolSizer::SHRINK_INTERVAL;
+    EXPECT_EQ(14U, sizer.wakeup_done(0, now));
+}
+}
@@ -0,0 +1,249 @@
+#include "util/assignment.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+const double EPS = 1e-9;
+const double INF = std::numeric_limits<double>::infinity();
+}
+
+constexpr std::size_t Assignment::UNASSIGNED;
+
+Assignment::Assignment()
+    : rows_(0), cols_(0), gate(INF), augmentations_(0)
+{
+}
+
+void Assignment::resize(std::size_t rows, std::size_t cols)
+{
+    rows_ = rows;
+    cols_ = cols;
+    costs.resize(rows * cols);
+    row_match_.assign(rows, UNASSIGNED);
+    col_match_.assign(cols, UNASSIGNED);
+}
+
+void Assignment::reset()
+{
+    v.clear();
+    col_row.clear();
+}
+
+void Assignment::solve()
+{
+    const std::size_t n = std::max(rows_, cols_);
+    std::fill(row_match_.begin(), row_match_.end(), UNASSIGNED);
+    std::fill(col_match_.begin(), col_match_.end(), UNASSIGNED);
+    augmentations_ = 0;
+    if (n == 0)
+    {
+        return;
+    }
+
+    // A gated pair costs more than any matching without it could, so the
+    // optimum uses as few as possible.
+    double largest = 0.0;
+    for (double c : costs)
+    {
+        if (c <= gate)
+        {
+            largest = std::max(largest, std::fabs(c));
+        }
+    }
+    const double forbidden = 2.0 * static_cast<double>(n + 1) * (largest + 1.0);
+
+    // Build the square problem with free padding. Keep the column duals and
+    // make the row duals the tightest that remain feasible, so every row has
+    // at least one zero reduced cost.
+    square.resize(n * n);
+    v.resize(n, 0.0);
+    u.resize(n);
+    candidate.resize(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        double m         = INF;
+        std::size_t best = 0;
+        for (std::size_t j = 0; j != n; ++j)
+        {
+            double c = 0.0;
+            if (i < rows_ && j < cols_)
+            {
+                c = costs[i * cols_ + j];
+                c = c <= gate ? c : forbidden;
+            }
+            square[i * n + j] = c;
+            if (c - v[j] < m)
+            {
+                m    = c - v[j];
+                best = j;
+            }
+        }
+        u[i]         = m;
+        candidate[i] = best;
+    }
+
+    // Re-apply as much of the previous matching as is still tight, then give
+    // remaining rows the column that made their dual, if it is free. The
+    // search scratch holds the previous matching meanwhile.
+    way.assign(n, UNASSIGNED);
+    std::copy(
+        col_row.begin(), col_row.begin() + std::min(col_row.size(), n),
+        way.begin());
+    col_row.assign(n, UNASSIGNED);
+    row_col.assign(n, UNASSIGNED);
+    min_slack.resize(n);
+    todo.resize(n);
+    for (std::size_t j = 0; j != n; ++j)
+    {
+        std::size_t i = way[j];
+        if (i < n && row_col[i] == UNASSIGNED &&
+            square[i * n + j] - u[i] - v[j] <= EPS)
+        {
+            row_col[i] = j;
+            col_row[j] = i;
+        }
+    }
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        std::size_t j = candidate[i];
+        if (row_col[i] == UNASSIGNED && col_row[j] == UNASSIGNED)
+        {
+            row_col[i] = j;
+            col_row[j] = i;
+        }
+    }
+
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        if (row_col[i] == UNASSIGNED)
+        {
+            augment(i);
+            ++augmentations_;
+        }
+    }
+
+    for (std::size_t j = 0; j != cols_; ++j)
+    {
+        std::size_t i = col_row[j];
+        if (i < rows_ && costs[i * cols_ + j] <= gate)
+        {
+            row_match_[i] = j;
+            col_match_[j] = i;
+        }
+    }
+}
+
+double Assignment::total_cost() const
+{
+    double total = 0.0;
+    for (std::size_t i = 0; i != rows_; ++i)
+    {
+        if (row_match_[i] != UNASSIGNED)
+        {
+            total += costs[i * cols_ + row_match_[i]];
+        }
+    }
+    return total;
+}
+
+void Assignment::augment(std::size_t row)
+{
+    // Dijkstra's algorithm over reduced costs from a free row, after Jonker
+    // and Volgenant. Columns in todo[0, lo) are done, [lo, hi) are at the
+    // current minimum distance and waiting to be scanned, and [hi, n) are
+    // further away.
+    const std::size_t n = v.size();
+    std::size_t lo = 0, hi = 0, ready = 0, end = UNASSIGNED;
+    for (std::size_t j = 0; j != n; ++j)
+    {
+        todo[j]      = j;
+        way[j]       = row;
+        min_slack[j] = square[row * n + j] - v[j];
+    }
+    while (end == UNASSIGNED)
+    {
+        if (lo == hi)
+        {
+            ready       = lo;
+            hi          = lo + 1;
+            double mind = min_slack[todo[lo]];
+            for (std::size_t k = hi; k != n; ++k)
+            {
+                const std::size_t j = todo[k];
+                if (min_slack[j] <= mind)
+                {
+                    if (min_slack[j] < mind)
+                    {
+                        hi   = lo;
+                        mind = min_slack[j];
+                    }
+                    todo[k]    = todo[hi];
+                    todo[hi++] = j;
+                }
+            }
+            for (std::size_t k = lo; k != hi; ++k)
+            {
+                if (col_row[todo[k]] == UNASSIGNED)
+                {
+                    end = todo[k];
+                }
+            }
+        }
+        if (end == UNASSIGNED)
+        {
+            std::size_t scan_lo = lo, scan_hi = hi;
+            while (scan_lo != scan_hi && end == UNASSIGNED)
+            {
+                std::size_t j       = todo[scan_lo++];
+                const std::size_t i = col_row[j];
+                const double mind   = min_slack[j];
+                const double h      = square[i * n + j] - v[j] - mind;
+                for (std::size_t k = scan_hi; k != n; ++k)
+                {
+                    j                  = todo[k];
+                    const double slack = square[i * n + j] - v[j] - h;
+                    if (slack < min_slack[j])
+                    {
+                        min_slack[j] = slack;
+                        way[j]       = i;
+                        if (slack == mind)
+                        {
+                            if (col_row[j] == UNASSIGNED)
+                            {
+                                end = j;
+                                break;
+                            }
+                            todo[k]         = todo[scan_hi];
+                            todo[scan_hi++] = j;
+                        }
+                    }
+                }
+            }
+            if (end == UNASSIGNED)
+            {
+                lo = scan_lo;
+                hi = scan_hi;
+            }
+        }
+    }
+
+    // Update the duals of the columns finished before the last minimum, so
+    // matched pairs stay tight.
+    const double mind = min_slack[todo[lo]];
+    for (std::size_t k = 0; k != ready; ++k)
+    {
+        const std::size_t j = todo[k];
+        v[j] += min_slack[j] - mind;
+    }
+
+    // Flip the matching along the path back to the new row.
+    std::size_t j = end, i;
+    do
+    {
+        i          = way[j];
+        col_row[j] = i;
+        std::swap(j, row_col[i]);
+    } while (i != row);
+}
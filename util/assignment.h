@@ -0,0 +1,198 @@
+#ifndef UTIL_ASSIGNMENT_H
+#define UTIL_ASSIGNMENT_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * \brief Solves the minimum-cost assignment problem and keeps its solution to
+ * warm-start the next, similar problem.
+ *
+ * This is meant for tracking, where each vision frame asks for a matching of
+ * new detections (rows) to existing tracks (columns). Columns should keep
+ * their meaning between calls to \ref solve. Each solve starts from the
+ * previous column dual variables and re-applies the previous matching where
+ * it is still optimal. Only the rows that this leaves unmatched are run
+ * through the shortest-augmenting-path search, so a frame in which little has
+ * moved costs close to O(<var>n</var>²) instead of O(<var>n</var>³). The
+ * previous duals carry the previous frame's noise, so when detections jitter
+ * by a good part of their spacing, a cold start (\ref reset before \ref
+ * solve) may need fewer searches.
+ *
+ * The matrix may be rectangular; the extra rows or columns stay unassigned.
+ * Pairs costing more than the gate are never matched. Among matchings, the
+ * solver first maximizes the number of pairs matched within the gate and then
+ * minimizes their total cost.
+ */
+class Assignment final
+{
+   public:
+    /**
+     * \brief The value returned for a row or column that is not matched.
+     */
+    static constexpr std::size_t UNASSIGNED =
+        std::numeric_limits<std::size_t>::max();
+
+    /**
+     * \brief Constructs an empty solver.
+     */
+    explicit Assignment();
+
+    /**
+     * \brief Returns the number of rows.
+     *
+     * \return the number of rows
+     */
+    std::size_t rows() const
+    {
+        return rows_;
+    }
+
+    /**
+     * \brief Returns the number of columns.
+     *
+     * \return the number of columns
+     */
+    std::size_t cols() const
+    {
+        return cols_;
+    }
+
+    /**
+     * \brief Changes the size of the cost matrix.
+     *
+     * The warm start of columns that remain is kept. All costs must be set
+     * again before the next solve.
+     *
+     * \param[in] rows the number of rows
+     *
+     * \param[in] cols the number of columns
+     */
+    void resize(std::size_t rows, std::size_t cols);
+
+    /**
+     * \brief Gets or sets the cost of matching a row with a column.
+     *
+     * \param[in] row the row
+     *
+     * \param[in] col the column
+     *
+     * \return the cost
+     */
+    double &cost(std::size_t row, std::size_t col)
+    {
+        assert(row < rows_ && col < cols_);
+        return costs[row * cols_ + col];
+    }
+
+    /**
+     * \brief Gets the cost of matching a row with a column.
+     *
+     * \param[in] row the row
+     *
+     * \param[in] col the column
+     *
+     * \return the cost
+     */
+    double cost(std::size_t row, std::size_t col) const
+    {
+        assert(row < rows_ && col < cols_);
+        return costs[row * cols_ + col];
+    }
+
+    /**
+     * \brief Sets the largest cost a matched pair may have.
+     *
+     * \param[in] gate the gate, which defaults to infinity
+     */
+    void set_gate(double gate)
+    {
+        this->gate = gate;
+    }
+
+    /**
+     * \brief Forgets the warm start, so the next solve starts from nothing.
+     */
+    void reset();
+
+    /**
+     * \brief Finds an optimal matching for the current costs.
+     */
+    void solve();
+
+    /**
+     * \brief Returns the column matched with a row.
+     *
+     * \param[in] row the row
+     *
+     * \return the column, or \ref UNASSIGNED
+     */
+    std::size_t row_match(std::size_t row) const
+    {
+        assert(row < rows_);
+        return row_match_[row];
+    }
+
+    /**
+     * \brief Returns the row matched with a column.
+     *
+     * \param[in] col the column
+     *
+     * \return the row, or \ref UNASSIGNED
+     */
+    std::size_t col_match(std::size_t col) const
+    {
+        assert(col < cols_);
+        return col_match_[col];
+    }
+
+    /**
+     * \brief Returns the total cost of the matched pairs.
+     *
+     * \return the total cost
+     */
+    double total_cost() const;
+
+    /**
+     * \brief Returns how many rows the last solve had to search for, rather
+     * than taking from the warm start.
+     *
+     * \return the number of augmenting path searches
+     */
+    std::size_t augmentations() const
+    {
+        return augmentations_;
+    }
+
+   private:
+    std::size_t rows_, cols_;
+    double gate;
+    std::vector<double> costs;
+    std::vector<std::size_t> row_match_, col_match_;
+    std::size_t augmentations_;
+
+    /**
+     * \brief The square problem actually solved: the costs padded with free
+     * rows or columns and with gated pairs made expensive.
+     */
+    std::vector<double> square;
+
+    /**
+     * \brief The dual variables of the square problem's rows and columns, and
+     * its matching in both directions.
+     */
+    std::vector<double> u, v;
+    std::vector<std::size_t> row_col, col_row;
+
+    /**
+     * \brief Scratch space for the warm start and the augmenting path search.
+     */
+    std::vector<double> min_slack;
+    std::vector<std::size_t> candidate, way, todo;
+
+    void augment(std::size_t row);
+};
+
+#endif
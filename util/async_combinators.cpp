@@ -0,0 +1,6 @@
+#include "util/async_combinators.h"
+
+Async::TimeoutError::TimeoutError()
+    : std::runtime_error("Operation timed out")
+{
+}
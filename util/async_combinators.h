@@ -0,0 +1,751 @@
+#ifndef UTIL_ASYNC_COMBINATORS_H
+#define UTIL_ASYNC_COMBINATORS_H
+
+/**
+ * \file
+ *
+ * \brief Provides combinators that build asynchronous operations out of other
+ * asynchronous operations.
+ */
+
+#include <glibmm/main.h>
+#include <sigc++/bind.h>
+#include <sigc++/connection.h>
+#include <sigc++/functors/mem_fun.h>
+#include <sigc++/trackable.h>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "util/async_operation.h"
+
+/**
+ * \brief Combinators over AsyncOperation.
+ *
+ * Each combinator takes ownership of the operations it is given, which must
+ * not have completed yet, and returns one new operation, allocated once.
+ * Completions arrive through the children’s \c signal_done and deadlines
+ * through Glib timeouts, so everything runs on the main loop and no threads
+ * are involved. Destroying a combined operation destroys the children it
+ * still owns, abandoning whatever they have not finished.
+ *
+ * For example, to send a message to every robot and learn once every robot
+ * has acknowledged it or half a second has passed:
+ *
+ * \code
+ * std::vector<std::unique_ptr<AsyncOperation<void>>> sends;
+ * for (unsigned int i = 0; i != 8; ++i)
+ * {
+ *     sends.emplace_back(new MRFDongle::SendReliableMessageOperation(
+ *         dongle, i, tries, data, len));
+ * }
+ * op = Async::with_timeout(
+ *     Async::when_all(std::move(sends)), std::chrono::milliseconds(500));
+ * \endcode
+ */
+namespace Async
+{
+/**
+ * \brief Thrown by the result of an operation that did not complete before
+ * its deadline.
+ */
+class TimeoutError final : public std::runtime_error
+{
+   public:
+    /**
+     * \brief Constructs a TimeoutError.
+     */
+    explicit TimeoutError();
+};
+
+/**
+ * \brief Deduces the result type of an operation.
+ *
+ * This is never defined and is only used in unevaluated contexts.
+ *
+ * \tparam T the result type
+ *
+ * \return a value of the result type
+ */
+template <typename T>
+T operation_result(const AsyncOperation<T> *);
+
+/**
+ * \brief Gives the result type of an operation type.
+ *
+ * \tparam Op a type derived from AsyncOperation
+ */
+template <typename Op>
+struct OperationResult final
+{
+    /**
+     * \brief The \c T of the AsyncOperation from which \p Op derives.
+     */
+    typedef decltype(operation_result(static_cast<const Op *>(nullptr))) type;
+};
+
+/**
+ * \brief Holds the outcome of a finished operation: either a value or an
+ * exception.
+ *
+ * \tparam T the type of value
+ */
+template <typename T>
+class Outcome final : public NonCopyable
+{
+   public:
+    /**
+     * \brief Constructs an empty outcome.
+     */
+    explicit Outcome() : has_value(false)
+    {
+    }
+
+    /**
+     * \brief Destroys the outcome.
+     */
+    ~Outcome()
+    {
+        if (has_value)
+        {
+            value().~T();
+        }
+    }
+
+    /**
+     * \brief Records the value returned by a function, or the exception it
+     * throws.
+     *
+     * \param[in] fn the function to call
+     */
+    template <typename F>
+    void set(F fn)
+    {
+        try
+        {
+            new (&storage) T(fn());
+            has_value = true;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+
+    /**
+     * \brief Records an exception.
+     *
+     * \param[in] exp the exception
+     */
+    void fail(std::exception_ptr exp)
+    {
+        error = exp;
+    }
+
+    /**
+     * \brief Returns the recorded value or throws the recorded exception.
+     *
+     * \return the value
+     */
+    T get() const
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        assert(has_value);
+        return value();
+    }
+
+   private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    bool has_value;
+    std::exception_ptr error;
+
+    T &value()
+    {
+        return *reinterpret_cast<T *>(&storage);
+    }
+
+    const T &value() const
+    {
+        return *reinterpret_cast<const T *>(&storage);
+    }
+};
+
+/**
+ * \brief Holds the outcome of a finished operation that has no value.
+ */
+template <>
+class Outcome<void> final : public NonCopyable
+{
+   public:
+    /**
+     * \brief Records whether a function throws.
+     *
+     * \param[in] fn the function to call
+     */
+    template <typename F>
+    void set(F fn)
+    {
+        try
+        {
+            fn();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+
+    /**
+     * \brief Records an exception.
+     *
+     * \param[in] exp the exception
+     */
+    void fail(std::exception_ptr exp)
+    {
+        error = exp;
+    }
+
+    /**
+     * \brief Throws the recorded exception, if any.
+     */
+    void get() const
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+   private:
+    std::exception_ptr error;
+};
+
+/**
+ * \brief Calls a continuation with the result of a finished operation.
+ *
+ * \tparam T the result type of the operation
+ */
+template <typename T>
+struct Continuation final
+{
+    /**
+     * \brief Calls the continuation.
+     *
+     * \param[in] fn the continuation, which takes the operation’s value
+     *
+     * \param[in] op the operation, whose exception propagates without calling
+     * \p fn if it failed
+     *
+     * \return whatever \p fn returns
+     */
+    template <typename F>
+    static auto call(F &fn, const AsyncOperation<T> &op)
+        -> decltype(fn(op.result()))
+    {
+        return fn(op.result());
+    }
+};
+
+/**
+ * \brief Calls a continuation after an operation with no value.
+ */
+template <>
+struct Continuation<void> final
+{
+    /**
+     * \brief Calls the continuation.
+     *
+     * \param[in] fn the continuation, which takes no parameters
+     *
+     * \param[in] op the operation, whose exception propagates without calling
+     * \p fn if it failed
+     *
+     * \return whatever \p fn returns
+     */
+    template <typename F>
+    static auto call(F &fn, const AsyncOperation<void> &op) -> decltype(fn())
+    {
+        op.result();
+        return fn();
+    }
+};
+
+/**
+ * \brief Describes what a continuation returns.
+ *
+ * A continuation returning anything other than a pointer to an operation
+ * produces that value directly.
+ *
+ * \tparam R the continuation’s return type
+ */
+template <typename R, typename Enable = void>
+struct Step final
+{
+    /**
+     * \brief Whether the continuation starts another operation.
+     */
+    static constexpr bool CHAINED = false;
+
+    /**
+     * \brief The result type of the combined operation.
+     */
+    typedef R Result;
+};
+
+/**
+ * \brief Describes a continuation that starts another operation, whose result
+ * becomes the result of the combined operation.
+ *
+ * \tparam Op the type of operation started
+ */
+template <typename Op>
+struct Step<
+    std::unique_ptr<Op>,
+    decltype(void(operation_result(static_cast<const Op *>(nullptr))))>
+    final
+{
+    /**
+     * \brief Whether the continuation starts another operation.
+     */
+    static constexpr bool CHAINED = true;
+
+    /**
+     * \brief The result type of the combined operation.
+     */
+    typedef typename OperationResult<Op>::type Result;
+};
+
+/**
+ * \brief Describes the continuation of a ThenOperation.
+ *
+ * \tparam T the result type of the first operation
+ *
+ * \tparam F the type of the continuation
+ */
+template <typename T, typename F>
+struct ThenTraits final
+{
+    /**
+     * \brief What the continuation returns.
+     */
+    typedef Step<decltype(Continuation<T>::call(
+        std::declval<F &>(), std::declval<const AsyncOperation<T> &>()))>
+        StepType;
+
+    /**
+     * \brief The result type of the combined operation.
+     */
+    typedef typename StepType::Result Result;
+};
+
+/**
+ * \brief An operation that runs a continuation once another operation
+ * succeeds.
+ *
+ * \tparam T the result type of the first operation
+ *
+ * \tparam F the type of the continuation
+ */
+template <typename T, typename F>
+class ThenOperation final
+    : public AsyncOperation<typename ThenTraits<T, F>::Result>,
+      public sigc::trackable
+{
+   public:
+    /**
+     * \brief The result type of this operation.
+     */
+    typedef typename ThenTraits<T, F>::Result Result;
+
+    /**
+     * \brief Waits for an operation.
+     *
+     * \param[in] first the operation to wait for
+     *
+     * \param[in] fn the continuation
+     */
+    explicit ThenOperation(std::unique_ptr<AsyncOperation<T>> first, F fn)
+        : first(std::move(first)), fn(std::move(fn))
+    {
+        this->first->signal_done.connect(
+            sigc::mem_fun(this, &ThenOperation::first_done));
+    }
+
+    /**
+     * \brief Returns the result of the continuation, or of the operation it
+     * started.
+     *
+     * If the first operation or the continuation failed, their exception is
+     * thrown instead.
+     *
+     * \return the result
+     */
+    Result result() const override
+    {
+        return outcome.get();
+    }
+
+   private:
+    std::unique_ptr<AsyncOperation<T>> first;
+    F fn;
+    std::unique_ptr<AsyncOperation<Result>> second;
+    Outcome<Result> outcome;
+
+    void first_done(AsyncOperation<T> &)
+    {
+        run_continuation(std::integral_constant<
+                         bool, ThenTraits<T, F>::StepType::CHAINED>());
+    }
+
+    void run_continuation(std::false_type)
+    {
+        outcome.set([this]() { return Continuation<T>::call(fn, *first); });
+        this->signal_done.emit(*this);
+    }
+
+    void run_continuation(std::true_type)
+    {
+        try
+        {
+            second = Continuation<T>::call(fn, *first);
+            assert(second);
+        }
+        catch (...)
+        {
+            outcome.fail(std::current_exception());
+            this->signal_done.emit(*this);
+            return;
+        }
+        second->signal_done.connect(
+            sigc::mem_fun(this, &ThenOperation::second_done));
+    }
+
+    void second_done(AsyncOperation<Result> &)
+    {
+        outcome.set([this]() { return second->result(); });
+        this->signal_done.emit(*this);
+    }
+};
+
+/**
+ * \brief An operation that completes once every one of a set of operations
+ * has completed.
+ *
+ * \tparam T the result type of the operations
+ */
+template <typename T>
+class WhenAllOperation final : public AsyncOperation<void>,
+                               public sigc::trackable
+{
+   public:
+    /**
+     * \brief Waits for operations.
+     *
+     * \param[in] ops the operations, of which there must be at least one
+     */
+    explicit WhenAllOperation(
+        std::vector<std::unique_ptr<AsyncOperation<T>>> ops)
+        : ops(std::move(ops)), pending(this->ops.size())
+    {
+        assert(pending);
+        for (const std::unique_ptr<AsyncOperation<T>> &i : this->ops)
+        {
+            i->signal_done.connect(
+                sigc::mem_fun(this, &WhenAllOperation::child_done));
+        }
+    }
+
+    /**
+     * \brief Returns the number of operations.
+     *
+     * \return the count
+     */
+    std::size_t size() const
+    {
+        return ops.size();
+    }
+
+    /**
+     * \brief Returns one of the operations, for reading its result.
+     *
+     * \param[in] index the position of the operation
+     *
+     * \return the operation
+     */
+    AsyncOperation<T> &operation(std::size_t index) const
+    {
+        return *ops[index];
+    }
+
+    /**
+     * \brief Checks whether every operation succeeded.
+     *
+     * If any failed, the exception of the first in order is thrown.
+     */
+    void result() const override
+    {
+        for (const std::unique_ptr<AsyncOperation<T>> &i : ops)
+        {
+            i->result();
+        }
+    }
+
+   private:
+    std::vector<std::unique_ptr<AsyncOperation<T>>> ops;
+    std::size_t pending;
+
+    void child_done(AsyncOperation<T> &)
+    {
+        assert(pending);
+        if (!--pending)
+        {
+            signal_done.emit(*this);
+        }
+    }
+};
+
+/**
+ * \brief An operation that completes as soon as any one of a set of
+ * operations has completed.
+ *
+ * The other operations carry on, and are abandoned when this operation is
+ * destroyed.
+ *
+ * \tparam T the result type of the operations
+ */
+template <typename T>
+class WhenAnyOperation final : public AsyncOperation<std::size_t>,
+                               public sigc::trackable
+{
+   public:
+    /**
+     * \brief Waits for operations.
+     *
+     * \param[in] ops the operations, of which there must be at least one
+     */
+    explicit WhenAnyOperation(
+        std::vector<std::unique_ptr<AsyncOperation<T>>> ops)
+        : ops(std::move(ops)), first(this->ops.size())
+    {
+        assert(!this->ops.empty());
+        connections.reserve(this->ops.size());
+        for (std::size_t i = 0; i != this->ops.size(); ++i)
+        {
+            connections.push_back(this->ops[i]->signal_done.connect(sigc::bind(
+                sigc::mem_fun(this, &WhenAnyOperation::child_done), i)));
+        }
+    }
+
+    /**
+     * \brief Returns the number of operations.
+     *
+     * \return the count
+     */
+    std::size_t size() const
+    {
+        return ops.size();
+    }
+
+    /**
+     * \brief Returns one of the operations, for reading its result.
+     *
+     * \param[in] index the position of the operation
+     *
+     * \return the operation
+     */
+    AsyncOperation<T> &operation(std::size_t index) const
+    {
+        return *ops[index];
+    }
+
+    /**
+     * \brief Returns which operation completed first.
+     *
+     * This does not throw if that operation failed; check it with \ref
+     * operation.
+     *
+     * \return the position of the operation
+     */
+    std::size_t result() const override
+    {
+        assert(first < ops.size());
+        return first;
+    }
+
+   private:
+    std::vector<std::unique_ptr<AsyncOperation<T>>> ops;
+    std::vector<sigc::connection> connections;
+    std::size_t first;
+
+    void child_done(AsyncOperation<T> &, std::size_t index)
+    {
+        for (sigc::connection &i : connections)
+        {
+            i.disconnect();
+        }
+        first = index;
+        signal_done.emit(*this);
+    }
+};
+
+/**
+ * \brief An operation that fails with TimeoutError if another operation does
+ * not complete within a deadline.
+ *
+ * On timeout the other operation is destroyed.
+ *
+ * \tparam T the result type of the operation
+ */
+template <typename T>
+class TimeoutOperation final : public AsyncOperation<T>, public sigc::trackable
+{
+   public:
+    /**
+     * \brief Starts the deadline.
+     *
+     * \param[in] op the operation to wait for
+     *
+     * \param[in] timeout how long to wait
+     */
+    explicit TimeoutOperation(
+        std::unique_ptr<AsyncOperation<T>> op,
+        std::chrono::milliseconds timeout)
+        : op(std::move(op))
+    {
+        op_connection = this->op->signal_done.connect(
+            sigc::mem_fun(this, &TimeoutOperation::op_done));
+        timeout_connection = Glib::signal_timeout().connect(
+            sigc::mem_fun(this, &TimeoutOperation::timed_out),
+            static_cast<unsigned int>(timeout.count()));
+    }
+
+    /**
+     * \brief Cancels the deadline.
+     */
+    ~TimeoutOperation()
+    {
+        timeout_connection.disconnect();
+    }
+
+    /**
+     * \brief Returns the result of the operation.
+     *
+     * If the operation failed, its exception is thrown; if it did not complete
+     * in time, TimeoutError is thrown.
+     *
+     * \return the result
+     */
+    T result() const override
+    {
+        return outcome.get();
+    }
+
+   private:
+    std::unique_ptr<AsyncOperation<T>> op;
+    sigc::connection op_connection, timeout_connection;
+    Outcome<T> outcome;
+
+    void op_done(AsyncOperation<T> &)
+    {
+        timeout_connection.disconnect();
+        outcome.set([this]() { return op->result(); });
+        this->signal_done.emit(*this);
+    }
+
+    bool timed_out()
+    {
+        timeout_connection.disconnect();
+        op_connection.disconnect();
+        op.reset();
+        outcome.fail(std::make_exception_ptr(TimeoutError()));
+        this->signal_done.emit(*this);
+        return false;
+    }
+};
+
+/**
+ * \brief Runs a continuation once an operation succeeds.
+ *
+ * The continuation receives the operation’s value, or nothing if the
+ * operation has no value. If it returns a \c std::unique_ptr to an operation,
+ * the combined operation waits for that one too and takes its result;
+ * otherwise the combined operation completes at once with the returned value.
+ * If the first operation fails, the continuation is not called and the
+ * failure propagates.
+ *
+ * \param[in] op the operation to wait for
+ *
+ * \param[in] fn the continuation
+ *
+ * \return the combined operation
+ */
+template <typename Op, typename F>
+std::unique_ptr<ThenOperation<typename OperationResult<Op>::type, F>> then(
+    std::unique_ptr<Op> op, F fn)
+{
+    typedef typename OperationResult<Op>::type T;
+    return std::unique_ptr<ThenOperation<T, F>>(new ThenOperation<T, F>(
+        std::unique_ptr<AsyncOperation<T>>(std::move(op)), std::move(fn)));
+}
+
+/**
+ * \brief Waits for every one of a set of operations.
+ *
+ * \param[in] ops the operations, of which there must be at least one
+ *
+ * \return an operation that completes when all of \p ops have
+ */
+template <typename T>
+std::unique_ptr<WhenAllOperation<T>> when_all(
+    std::vector<std::unique_ptr<AsyncOperation<T>>> ops)
+{
+    return std::unique_ptr<WhenAllOperation<T>>(
+        new WhenAllOperation<T>(std::move(ops)));
+}
+
+/**
+ * \brief Waits for the first of a set of operations.
+ *
+ * \param[in] ops the operations, of which there must be at least one
+ *
+ * \return an operation that completes when any of \p ops has, whose result is
+ * the position of that operation
+ */
+template <typename T>
+std::unique_ptr<WhenAnyOperation<T>> when_any(
+    std::vector<std::unique_ptr<AsyncOperation<T>>> ops)
+{
+    return std::unique_ptr<WhenAnyOperation<T>>(
+        new WhenAnyOperation<T>(std::move(ops)));
+}
+
+/**
+ * \brief Bounds an operation with a deadline.
+ *
+ * \param[in] op the operation to wait for
+ *
+ * \param[in] timeout how long to wait
+ *
+ * \return an operation that completes with the result of \p op, or fails with
+ * TimeoutError and destroys \p op if \p timeout passes first
+ */
+template <typename Op>
+std::unique_ptr<TimeoutOperation<typename OperationResult<Op>::type>>
+with_timeout(std::unique_ptr<Op> op, std::chrono::milliseconds timeout)
+{
+    typedef typename OperationResult<Op>::type T;
+    return std::unique_ptr<TimeoutOperation<T>>(new TimeoutOperation<T>(
+        std::unique_ptr<AsyncOperation<T>>(std::move(op)), timeout));
+}
+}
+
+#endif
@@ -4,13 +4,14 @@
 #include <cassert>
 #include <cstddef>
 #include <vector>
+#include "util/assignment.h"
 
 /**
- * Uses the Hungarian algorithm to perform a maximum-weight bipartite matching.
+ * Performs a maximum-weight bipartite matching.
  *
- * In other terms, given a square matrix of <var>N</var> rows and columns,
- * and given a number in each cell, selects <var>N</var> of those cells such
- * that:
+ * In other terms, given a matrix of <var>R</var> rows and <var>C</var>
+ * columns, and given a number in each cell, selects min(<var>R</var>,
+ * <var>C</var>) of those cells such that:
  * <ul>
  * <li>No two cells in the same row or column are chosen, and</li>
  * <li>The sum of values in the cells is maximized</li>
@@ -19,15 +20,14 @@
  * Usage:
  * <ol>
  * <li>You create a new Hungarian object with some size.
- * The object contains two node-sets, named <var>X</var> and <var>Y</var>, each
- * of the given size.</li>
+ * The object contains two node-sets, named <var>X</var> (the rows) and
+ * <var>Y</var> (the columns).</li>
  * <li>You define the weight of matching each node in the <var>X</var> set with
  * every node in the <var>Y</var> set,
  * using the weight(std::size_t, std::size_t) function.</li>
- * <li>You call execute(). This computes a matching where every node in
- * <var>X</var> is matched with exactly one element in <var>Y</var>
- * (and consequently vice-versa) such that no other matching exists that has a
- * higher total weight,
+ * <li>You call execute(). This computes a matching where every node in the
+ * smaller set is matched with exactly one node in the other set
+ * such that no other matching exists that has a higher total weight,
  * where the total weight of a matching is defined as the sum of the weights
  * specified for all the matched pairs.</li>
  * <li>You read off the matching by either calling matchX(std::size_t) const to
@@ -36,25 +36,76 @@
  * or by calling matchY(std::size_t) const to determine which element in
  * <var>X</var> matches with each element in <var>Y</var>.</li>
  * </ol>
+ *
+ * Despite the name, this is a front end to Assignment, whose shortest
+ * augmenting path search after Jonker and Volgenant does far less work than
+ * the Hungarian algorithm on problems where the cheapest cells already nearly
+ * form a matching. Each execute() solves the negated weights from a cold
+ * start. Weights are stored in one row-major block and the working space is
+ * kept between calls, so an object that is resized and executed repeatedly
+ * does not allocate once it has reached its largest size.
  */
 class Hungarian final
 {
    public:
     /**
-     * Constructs a new Hungarian.
+     * The value returned by matchX and matchY for a node left unmatched
+     * because the other set is smaller.
+     */
+    static constexpr std::size_t NONE = Assignment::UNASSIGNED;
+
+    /**
+     * Constructs a new square Hungarian.
      *
      * \param[in] size the number of elements in the left and right sets.
      */
     explicit Hungarian(std::size_t size);
 
     /**
-     * Returns the dimension of the Hungarian matrix.
+     * Constructs a new Hungarian.
+     *
+     * \param[in] rows the number of elements in the <var>X</var> set.
+     *
+     * \param[in] cols the number of elements in the <var>Y</var> set.
+     */
+    explicit Hungarian(std::size_t rows, std::size_t cols);
+
+    /**
+     * Returns the dimension of the Hungarian matrix, the larger of the number
+     * of rows and columns.
      */
     std::size_t size() const
     {
-        return weights.size();
+        return rows_ > cols_ ? rows_ : cols_;
     }
 
+    /**
+     * Returns the number of elements in the <var>X</var> set.
+     */
+    std::size_t rows() const
+    {
+        return rows_;
+    }
+
+    /**
+     * Returns the number of elements in the <var>Y</var> set.
+     */
+    std::size_t cols() const
+    {
+        return cols_;
+    }
+
+    /**
+     * Changes the size of the matrix.
+     *
+     * All weights must be set again before the next execute().
+     *
+     * \param[in] rows the number of elements in the <var>X</var> set.
+     *
+     * \param[in] cols the number of elements in the <var>Y</var> set.
+     */
+    void resize(std::size_t rows, std::size_t cols);
+
     /**
      * Gets or sets a pairwise weight.
      *
@@ -66,9 +117,9 @@ class Hungarian final
      */
     double &weight(std::size_t x, std::size_t y)
     {
-        assert(x < weights.size());
-        assert(y < weights.size());
-        return weights[x][y];
+        assert(x < rows_);
+        assert(y < cols_);
+        return weights[x * cols_ + y];
     }
 
     /**
@@ -82,9 +133,9 @@ class Hungarian final
      */
     const double &weight(std::size_t x, std::size_t y) const
     {
-        assert(x < weights.size());
-        assert(y < weights.size());
-        return weights[x][y];
+        assert(x < rows_);
+        assert(y < cols_);
+        return weights[x * cols_ + y];
     }
 
     /**
@@ -98,12 +149,11 @@ class Hungarian final
      * \param[in] x the index of a node in the <var>X</var> set.
      *
      * \return the index of the node in the <var>Y</var> set that is matched
-     * with node \p x.
+     * with node \p x, or NONE.
      */
     std::size_t matchX(std::size_t x) const
     {
-        assert(x < mx.size());
-        return mx[x];
+        return solver.row_match(x);
     }
 
     /**
@@ -112,17 +162,17 @@ class Hungarian final
      * \param[in] y the index of a node in the <var>Y</var> set.
      *
      * \return the index of the node in the <var>X</var> set that is matched
-     * with node \p y.
+     * with node \p y, or NONE.
      */
     std::size_t matchY(std::size_t y) const
     {
-        assert(y < my.size());
-        return my[y];
+        return solver.col_match(y);
     }
 
    private:
-    std::vector<std::vector<double>> weights;
-    std::vector<std::size_t> mx, my;
+    std::size_t rows_, cols_;
+    std::vector<double> weights;
+    Assignment solver;
 };
 
 #endif
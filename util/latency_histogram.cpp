@@ -0,0 +1,92 @@
+#include "util/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration latency)
+{
+    long long micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    record_micros(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+}
+
+void LatencyHistogram::record_micros(uint64_t micros)
+{
+    ++buckets[bucket_index(micros)];
+    ++count_;
+    sum += micros;
+    min_ = std::min(min_, micros);
+    max_ = std::max(max_, micros);
+}
+
+void LatencyHistogram::reset()
+{
+    buckets.fill(0);
+    count_ = 0;
+    sum    = 0;
+    min_   = std::numeric_limits<uint64_t>::max();
+    max_   = 0;
+}
+
+double LatencyHistogram::mean() const
+{
+    return count_ ? static_cast<double>(sum) / static_cast<double>(count_)
+                  : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    if (!count_)
+    {
+        return 0;
+    }
+    fraction = std::min(1.0, std::max(0.0, fraction));
+    uint64_t target = static_cast<uint64_t>(
+        std::ceil(fraction * static_cast<double>(count_)));
+    target        = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+        {
+            // Report the middle of the bucket, but never report something
+            // outside the range of values actually recorded.
+            uint64_t lower    = bucket_lower_bound(i);
+            uint64_t width    = i < 4 ? 1 : UINT64_C(1) << (i / 4 - 1);
+            uint64_t estimate = lower + width / 2;
+            return std::min(max_, std::max(min_, estimate));
+        }
+    }
+    return max_;
+}
+
+std::size_t LatencyHistogram::bucket_index(uint64_t micros)
+{
+    // Values below 4 get an exact bucket each. Above that, each power of two
+    // [2^e, 2^(e+1)) is split into four equal buckets using the two bits below
+    // the most significant one.
+    if (micros < 4)
+    {
+        return static_cast<std::size_t>(micros);
+    }
+    unsigned int e   = 63U - static_cast<unsigned int>(__builtin_clzll(micros));
+    unsigned int sub = static_cast<unsigned int>(micros >> (e - 2)) & 3U;
+    return (e - 1U) * 4U + sub;
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(std::size_t index)
+{
+    if (index < 4)
+    {
+        return index;
+    }
+    unsigned int e   = static_cast<unsigned int>(index / 4) + 1U;
+    unsigned int sub = static_cast<unsigned int>(index % 4);
+    return static_cast<uint64_t>(4U + sub) << (e - 2U);
+}
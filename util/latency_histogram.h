@@ -0,0 +1,104 @@
+#ifndef UTIL_LATENCY_HISTOGRAM_H
+#define UTIL_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \brief A fixed-size, log-scaled histogram of latencies.
+ *
+ * Samples are recorded in whole microseconds.
+ * Each power of two is divided into four buckets, so a percentile reported by
+ * the histogram is within 25% of the true value.
+ * Recording a sample is constant time and never allocates memory.
+ */
+class LatencyHistogram final
+{
+   public:
+    /**
+     * \brief Constructs an empty histogram.
+     */
+    explicit LatencyHistogram();
+
+    /**
+     * \brief Records a sample.
+     *
+     * \param[in] latency the latency to record
+     */
+    void record(std::chrono::steady_clock::duration latency);
+
+    /**
+     * \brief Records a sample.
+     *
+     * \param[in] micros the latency to record, in microseconds
+     */
+    void record_micros(uint64_t micros);
+
+    /**
+     * \brief Discards all recorded samples.
+     */
+    void reset();
+
+    /**
+     * \brief Returns the number of recorded samples.
+     *
+     * \return the sample count
+     */
+    uint64_t count() const
+    {
+        return count_;
+    }
+
+    /**
+     * \brief Returns the smallest recorded sample.
+     *
+     * \return the minimum latency, in microseconds, or zero if no samples have
+     * been recorded
+     */
+    uint64_t min() const
+    {
+        return count_ ? min_ : 0;
+    }
+
+    /**
+     * \brief Returns the largest recorded sample.
+     *
+     * \return the maximum latency, in microseconds
+     */
+    uint64_t max() const
+    {
+        return max_;
+    }
+
+    /**
+     * \brief Returns the arithmetic mean of the recorded samples.
+     *
+     * \return the mean latency, in microseconds, or zero if no samples have
+     * been recorded
+     */
+    double mean() const;
+
+    /**
+     * \brief Estimates a percentile of the recorded samples.
+     *
+     * \param[in] fraction the fraction of samples which should be less than or
+     * equal to the returned value, between 0 and 1
+     *
+     * \return the estimated latency, in microseconds, or zero if no samples
+     * have been recorded
+     */
+    uint64_t percentile(double fraction) const;
+
+   private:
+    static const std::size_t NUM_BUCKETS = 256;
+
+    std::array<uint64_t, NUM_BUCKETS> buckets;
+    uint64_t count_, sum, min_, max_;
+
+    static std::size_t bucket_index(uint64_t micros);
+    static uint64_t bucket_lower_bound(std::size_t index);
+};
+
+#endif
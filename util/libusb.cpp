@@ -3,6 +3,7 @@
 #include <glibmm/main.h>
 #include <glibmm/ustring.h>
 #include <poll.h>
+#include <sys/epoll.h>
 #include <algorithm>
 #include <cassert>
 #include <cerrno>
@@ -19,6 +20,13 @@
 
 namespace
 {
+/**
+ * \brief The maximum number of times to ask libusb to handle events in one
+ * main loop wakeup, so that a continuous stream of completions cannot starve
+ * the rest of the application.
+ */
+const unsigned int MAX_EVENT_PASSES_PER_WAKEUP = 8;
+
 long check_fn(const char *call, long err, unsigned int endpoint)
 {
     if (err >= 0)
@@ -153,21 +161,46 @@ class TransferMetadata final : public NonCopyable
         transfer_ = nullptr;
     }
 
+    std::chrono::steady_clock::time_point submit_time() const
+    {
+        return submit_time_;
+    }
+
+    void mark_submitted()
+    {
+        submit_time_ = std::chrono::steady_clock::now();
+    }
+
    private:
     USB::Transfer *transfer_;
     USB::DeviceHandle &device_;
+    std::chrono::steady_clock::time_point submit_time_;
 };
 }
 
 void USB::usb_context_pollfd_add_trampoline(
     int fd, short events, void *user_data)
 {
-    static_cast<Context *>(user_data)->add_pollfd(fd, events);
+    try
+    {
+        static_cast<Context *>(user_data)->add_pollfd(fd, events);
+    }
+    catch (...)
+    {
+        MainLoop::quit_with_current_exception();
+    }
 }
 
 void USB::usb_context_pollfd_remove_trampoline(int fd, void *user_data)
 {
-    static_cast<Context *>(user_data)->remove_pollfd(fd);
+    try
+    {
+        static_cast<Context *>(user_data)->remove_pollfd(fd);
+    }
+    catch (...)
+    {
+        MainLoop::quit_with_current_exception();
+    }
 }
 
 void USB::usb_transfer_handle_completed_transfer_trampoline(
@@ -176,7 +209,15 @@ void USB::usb_transfer_handle_completed_transfer_trampoline(
     try
     {
         TransferMetadata *md = TransferMetadata::get(transfer);
+        // Synchronous libusb calls also reap completions; only count those
+        // handled by the main loop.
+        Context &context = md->device().context();
+        if (context.handling_events)
+        {
+            ++context.completions_this_wakeup;
+        }
         --md->device().submitted_transfer_count;
+        md->device().note_completed(*transfer, md->submit_time());
         if (md->transfer())
         {
             md->transfer()->handle_completed_transfer();
@@ -227,8 +268,37 @@ USB::TransferCancelledError::TransferCancelledError(unsigned int endpoint)
 {
 }
 
+USB::EndpointStatistics::EndpointStatistics() : in_flight(0)
+{
+    reset();
+}
+
+void USB::EndpointStatistics::reset()
+{
+    submits        = 0;
+    completions    = 0;
+    bytes          = 0;
+    errors         = 0;
+    timeouts       = 0;
+    cancellations  = 0;
+    stalls         = 0;
+    disconnections = 0;
+    overflows      = 0;
+    stall_retries  = 0;
+    peak_in_flight = in_flight;
+    latency.reset();
+}
+
 USB::Context::Context()
+    : event_stats(), handling_events(false), completions_this_wakeup(0)
 {
+    int efd = epoll_create1(EPOLL_CLOEXEC);
+    if (efd < 0)
+    {
+        throw SystemError("epoll_create1", errno);
+    }
+    epoll_fd = FileDescriptor::create_from_fd(efd);
+
     check_fn("libusb_init", libusb_init(&context), 0);
     const libusb_pollfd **pfds = libusb_get_pollfds(context);
     if (!pfds)
@@ -243,60 +313,92 @@ USB::Context::Context()
     libusb_set_pollfd_notifiers(
         context, &usb_context_pollfd_add_trampoline,
         &usb_context_pollfd_remove_trampoline, this);
+    epoll_connection = Glib::signal_io().connect(
+        sigc::bind_return(
+            sigc::hide(sigc::mem_fun(this, &Context::handle_usb_fds)), true),
+        epoll_fd.fd(), Glib::IO_IN);
 }
 
 USB::Context::~Context()
 {
+    epoll_connection.disconnect();
     libusb_exit(context);
     context = nullptr;
-    for (auto &i : fd_connections)
-    {
-        i.second.disconnect();
-    }
 }
 
 void USB::Context::add_pollfd(int fd, short events)
 {
-    auto old = fd_connections.find(fd);
-    if (old != fd_connections.end())
-    {
-        old->second.disconnect();
-    }
-    Glib::IOCondition cond = static_cast<Glib::IOCondition>(0);
+    epoll_event event;
+    event.events  = 0;
+    event.data.fd = fd;
     if (events & POLLIN)
     {
-        cond |= Glib::IO_IN;
+        event.events |= EPOLLIN;
     }
     if (events & POLLOUT)
     {
-        cond |= Glib::IO_OUT;
+        event.events |= EPOLLOUT;
+    }
+    if (epoll_ctl(epoll_fd.fd(), EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        if (errno != EEXIST ||
+            epoll_ctl(epoll_fd.fd(), EPOLL_CTL_MOD, fd, &event) < 0)
+        {
+            throw SystemError("epoll_ctl", errno);
+        }
     }
-    fd_connections[fd] = Glib::signal_io().connect(
-        sigc::bind_return(
-            sigc::hide(sigc::mem_fun(this, &Context::handle_usb_fds)), true),
-        fd, cond);
 }
 
 void USB::Context::remove_pollfd(int fd)
 {
-    auto i = fd_connections.find(fd);
-    if (i != fd_connections.end())
+    // libusb may already have closed the descriptor, which removes it from the
+    // epoll set automatically.
+    if (epoll_ctl(epoll_fd.fd(), EPOLL_CTL_DEL, fd, nullptr) < 0 &&
+        errno != ENOENT && errno != EBADF)
     {
-        i->second.disconnect();
-        fd_connections.erase(i);
+        throw SystemError("epoll_ctl", errno);
     }
 }
 
 void USB::Context::handle_usb_fds()
 {
-    timeval tv = {0, 0};
-    check_fn(
-        "libusb_handle_events_timeout",
-        libusb_handle_events_timeout(context, &tv), 0);
+    completions_this_wakeup = 0;
+    handling_events         = true;
+    try
+    {
+        for (unsigned int pass = 0; pass < MAX_EVENT_PASSES_PER_WAKEUP; ++pass)
+        {
+            timeval tv = {0, 0};
+            check_fn(
+                "libusb_handle_events_timeout",
+                libusb_handle_events_timeout(context, &tv), 0);
+
+            // Handling events often resubmits transfers which may complete
+            // almost immediately; pick those up now instead of on another
+            // wakeup.
+            epoll_event event;
+            if (epoll_wait(epoll_fd.fd(), &event, 1, 0) <= 0)
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        handling_events = false;
+        throw;
+    }
+    handling_events = false;
+    ++event_stats.wakeups;
+    event_stats.completions += completions_this_wakeup;
+    event_stats.last_completions_per_wakeup = completions_this_wakeup;
+    event_stats.max_completions_per_wakeup  = std::max(
+        event_stats.max_completions_per_wakeup, completions_this_wakeup);
+    signal_wakeup_done.emit();
 }
 
 USB::Device::Device(const Device &copyref)
-    : device(libusb_ref_device(copyref.device))
+    : context(copyref.context), device(libusb_ref_device(copyref.device))
 {
     check_fn(
         "libusb_get_device_descriptor",
@@ -315,10 +417,13 @@ USB::Device &USB::Device::operator=(const Device &assgref)
         libusb_unref_device(device);
         device = libusb_ref_device(assgref.device);
     }
+    context           = assgref.context;
+    device_descriptor = assgref.device_descriptor;
     return *this;
 }
 
-USB::Device::Device(libusb_device *device) : device(libusb_ref_device(device))
+USB::Device::Device(Context &context, libusb_device *device)
+    : context(&context), device(libusb_ref_device(device))
 {
     check_fn(
         "libusb_get_device_descriptor",
@@ -340,7 +445,7 @@ std::string USB::Device::serial_number() const
     return value;
 }
 
-USB::DeviceList::DeviceList(Context &context)
+USB::DeviceList::DeviceList(Context &context) : context(context)
 {
     ssize_t ssz;
     check_fn(
@@ -357,11 +462,13 @@ USB::DeviceList::~DeviceList()
 USB::Device USB::DeviceList::operator[](const std::size_t i) const
 {
     assert(i < size());
-    return Device(devices[i]);
+    return Device(context, devices[i]);
 }
 
 USB::DeviceHandle::DeviceHandle(const Device &device)
-    : context(device.context), submitted_transfer_count(0), shutting_down(false)
+    : context_(*device.context),
+      submitted_transfer_count(0),
+      shutting_down(false)
 {
     check_fn("libusb_open", libusb_open(device.device, &handle), 0);
     init_descriptors();
@@ -370,7 +477,7 @@ USB::DeviceHandle::DeviceHandle(const Device &device)
 USB::DeviceHandle::DeviceHandle(
     Context &context, unsigned int vendor_id, unsigned int product_id,
     const char *serial_number)
-    : context(context.context),
+    : context_(context),
       submitted_transfer_count(0),
       shutting_down(false)
 {
@@ -407,7 +514,7 @@ USB::DeviceHandle::~DeviceHandle()
     {
         while (submitted_transfer_count)
         {
-            check_fn("libusb_handle_events", libusb_handle_events(context), 0);
+            check_fn("libusb_handle_events", libusb_handle_events(context_.context), 0);
         }
     }
     catch (const std::exception &exp)
@@ -624,6 +731,66 @@ void USB::DeviceHandle::mark_shutting_down()
     shutting_down = true;
 }
 
+void USB::DeviceHandle::reset_endpoint_statistics()
+{
+    for (EndpointStatistics &i : endpoint_stats)
+    {
+        i.reset();
+    }
+}
+
+void USB::DeviceHandle::note_submitted(const libusb_transfer &transfer)
+{
+    EndpointStatistics &stats = mutable_endpoint_statistics(transfer.endpoint);
+    ++stats.submits;
+    ++stats.in_flight;
+    stats.peak_in_flight = std::max(stats.peak_in_flight, stats.in_flight);
+}
+
+void USB::DeviceHandle::note_completed(
+    const libusb_transfer &transfer,
+    std::chrono::steady_clock::time_point submit_time)
+{
+    EndpointStatistics &stats = mutable_endpoint_statistics(transfer.endpoint);
+    assert(stats.in_flight);
+    --stats.in_flight;
+    ++stats.completions;
+    if (transfer.actual_length > 0)
+    {
+        stats.bytes += static_cast<uint64_t>(transfer.actual_length);
+    }
+    switch (transfer.status)
+    {
+        case LIBUSB_TRANSFER_COMPLETED:
+            break;
+
+        case LIBUSB_TRANSFER_TIMED_OUT:
+            ++stats.timeouts;
+            break;
+
+        case LIBUSB_TRANSFER_CANCELLED:
+            ++stats.cancellations;
+            break;
+
+        case LIBUSB_TRANSFER_STALL:
+            ++stats.stalls;
+            break;
+
+        case LIBUSB_TRANSFER_NO_DEVICE:
+            ++stats.disconnections;
+            break;
+
+        case LIBUSB_TRANSFER_OVERFLOW:
+            ++stats.overflows;
+            break;
+
+        default:
+            ++stats.errors;
+            break;
+    }
+    stats.latency.record(std::chrono::steady_clock::now() - submit_time);
+}
+
 void USB::DeviceHandle::init_descriptors()
 {
     check_fn(
@@ -787,6 +954,7 @@ void USB::Transfer::result() const
 void USB::Transfer::submit()
 {
     assert(!submitted_);
+    TransferMetadata::get(transfer)->mark_submitted();
     check_fn(
         "libusb_submit_transfer", libusb_submit_transfer(transfer),
         transfer->endpoint);
@@ -794,6 +962,7 @@ void USB::Transfer::submit()
     done_              = false;
     stall_retries_left = retry_on_stall_ ? 30 : 0;
     ++device.submitted_transfer_count;
+    device.note_submitted(*transfer);
 }
 
 USB::Transfer::Transfer(DeviceHandle &dev)
@@ -826,10 +995,13 @@ void USB::Transfer::handle_completed_transfer()
     {
         LOG_INFO(u8"Retrying stalled transfer.");
         --stall_retries_left;
+        TransferMetadata::get(transfer)->mark_submitted();
         check_fn(
             "libusb_submit_transfer", libusb_submit_transfer(transfer),
             transfer->endpoint);
         ++device.submitted_transfer_count;
+        ++device.mutable_endpoint_statistics(transfer->endpoint).stall_retries;
+        device.note_submitted(*transfer);
         return;
     }
     done_      = true;
@@ -938,3 +1110,107 @@ USB::BulkOutTransfer::BulkOutTransfer(
     }
     std::memcpy(transfer->buffer, data, len);
 }
+
+USB::BulkInTransferPool::BulkInTransferPool(
+    DeviceHandle &dev, unsigned char endpoint, std::size_t len,
+    unsigned int min_depth, unsigned int initial_depth, unsigned int max_depth)
+    : device(dev),
+      endpoint(endpoint),
+      len(len),
+      sizer(
+          min_depth, initial_depth, max_depth,
+          std::chrono::steady_clock::now()),
+      completions(0),
+      to_retire(0),
+      started(false)
+{
+    transfers.reserve(max_depth);
+    add_transfers(initial_depth);
+    wakeup_connection = dev.context().signal_wakeup_done.connect(
+        sigc::mem_fun(this, &BulkInTransferPool::handle_wakeup_done));
+}
+
+USB::BulkInTransferPool::~BulkInTransferPool()
+{
+    wakeup_connection.disconnect();
+}
+
+void USB::BulkInTransferPool::start()
+{
+    assert(!started);
+    started = true;
+    for (auto &i : transfers)
+    {
+        i->submit();
+    }
+}
+
+void USB::BulkInTransferPool::add_transfers(unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        std::unique_ptr<BulkInTransfer> transfer(
+            new BulkInTransfer(device, endpoint, len, false, 0));
+        transfer->signal_done.connect(sigc::bind(
+            sigc::mem_fun(this, &BulkInTransferPool::handle_done),
+            sigc::ref(*transfer.get())));
+        if (started)
+        {
+            transfer->submit();
+        }
+        transfers.push_back(std::move(transfer));
+    }
+}
+
+void USB::BulkInTransferPool::handle_done(
+    AsyncOperation<void> &, BulkInTransfer &transfer)
+{
+    ++completions;
+
+    signal_transfer_done.emit(transfer);
+
+    if (to_retire)
+    {
+        // The transfer cannot be freed here because its signal is still being
+        // emitted; park it until the end of the wakeup.
+        --to_retire;
+        for (auto i = transfers.begin(); i != transfers.end(); ++i)
+        {
+            if (i->get() == &transfer)
+            {
+                retired.push_back(std::move(*i));
+                transfers.erase(i);
+                return;
+            }
+        }
+        assert(false);
+    }
+
+    transfer.submit();
+}
+
+void USB::BulkInTransferPool::handle_wakeup_done()
+{
+    retired.clear();
+    if (!started)
+    {
+        return;
+    }
+
+    // The host-side view cannot detect starvation: every completion is
+    // resubmitted inside its own callback, so the others always look
+    // outstanding. Instead, judge by how many transfers the kernel handed
+    // back in one wakeup.
+    unsigned int target = sizer.wakeup_done(
+        completions, std::chrono::steady_clock::now());
+    completions = 0;
+    if (target > depth())
+    {
+        to_retire = 0;
+        add_transfers(target - depth());
+    }
+    else
+    {
+        to_retire = depth() - target;
+    }
+}
@@ -4,7 +4,10 @@
 #include <glib.h>
 #include <libusb.h>
 #include <sigc++/connection.h>
+#include <sigc++/signal.h>
+#include <array>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <list>
@@ -14,7 +17,10 @@
 #include <unordered_map>
 #include <vector>
 #include "util/async_operation.h"
+#include "util/fd.h"
+#include "util/latency_histogram.h"
 #include "util/noncopyable.h"
+#include "util/transfer_pool_sizer.h"
 
 namespace USB
 {
@@ -108,12 +114,140 @@ class TransferCancelledError final : public TransferError
     explicit TransferCancelledError(unsigned int endpoint);
 };
 
+/**
+ * \brief Counters describing the traffic on one endpoint of a device.
+ *
+ * A submission is counted every time a transfer is handed to libusb, including
+ * automatic resubmissions after a stall.
+ */
+struct EndpointStatistics final
+{
+    /**
+     * \brief The number of transfers submitted.
+     */
+    uint64_t submits;
+
+    /**
+     * \brief The number of transfers which finished, successfully or not.
+     */
+    uint64_t completions;
+
+    /**
+     * \brief The number of bytes actually transferred.
+     */
+    uint64_t bytes;
+
+    /**
+     * \brief The number of transfers which failed with a generic error.
+     */
+    uint64_t errors;
+
+    /**
+     * \brief The number of transfers which timed out.
+     */
+    uint64_t timeouts;
+
+    /**
+     * \brief The number of transfers which were cancelled.
+     */
+    uint64_t cancellations;
+
+    /**
+     * \brief The number of times the endpoint stalled.
+     */
+    uint64_t stalls;
+
+    /**
+     * \brief The number of transfers which failed because the device was
+     * disconnected.
+     */
+    uint64_t disconnections;
+
+    /**
+     * \brief The number of transfers in which the device sent more data than
+     * requested.
+     */
+    uint64_t overflows;
+
+    /**
+     * \brief The number of times a stalled transfer was resubmitted.
+     */
+    uint64_t stall_retries;
+
+    /**
+     * \brief The number of transfers currently submitted.
+     */
+    unsigned int in_flight;
+
+    /**
+     * \brief The largest number of transfers that have been submitted at once.
+     */
+    unsigned int peak_in_flight;
+
+    /**
+     * \brief The time from submission to completion of each transfer.
+     */
+    LatencyHistogram latency;
+
+    /**
+     * \brief Constructs a set of zero counters.
+     */
+    explicit EndpointStatistics();
+
+    /**
+     * \brief Zeroes the counters.
+     *
+     * The current in-flight count is preserved, as those transfers are still
+     * outstanding; the peak is reset to match it.
+     */
+    void reset();
+};
+
+/**
+ * \brief Counters describing how USB events are dispatched from the main loop.
+ */
+struct EventStatistics final
+{
+    /**
+     * \brief The number of times the main loop woke up to handle USB events.
+     */
+    uint64_t wakeups;
+
+    /**
+     * \brief The number of transfer completions handled across all wakeups.
+     */
+    uint64_t completions;
+
+    /**
+     * \brief The number of transfer completions handled in the most recent
+     * wakeup.
+     */
+    unsigned int last_completions_per_wakeup;
+
+    /**
+     * \brief The largest number of transfer completions handled in a single
+     * wakeup.
+     */
+    unsigned int max_completions_per_wakeup;
+};
+
 /**
  * \brief A libusb context.
+ *
+ * All of libusb’s file descriptors are gathered into a single epoll instance,
+ * which is the only descriptor watched by the main loop. Each wakeup drains
+ * every libusb event that is ready, rather than dispatching once per
+ * descriptor.
  */
 class Context final : public NonCopyable
 {
    public:
+    /**
+     * \brief Emitted at the end of each main loop wakeup, once every libusb
+     * event that was ready has been handled.
+     */
+    sigc::signal<void> signal_wakeup_done;
+
     /**
      * \brief Initializes the library and creates a context.
      */
@@ -127,15 +261,31 @@ class Context final : public NonCopyable
      */
     ~Context();
 
+    /**
+     * \brief Returns counters describing how events have been dispatched.
+     *
+     * \return the counters
+     */
+    const EventStatistics &event_statistics() const
+    {
+        return event_stats;
+    }
+
    private:
     friend class DeviceList;
     friend class DeviceHandle;
     friend void usb_context_pollfd_add_trampoline(
         int fd, short events, void *user_data);
     friend void usb_context_pollfd_remove_trampoline(int fd, void *user_data);
+    friend void usb_transfer_handle_completed_transfer_trampoline(
+        libusb_transfer *transfer);
 
     libusb_context *context;
-    std::unordered_map<int, sigc::connection> fd_connections;
+    FileDescriptor epoll_fd;
+    sigc::connection epoll_connection;
+    EventStatistics event_stats;
+    bool handling_events;
+    unsigned int completions_this_wakeup;
 
     void add_pollfd(int fd, short events);
     void remove_pollfd(int fd);
@@ -202,11 +352,11 @@ class Device final
     friend class DeviceList;
     friend class DeviceHandle;
 
-    libusb_context *context;
+    Context *context;
     libusb_device *device;
     libusb_device_descriptor device_descriptor;
 
-    explicit Device(libusb_device *device);
+    explicit Device(Context &context, libusb_device *device);
 };
 
 /**
@@ -247,6 +397,7 @@ class DeviceList final : public NonCopyable
     Device operator[](const std::size_t i) const;
 
    private:
+    Context &context;
     std::size_t size_;
     libusb_device **devices;
 };
@@ -290,6 +441,16 @@ class DeviceHandle final : public NonCopyable
      */
     ~DeviceHandle();
 
+    /**
+     * \brief Returns the library context in which the handle was opened.
+     *
+     * \return the context
+     */
+    Context &context() const
+    {
+        return context_;
+    }
+
     /**
      * \brief Issues a bus reset to the device.
      *
@@ -511,6 +672,24 @@ class DeviceHandle final : public NonCopyable
      */
     void mark_shutting_down();
 
+    /**
+     * \brief Returns the traffic counters for an endpoint.
+     *
+     * \param[in] endpoint the endpoint number, with bit 7 used to indicate
+     * direction
+     *
+     * \return the counters
+     */
+    const EndpointStatistics &endpoint_statistics(unsigned char endpoint) const
+    {
+        return endpoint_stats[endpoint_stats_index(endpoint)];
+    }
+
+    /**
+     * \brief Zeroes the traffic counters for all endpoints.
+     */
+    void reset_endpoint_statistics();
+
    private:
     friend class Transfer;
     friend class ControlNoDataTransfer;
@@ -522,7 +701,7 @@ class DeviceHandle final : public NonCopyable
     friend void usb_transfer_handle_completed_transfer_trampoline(
         libusb_transfer *transfer);
 
-    libusb_context *context;
+    Context &context_;
     libusb_device_handle *handle;
     libusb_device_descriptor device_descriptor_;
     std::vector<std::unique_ptr<
@@ -530,8 +709,24 @@ class DeviceHandle final : public NonCopyable
         config_descriptors;
     unsigned int submitted_transfer_count;
     bool shutting_down;
+    std::array<EndpointStatistics, 32> endpoint_stats;
+
+    static std::size_t endpoint_stats_index(unsigned char endpoint)
+    {
+        return (endpoint & LIBUSB_ENDPOINT_ADDRESS_MASK) |
+               ((endpoint & LIBUSB_ENDPOINT_DIR_MASK) ? 16U : 0U);
+    }
+
+    EndpointStatistics &mutable_endpoint_statistics(unsigned char endpoint)
+    {
+        return endpoint_stats[endpoint_stats_index(endpoint)];
+    }
 
     void init_descriptors();
+    void note_submitted(const libusb_transfer &transfer);
+    void note_completed(
+        const libusb_transfer &transfer,
+        std::chrono::steady_clock::time_point submit_time);
 };
 
 /**
@@ -875,6 +1070,96 @@ class BulkOutTransfer final : public Transfer
         DeviceHandle &dev, unsigned char endpoint, const void *data,
         std::size_t len, std::size_t max_len, unsigned int timeout);
 };
+
+/**
+ * \brief A self-sizing set of inbound bulk transfers kept outstanding on one
+ * endpoint.
+ *
+ * Each completed transfer is passed to \ref signal_transfer_done and then
+ * resubmitted. At the end of each main loop wakeup, the number of transfers
+ * that completed during it is passed to a TransferPoolSizer, which decides
+ * whether the pool should grow or shrink. The pool shrinks by not resubmitting
+ * completed transfers; outstanding transfers are never cancelled to shrink the
+ * pool, as cancellation is unreliable in libusb.
+ */
+class BulkInTransferPool final : public NonCopyable
+{
+   public:
+    /**
+     * \brief Emitted when a transfer completes, successfully or not.
+     *
+     * The handler should check the transfer’s result. The transfer is
+     * resubmitted after the handler returns unless the handler throws.
+     */
+    sigc::signal<void, BulkInTransfer &> signal_transfer_done;
+
+    /**
+     * \brief Constructs a new pool.
+     *
+     * No transfers are submitted until start() is called.
+     *
+     * \param[in] dev the device from which to receive data
+     *
+     * \param[in] endpoint the endpoint number on which to transfer data
+     *
+     * \param[in] len the maximum number of bytes to receive per transfer
+     *
+     * \param[in] min_depth the smallest number of transfers to keep
+     *
+     * \param[in] initial_depth the number of transfers to start with
+     *
+     * \param[in] max_depth the largest number of transfers to keep
+     */
+    explicit BulkInTransferPool(
+        DeviceHandle &dev, unsigned char endpoint, std::size_t len,
+        unsigned int min_depth, unsigned int initial_depth,
+        unsigned int max_depth);
+
+    /**
+     * \brief Destroys the pool.
+     */
+    ~BulkInTransferPool();
+
+    /**
+     * \brief Submits all the transfers in the pool.
+     */
+    void start();
+
+    /**
+     * \brief Returns the number of transfers in the pool.
+     *
+     * \return the pool size
+     */
+    unsigned int depth() const
+    {
+        return static_cast<unsigned int>(transfers.size());
+    }
+
+    /**
+     * \brief Returns how many main loop wakeups completed every transfer in
+     * the pool.
+     *
+     * \return the starvation count
+     */
+    uint64_t starvations() const
+    {
+        return sizer.starvations();
+    }
+
+   private:
+    DeviceHandle &device;
+    const unsigned char endpoint;
+    const std::size_t len;
+    TransferPoolSizer sizer;
+    std::vector<std::unique_ptr<BulkInTransfer>> transfers, retired;
+    unsigned int completions, to_retire;
+    bool started;
+    sigc::connection wakeup_connection;
+
+    void add_transfers(unsigned int count);
+    void handle_done(AsyncOperation<void> &, BulkInTransfer &transfer);
+    void handle_wakeup_done();
+};
 }
 
 #endif
@@ -0,0 +1,161 @@
+#ifndef UTIL_MPSC_QUEUE_H
+#define UTIL_MPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "util/noncopyable.h"
+
+/**
+ * \brief A bounded, lock-free queue with any number of producer threads and a
+ * single consumer thread.
+ *
+ * This is Dmitry Vyukov’s bounded queue: each slot carries a sequence number
+ * that tells producers and the consumer whose turn it is to use the slot, so
+ * the only contended operation is one compare-and-swap per push. Neither push
+ * nor pop ever blocks or allocates memory.
+ *
+ * \tparam T the element type, which must be default-constructible and
+ * move-assignable
+ *
+ * \tparam N the capacity, which must be a power of two
+ */
+template <typename T, std::size_t N>
+class MPSCQueue final : public NonCopyable
+{
+   public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+    /**
+     * \brief Constructs an empty queue.
+     */
+    explicit MPSCQueue();
+
+    /**
+     * \brief Adds an element to the back of the queue.
+     *
+     * This may be called from any thread.
+     *
+     * \param[in] value the element to add
+     *
+     * \return \c true if the element was added, or \c false if the queue was
+     * full
+     */
+    bool push(T value);
+
+    /**
+     * \brief Removes an element from the front of the queue.
+     *
+     * This must only be called from the consumer thread.
+     *
+     * \param[out] value the removed element
+     *
+     * \return \c true if an element was removed, or \c false if the queue was
+     * empty
+     */
+    bool pop(T &value);
+
+    /**
+     * \brief Returns the number of elements in the queue.
+     *
+     * The value is exact when no pushes or pops are in progress, and
+     * approximate otherwise.
+     *
+     * \return the number of elements
+     */
+    std::size_t size() const;
+
+    /**
+     * \brief Returns the maximum number of elements the queue can hold.
+     *
+     * \return the capacity
+     */
+    static constexpr std::size_t capacity()
+    {
+        return N;
+    }
+
+   private:
+    struct Cell final
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::array<Cell, N> cells;
+    alignas(64) std::atomic<std::size_t> enqueue_pos;
+    alignas(64) std::atomic<std::size_t> dequeue_pos;
+};
+
+template <typename T, std::size_t N>
+inline MPSCQueue<T, N>::MPSCQueue() : enqueue_pos(0), dequeue_pos(0)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, std::size_t N>
+inline bool MPSCQueue<T, N>::push(T value)
+{
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;)
+    {
+        cell            = &cells[pos & (N - 1)];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff =
+            static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            // The slot is free for this position; claim it.
+            if (enqueue_pos.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer has not yet freed the slot from a lap ago.
+            return false;
+        }
+        else
+        {
+            // Another producer claimed this position first.
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t N>
+inline bool MPSCQueue<T, N>::pop(T &value)
+{
+    std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    Cell &cell      = cells[pos & (N - 1)];
+    std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (seq != pos + 1)
+    {
+        // The producer for this position has not finished writing yet.
+        return false;
+    }
+    value = std::move(cell.value);
+    cell.sequence.store(pos + N, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename T, std::size_t N>
+inline std::size_t MPSCQueue<T, N>::size() const
+{
+    std::size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+    std::size_t head = enqueue_pos.load(std::memory_order_relaxed);
+    return head >= tail ? head - tail : 0;
+}
+
+#endif
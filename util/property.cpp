@@ -0,0 +1,129 @@
+#include "util/property.h"
+#include <exception>
+
+unsigned int PropertyTransaction::depth = 0;
+bool PropertyTransaction::flushing      = false;
+std::vector<PropertyTransaction::Pending> PropertyTransaction::properties,
+    PropertyTransaction::groups;
+
+PropertyTransaction::PropertyTransaction() : committed(false)
+{
+    ++depth;
+}
+
+PropertyTransaction::~PropertyTransaction() noexcept(false)
+{
+    if (std::uncaught_exception())
+    {
+        try
+        {
+            commit();
+        }
+        catch (...)
+        {
+            // Swallow; an exception is already propagating.
+        }
+    }
+    else
+    {
+        commit();
+    }
+}
+
+void PropertyTransaction::commit()
+{
+    if (committed)
+    {
+        return;
+    }
+    committed = true;
+    if (!--depth && !flushing)
+    {
+        flush();
+    }
+}
+
+bool PropertyTransaction::active()
+{
+    return depth || flushing;
+}
+
+void PropertyTransaction::defer(
+    std::vector<Pending> &list, sigc::signal<void> &signal, bool &pending)
+{
+    pending = true;
+    list.push_back(Pending{&signal, &pending});
+}
+
+void PropertyTransaction::flush()
+{
+    // Handlers may change further properties while the signals are being
+    // emitted. Those changes are appended to the lists and picked up by the
+    // same loop, so every Property and group still emits at most once per
+    // change after it was last notified.
+    flushing = true;
+    try
+    {
+        std::size_t prop_index = 0, group_index = 0;
+        while (prop_index < properties.size() || group_index < groups.size())
+        {
+            while (prop_index < properties.size())
+            {
+                Pending p = properties[prop_index++];
+                *p.pending = false;
+                p.signal->emit();
+            }
+            while (group_index < groups.size() &&
+                   prop_index == properties.size())
+            {
+                Pending g = groups[group_index++];
+                *g.pending = false;
+                g.signal->emit();
+            }
+        }
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+    properties.clear();
+    groups.clear();
+    flushing = false;
+}
+
+void PropertyTransaction::discard()
+{
+    for (const Pending &i : properties)
+    {
+        *i.pending = false;
+    }
+    for (const Pending &i : groups)
+    {
+        *i.pending = false;
+    }
+    properties.clear();
+    groups.clear();
+    flushing = false;
+}
+
+PropertyGroup::PropertyGroup() : change_pending(false)
+{
+}
+
+void PropertyGroup::member_changed()
+{
+    if (change_pending)
+    {
+        return;
+    }
+    if (PropertyTransaction::active())
+    {
+        PropertyTransaction::defer(
+            PropertyTransaction::groups, signal_changed_, change_pending);
+    }
+    else
+    {
+        signal_changed_.emit();
+    }
+}
@@ -1,10 +1,135 @@
 #ifndef UTIL_PROPERTY_H
 #define UTIL_PROPERTY_H
 
+#include <sigc++/functors/mem_fun.h>
 #include <sigc++/signal.h>
+#include <sigc++/trackable.h>
 #include <utility>
+#include <vector>
 #include "util/noncopyable.h"
 
+template <typename T>
+class Property;
+
+/**
+ * \brief A scope within which Property change notifications are coalesced.
+ *
+ * While a transaction is open, a Property whose value changes emits \ref
+ * Property::signal_changing immediately the first time, but its \ref
+ * Property::signal_changed is deferred until the transaction commits and is
+ * then emitted exactly once, however many times the value changed in between.
+ * A PropertyGroup containing any changed Property likewise emits once, after
+ * all the deferred Property signals.
+ *
+ * Transactions may be nested; only committing the outermost one emits the
+ * deferred signals. Every Property assigned within a transaction must outlive
+ * it. Transactions must only be used from the main loop thread.
+ */
+class PropertyTransaction final : public NonCopyable
+{
+   public:
+    /**
+     * \brief Opens a transaction.
+     */
+    explicit PropertyTransaction();
+
+    /**
+     * \brief Commits the transaction if it has not already been committed.
+     *
+     * If the stack is being unwound by an exception, exceptions thrown by
+     * signal handlers are swallowed.
+     */
+    ~PropertyTransaction() noexcept(false);
+
+    /**
+     * \brief Commits the transaction.
+     *
+     * If this is the outermost transaction, the deferred signals are emitted
+     * before this function returns. Calling this more than once has no
+     * further effect.
+     */
+    void commit();
+
+    /**
+     * \brief Checks whether change notifications are currently being
+     * deferred.
+     *
+     * \return \c true if a transaction is open or committing, or \c false if
+     * not
+     */
+    static bool active();
+
+   private:
+    template <typename T>
+    friend class Property;
+    friend class PropertyGroup;
+
+    struct Pending final
+    {
+        sigc::signal<void> *signal;
+        bool *pending;
+    };
+
+    static unsigned int depth;
+    static bool flushing;
+    static std::vector<Pending> properties, groups;
+
+    bool committed;
+
+    static void defer(
+        std::vector<Pending> &list, sigc::signal<void> &signal, bool &pending);
+    static void flush();
+    static void discard();
+};
+
+/**
+ * \brief A set of properties with a single signal fired when any of them
+ * changes.
+ *
+ * Outside a PropertyTransaction, the signal fires once per changed
+ * Property. Inside one, it fires once when the transaction commits, if any
+ * member changed.
+ */
+class PropertyGroup final : public NonCopyable, public sigc::trackable
+{
+   public:
+    /**
+     * \brief Constructs an empty group.
+     */
+    explicit PropertyGroup();
+
+    /**
+     * \brief Adds a Property to the group.
+     *
+     * \tparam T the type of value held by the Property
+     *
+     * \param[in] prop the Property to add, which must outlive the group or be
+     * removed by destroying the group first
+     */
+    template <typename T>
+    void add(const Property<T> &prop)
+    {
+        prop.signal_changed().connect(
+            sigc::mem_fun(this, &PropertyGroup::member_changed));
+    }
+
+    /**
+     * \brief Returns the signal fired when any member of the group changes.
+     *
+     * \return the signal
+     */
+    sigc::signal<void> &signal_changed() const
+    {
+        return signal_changed_;
+    }
+
+   private:
+    mutable sigc::signal<void> signal_changed_;
+    bool change_pending;
+
+    void member_changed();
+};
+
 /**
  * \brief A variable holding a value of some type, with the ability to notify
  * listeners when the value changes.
@@ -20,7 +145,7 @@ class Property final : public NonCopyable
      *
      * \param[in] value the value with which to initialize the Property.
      */
-    explicit Property(const T &value) : value(value)
+    explicit Property(const T &value) : value(value), change_pending(false)
     {
     }
 
@@ -29,7 +154,8 @@ class Property final : public NonCopyable
      *
      * \param[in] value the value with which to initialize the Property.
      */
-    explicit Property(T &&value) : value(std::move(value))
+    explicit Property(T &&value)
+        : value(std::move(value)), change_pending(false)
     {
     }
 
@@ -44,7 +170,8 @@ class Property final : public NonCopyable
     Property(Property<T> &&moveref)
         : value(std::move(moveref.value)),
           signal_changing_(std::move(moveref.signal_changing_)),
-          signal_changed_(std::move(moveref.signal_changed_))
+          signal_changed_(std::move(moveref.signal_changed_)),
+          change_pending(false)
     {
     }
 
@@ -62,6 +189,9 @@ class Property final : public NonCopyable
     /**
      * \brief Returns the signal fired when the value of the Property changes.
      *
+     * Within a PropertyTransaction, this signal is deferred until the
+     * transaction commits.
+     *
      * \return the signal.
      */
     sigc::signal<void> &signal_changed() const
@@ -94,9 +224,24 @@ class Property final : public NonCopyable
     {
         if (value != val)
         {
-            signal_changing().emit();
-            value = val;
-            signal_changed().emit();
+            if (change_pending)
+            {
+                value = val;
+            }
+            else if (PropertyTransaction::active())
+            {
+                signal_changing().emit();
+                value = val;
+                PropertyTransaction::defer(
+                    PropertyTransaction::properties, signal_changed_,
+                    change_pending);
+            }
+            else
+            {
+                signal_changing().emit();
+                value = val;
+                signal_changed().emit();
+            }
         }
         return *this;
     }
@@ -110,9 +255,24 @@ class Property final : public NonCopyable
     {
         if (value != val)
         {
-            signal_changing().emit();
-            value = std::move(val);
-            signal_changed().emit();
+            if (change_pending)
+            {
+                value = std::move(val);
+            }
+            else if (PropertyTransaction::active())
+            {
+                signal_changing().emit();
+                value = std::move(val);
+                PropertyTransaction::defer(
+                    PropertyTransaction::properties, signal_changed_,
+                    change_pending);
+            }
+            else
+            {
+                signal_changing().emit();
+                value = std::move(val);
+                signal_changed().emit();
+            }
         }
         return *this;
     }
@@ -151,6 +311,7 @@ class Property final : public NonCopyable
     T value;
     mutable sigc::signal<void> signal_changing_;
     mutable sigc::signal<void> signal_changed_;
+    bool change_pending;
 };
 
 #endif
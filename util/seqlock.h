@@ -0,0 +1,105 @@
+#ifndef UTIL_SEQLOCK_H
+#define UTIL_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * \brief A single value shared between one writer and any number of readers
+ * without locks, suitable for placing in memory shared between processes.
+ *
+ * The writer bumps a sequence number to odd before writing and back to even
+ * after. A reader copies the value out and retries if the sequence number was
+ * odd or changed during the copy, so it never sees a torn value and never
+ * blocks the writer. Readers can also compare \ref generation against an
+ * earlier value to see whether anything new was written.
+ *
+ * \tparam T the value type, which must be trivially copyable
+ */
+template <typename T>
+class alignas(64) Seqlock final
+{
+   public:
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "Seqlock values must be trivially copyable");
+    static_assert(
+        ATOMIC_INT_LOCK_FREE == 2,
+        "Seqlock needs lock-free atomics to work across processes");
+
+    /**
+     * \brief Constructs a Seqlock holding a zero-initialized value.
+     */
+    explicit Seqlock() : sequence(0), value()
+    {
+    }
+
+    /**
+     * \brief Writes a new value.
+     *
+     * Only one thread or process may write to a given Seqlock.
+     *
+     * \param[in] v the value to write
+     */
+    void store(const T &v)
+    {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value, &v, sizeof(T));
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * \brief Makes one attempt to read the value.
+     *
+     * \param[out] v the value read, which is meaningless if the attempt
+     * fails
+     *
+     * \return \c true if the read was consistent, or \c false if it raced
+     * with a write
+     */
+    bool try_load(T &v) const
+    {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            return false;
+        }
+        std::memcpy(&v, &value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * \brief Reads the value, retrying until the read is consistent.
+     *
+     * \return the value
+     */
+    T load() const
+    {
+        T v;
+        while (!try_load(v))
+        {
+        }
+        return v;
+    }
+
+    /**
+     * \brief Returns the number of completed writes.
+     *
+     * \return the write count, modulo 2<sup>31</sup>
+     */
+    uint32_t generation() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+   private:
+    std::atomic<uint32_t> sequence;
+    T value;
+};
+
+#endif
@@ -2,7 +2,14 @@
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 
 #include "util/sockaddrs.h"
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
 #include "util/exception.h"
 
 AddrInfoSet::AddrInfoSet(
@@ -30,3 +37,81 @@ in_addr_t get_inaddr_any()
 {
     return htonl(INADDR_ANY);
 }
+
+FileDescriptor create_local_datagram_socket(
+    const std::string &address, std::string &unlink_path)
+{
+    unlink_path.clear();
+    if (address.empty())
+    {
+        throw std::invalid_argument("Socket address must not be empty");
+    }
+    if (std::all_of(address.begin(), address.end(), [](char ch) {
+            return ch >= '0' && ch <= '9';
+        }))
+    {
+        // A bare port number means UDP on the loopback interface.
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family   = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags    = AI_NUMERICSERV;
+        AddrInfoSet ai(nullptr, address.c_str(), &hints);
+        FileDescriptor sock = FileDescriptor::create_socket(
+            ai.first()->ai_family,
+            ai.first()->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+            ai.first()->ai_protocol);
+        if (bind(sock.fd(), ai.first()->ai_addr, ai.first()->ai_addrlen) < 0)
+        {
+            throw SystemError("bind", errno);
+        }
+        return sock;
+    }
+
+    sockaddr_un sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    if (address.size() >= sizeof(sa.sun_path))
+    {
+        throw std::invalid_argument("Socket path too long");
+    }
+    std::memcpy(sa.sun_path, address.data(), address.size());
+    socklen_t len = static_cast<socklen_t>(
+        offsetof(sockaddr_un, sun_path) + address.size());
+    if (address[0] == '@')
+    {
+        // Abstract namespace: the name starts with a NUL byte.
+        sa.sun_path[0] = '\0';
+    }
+    else
+    {
+        // Remove a socket left behind by an earlier run, but never anything
+        // else that a mistyped path might name.
+        struct stat st;
+        if (lstat(address.c_str(), &st) == 0)
+        {
+            if (!S_ISSOCK(st.st_mode))
+            {
+                throw std::invalid_argument(
+                    "Socket path exists and is not a socket");
+            }
+            unlink(address.c_str());
+        }
+        else if (errno != ENOENT)
+        {
+            throw SystemError("lstat", errno);
+        }
+        ++len;
+    }
+    FileDescriptor sock = FileDescriptor::create_socket(
+        AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (bind(sock.fd(), reinterpret_cast<const sockaddr *>(&sa), len) < 0)
+    {
+        throw SystemError("bind", errno);
+    }
+    if (address[0] != '@')
+    {
+        unlink_path = address;
+    }
+    return sock;
+}
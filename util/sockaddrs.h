@@ -6,6 +6,8 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <string>
+#include "util/fd.h"
 #include "util/noncopyable.h"
 
 /**
@@ -51,4 +53,20 @@ class AddrInfoSet final : public NonCopyable
  */
 in_addr_t get_inaddr_any();
 
+/**
+ * \brief Creates a non-blocking datagram socket bound to a local address.
+ *
+ * \param[in] address a filesystem path for a Unix-domain socket, a name
+ * prefixed with “@” for an abstract Unix-domain socket, or a port number for a
+ * UDP socket on the loopback interface; a stale socket file at the path is
+ * removed first, and any other kind of file there is an error
+ *
+ * \param[out] unlink_path the path the caller should remove when it is done
+ * with the socket, or empty if there is none
+ *
+ * \return the bound socket
+ */
+FileDescriptor create_local_datagram_socket(
+    const std::string &address, std::string &unlink_path);
+
 #endif
@@ -0,0 +1,44 @@
+#include "util/transfer_pool_sizer.h"
+#include <algorithm>
+#include <cassert>
+
+const std::chrono::steady_clock::duration
+    USB::TransferPoolSizer::SHRINK_HOLDOFF = std::chrono::seconds(2);
+const std::chrono::steady_clock::duration
+    USB::TransferPoolSizer::SHRINK_INTERVAL = std::chrono::milliseconds(100);
+
+USB::TransferPoolSizer::TransferPoolSizer(
+    unsigned int min_depth, unsigned int initial_depth, unsigned int max_depth,
+    TimePoint now)
+    : min_depth(min_depth),
+      max_depth(max_depth),
+      depth_(initial_depth),
+      starvations_(0),
+      last_grow(now),
+      last_shrink(now)
+{
+    assert(min_depth >= 1);
+    assert(min_depth <= initial_depth && initial_depth <= max_depth);
+}
+
+unsigned int USB::TransferPoolSizer::wakeup_done(
+    unsigned int completions, TimePoint now)
+{
+    if (completions >= depth_)
+    {
+        ++starvations_;
+        last_grow = now;
+        depth_    = std::min(depth_ * 2, max_depth);
+    }
+    else if (
+        depth_ > min_depth && completions <= depth_ / 4 &&
+        now - last_grow >= SHRINK_HOLDOFF &&
+        now - last_shrink >= SHRINK_INTERVAL)
+    {
+        // Shrinking only while wakeups use at most a quarter of the pool
+        // leaves room for traffic to double before the pool grows back.
+        last_shrink = now;
+        --depth_;
+    }
+    return depth_;
+}
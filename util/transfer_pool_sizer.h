@@ -0,0 +1,94 @@
+#ifndef UTIL_TRANSFER_POOL_SIZER_H
+#define UTIL_TRANSFER_POOL_SIZER_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace USB
+{
+/**
+ * \brief Decides how many transfers a pool of inbound transfers should keep.
+ *
+ * The pool reports how many of its transfers completed in each main loop
+ * wakeup. If as many transfers completed in one wakeup as the pool holds, the
+ * device filled every buffer the host had given it before the host got back
+ * to the kernel, so a slightly larger burst would have left it with nowhere
+ * to put data; the pool doubles. Once the pool has gone a while without
+ * starving and wakeups are only using a small fraction of it, it shrinks one
+ * transfer at a time.
+ */
+class TransferPoolSizer final
+{
+   public:
+    /**
+     * \brief The type of time points passed to the sizer.
+     */
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    /**
+     * \brief How long the pool must go without starving before it starts
+     * shrinking.
+     */
+    static const std::chrono::steady_clock::duration SHRINK_HOLDOFF;
+
+    /**
+     * \brief The minimum time between successive single-transfer shrinks.
+     */
+    static const std::chrono::steady_clock::duration SHRINK_INTERVAL;
+
+    /**
+     * \brief Constructs a new sizer.
+     *
+     * \param[in] min_depth the smallest number of transfers to keep
+     *
+     * \param[in] initial_depth the number of transfers to start with
+     *
+     * \param[in] max_depth the largest number of transfers to keep
+     *
+     * \param[in] now the current time
+     */
+    explicit TransferPoolSizer(
+        unsigned int min_depth, unsigned int initial_depth,
+        unsigned int max_depth, TimePoint now);
+
+    /**
+     * \brief Returns the number of transfers the pool should hold.
+     *
+     * \return the target pool size
+     */
+    unsigned int depth() const
+    {
+        return depth_;
+    }
+
+    /**
+     * \brief Returns how many wakeups completed every transfer in the pool.
+     *
+     * \return the starvation count
+     */
+    uint64_t starvations() const
+    {
+        return starvations_;
+    }
+
+    /**
+     * \brief Records the end of a main loop wakeup.
+     *
+     * \param[in] completions the number of the pool’s transfers that completed
+     * during the wakeup
+     *
+     * \param[in] now the current time
+     *
+     * \return the number of transfers the pool should now hold
+     */
+    unsigned int wakeup_done(unsigned int completions, TimePoint now);
+
+   private:
+    const unsigned int min_depth, max_depth;
+    unsigned int depth_;
+    uint64_t starvations_;
+    TimePoint last_grow, last_shrink;
+};
+}
+
+#endif